@@ -19,6 +19,16 @@ extern "C" {
 #include "encoding.h"
 #include "encrypt.h"
 #include "rs1024.h"
+#include "sha256.h"
+#include "cpu.h"
+#include "parallel.h"
+#include "search.h"
+#include "job.h"
+#include "calibrate.h"
+#include "parser.h"
+#include "container.h"
+#include "pool.h"
+#include "combiner.h"
 
 #ifdef __cplusplus
 }
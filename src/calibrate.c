@@ -0,0 +1,117 @@
+//
+//  calibrate.c
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#include "calibrate.h"
+#include "encrypt.h"
+#include "mnemonics.h"
+#include "sha256.h"
+#include "slip39-errors.h"
+
+#include <string.h>
+
+#ifndef ARDUINO
+#include <time.h>
+#endif
+
+// keep timing until the sample has run at least this long
+#define CALIBRATION_SAMPLE_NS 20000000.0
+#define CALIBRATION_FIRST_COUNT 256
+
+static double now_ns(void) {
+#ifdef ARDUINO
+    extern unsigned long micros(void);
+    return micros() * 1000.0;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+#endif
+}
+
+double slip39_measure_iteration_ns(void) {
+    uint32_t inner[SHA256_STATE_WORDS];
+    uint32_t outer[SHA256_STATE_WORDS];
+    uint32_t u[SHA256_STATE_WORDS];
+    uint32_t t[SHA256_STATE_WORDS];
+    const uint8_t key[] = { 0 };
+
+    slip39_hmac_sha256_prepare(key, sizeof(key), inner, outer);
+    memset(u, 0x5c, sizeof(u));
+    memset(t, 0, sizeof(t));
+
+    // double the sample until it is long enough to time reliably
+    uint32_t count = CALIBRATION_FIRST_COUNT;
+    for(;;) {
+        double start = now_ns();
+        slip39_hmac_sha256_iterate(inner, outer, u, t, count);
+        double elapsed = now_ns() - start;
+
+        if(elapsed >= CALIBRATION_SAMPLE_NS || count >= (1u << 30)) {
+            return elapsed / count;
+        }
+        count *= 2;
+    }
+}
+
+static int check_secret_length(uint32_t secret_length) {
+    if(secret_length < MIN_STRENGTH_BYTES) {
+        return ERROR_SECRET_TOO_SHORT;
+    }
+    // a share holds at most 32 bytes of the secret
+    if(secret_length % 2 == 1 || secret_length > 32) {
+        return ERROR_INVALID_SECRET_LENGTH;
+    }
+    return 0;
+}
+
+// iterations of the PBKDF2 loop one encrypt or decrypt runs
+static double iterations_for(uint8_t iteration_exponent, uint32_t secret_length) {
+    // each round derives half the secret, 32 bytes per PBKDF2 block
+    uint32_t blocks = (secret_length / 2 + SHA256_DIGEST_LENGTH - 1) / SHA256_DIGEST_LENGTH;
+    return (double) ROUND_COUNT * blocks * ((double) BASE_ITERATION_COUNT * ((uint64_t) 1 << iteration_exponent));
+}
+
+double slip39_predict_latency_ms(
+    uint8_t iteration_exponent,
+    uint32_t secret_length,
+    double iteration_ns
+) {
+    int error = check_secret_length(secret_length);
+    if(error) {
+        return error;
+    }
+    if(iteration_exponent > MAX_ITERATION_EXPONENT) {
+        return ERROR_INVALID_ITERATION_EXPONENT;
+    }
+    if(iteration_ns <= 0) {
+        iteration_ns = slip39_measure_iteration_ns();
+    }
+    return iterations_for(iteration_exponent, secret_length) * iteration_ns / 1e6;
+}
+
+int slip39_calibrate_exponent(
+    uint32_t target_ms,
+    uint32_t secret_length,
+    double iteration_ns
+) {
+    int error = check_secret_length(secret_length);
+    if(error) {
+        return error;
+    }
+    if(iteration_ns <= 0) {
+        iteration_ns = slip39_measure_iteration_ns();
+    }
+
+    // the cost doubles with each step of the exponent
+    int exponent = -1;
+    while(exponent < MAX_ITERATION_EXPONENT &&
+        iterations_for(exponent + 1, secret_length) * iteration_ns / 1e6 <= target_ms) {
+        ++exponent;
+    }
+
+    return exponent < 0 ? ERROR_TARGET_TOO_LOW : exponent;
+}
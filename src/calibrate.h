@@ -0,0 +1,63 @@
+//
+//  calibrate.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#ifndef CALIBRATE_H
+#define CALIBRATE_H
+
+#include <stdint.h>
+#include "encrypt.h"
+
+/**
+ * time a short run of the PBKDF2 loop used by the Fiestel network on this
+ * machine, with the SHA-256 backend currently selected. Takes a few tens
+ * of milliseconds.
+ *
+ * returns: the time taken by one PBKDF2 iteration, in nanoseconds
+ */
+double slip39_measure_iteration_ns(void);
+
+/**
+ * predict how long slip39_encrypt or slip39_decrypt will take on this
+ * machine, and so roughly how long slip39_generate and slip39_combine
+ * will take
+ *
+ * inputs: iteration_exponent: the exponent, from 0 to MAX_ITERATION_EXPONENT
+ *         secret_length: length of the master secret in bytes
+ *         iteration_ns: the time one iteration takes, as measured by
+ *                       slip39_measure_iteration_ns, or 0 to measure it now
+ *
+ * returns: the predicted time in milliseconds, or a negative error code
+ *          (ERROR_INVALID_SECRET_LENGTH for an odd length or one over 32,
+ *          ERROR_SECRET_TOO_SHORT or ERROR_INVALID_ITERATION_EXPONENT)
+ */
+double slip39_predict_latency_ms(
+    uint8_t iteration_exponent,
+    uint32_t secret_length,
+    double iteration_ns
+);
+
+/**
+ * choose an iteration exponent for slip39_generate from the time the key
+ * derivation takes on this machine
+ *
+ * inputs: target_ms: the longest encrypt or decrypt should take
+ *         secret_length: length of the master secret in bytes
+ *         iteration_ns: the time one iteration takes, as measured by
+ *                       slip39_measure_iteration_ns, or 0 to measure it now
+ *
+ * returns: the largest exponent whose predicted latency is within
+ *          target_ms, or a negative error code: ERROR_TARGET_TOO_LOW if
+ *          even an exponent of 0 would take longer, or an error of
+ *          slip39_predict_latency_ms
+ */
+int slip39_calibrate_exponent(
+    uint32_t target_ms,
+    uint32_t secret_length,
+    double iteration_ns
+);
+
+#endif /* CALIBRATE_H */
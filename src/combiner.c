@@ -0,0 +1,308 @@
+//
+//  combiner.c
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#include "combiner.h"
+#include "mnemonics.h"
+#include "encrypt.h"
+#include "slip39-errors.h"
+
+#ifdef ARDUINO
+#include "bc-shamir.h"
+#else
+#include <bc-shamir/bc-shamir.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct combiner_group_struct {
+    uint8_t member_threshold;
+    uint8_t count;
+    uint8_t complete;
+    int error;                      // ERROR_INCONSISTENT_GROUP when the
+                                    //   members do not recover a secret
+    uint16_t members;               // a bit for each member index added
+    uint8_t member_index[16];       // in the order they were added
+    uint8_t value[16][32];
+    uint8_t secret[32];             // the group secret, once complete
+} combiner_group;
+
+struct slip39_combiner_struct {
+    uint8_t started;
+    uint16_t identifier;
+    uint8_t iteration_exponent;
+    uint8_t group_threshold;
+    uint8_t group_count;
+    uint8_t value_length;
+    uint8_t groups_complete;
+    uint8_t ems_ready;
+    int error;                      // ERROR_INCONSISTENT_GROUP when the
+                                    //   group secrets do not recover the ems
+    uint8_t complete_index[16];     // the group indices, in the order the
+                                    //   groups were completed
+    combiner_group groups[16];
+    uint8_t ems[32];
+};
+
+int slip39_combiner_new(
+    slip39_combiner **combiner
+) {
+    *combiner = calloc(1, sizeof(slip39_combiner));
+    return *combiner == NULL ? ERROR_INSUFFICIENT_SPACE : 0;
+}
+
+void slip39_combiner_free(
+    slip39_combiner *combiner
+) {
+    if(combiner == NULL) {
+        return;
+    }
+    memset(combiner, 0, sizeof(slip39_combiner));
+    free(combiner);
+}
+
+// check a decoded share against what the combiner has seen, without
+// changing anything. Returns 1 for a share already added.
+static int check_shard(
+    const slip39_combiner *combiner,
+    const slip39_shard *shard
+) {
+    if(shard->group_index >= shard->group_count) {
+        return ERROR_INVALID_SHARD_SET;
+    }
+    if(!combiner->started) {
+        return 0;
+    }
+    if(shard->identifier != combiner->identifier ||
+       shard->iteration_exponent != combiner->iteration_exponent ||
+       shard->group_threshold != combiner->group_threshold ||
+       shard->group_count != combiner->group_count ||
+       shard->value_length != combiner->value_length) {
+        return ERROR_INVALID_SHARD_SET;
+    }
+
+    const combiner_group *group = &combiner->groups[shard->group_index];
+    if(group->count == 0) {
+        return 0;
+    }
+    if(shard->member_threshold != group->member_threshold) {
+        return ERROR_INVALID_MEMBER_THRESHOLD;
+    }
+    if(group->members & ((uint16_t) 1 << shard->member_index)) {
+        for(uint8_t i=0; i<group->count; ++i) {
+            if(group->member_index[i] == shard->member_index) {
+                return memcmp(group->value[i], shard->value, shard->value_length) == 0 ?
+                    1 : ERROR_DUPLICATE_MEMBER_INDEX;
+            }
+        }
+    }
+    return 0;
+}
+
+// recover the secret of a group that has just reached its threshold, and
+// the encrypted master secret if that was the last group needed. A group
+// whose members do not agree is marked, not undone, since there is no
+// telling which of them is wrong.
+static int complete_group(
+    slip39_combiner *combiner,
+    uint8_t group_index
+) {
+    combiner_group *group = &combiner->groups[group_index];
+    const uint8_t *values[16];
+    for(uint8_t i=0; i<group->member_threshold; ++i) {
+        values[i] = group->value[i];
+    }
+    int recovery = recover_secret(group->member_threshold, group->member_index,
+        values, combiner->value_length, group->secret);
+    memset(values, 0, sizeof(values));
+    if(recovery < 0) {
+        memset(group->secret, 0, sizeof(group->secret));
+        group->error = ERROR_INCONSISTENT_GROUP;
+        return group->error;
+    }
+    group->complete = 1;
+    combiner->complete_index[combiner->groups_complete++] = group_index;
+
+    if(combiner->groups_complete != combiner->group_threshold) {
+        return 0;
+    }
+
+    const uint8_t *secrets[16];
+    for(uint8_t i=0; i<combiner->groups_complete; ++i) {
+        secrets[i] = combiner->groups[combiner->complete_index[i]].secret;
+    }
+    recovery = recover_secret(combiner->group_threshold, combiner->complete_index,
+        secrets, combiner->value_length, combiner->ems);
+    memset(secrets, 0, sizeof(secrets));
+    if(recovery < 0) {
+        memset(combiner->ems, 0, sizeof(combiner->ems));
+        combiner->error = ERROR_INCONSISTENT_GROUP;
+        return combiner->error;
+    }
+    combiner->ems_ready = 1;
+    return 0;
+}
+
+// complete any group that has enough members, as far as the group
+// threshold, returning the first error
+static int complete_groups(
+    slip39_combiner *combiner
+) {
+    int result = 0;
+    for(uint8_t g=0; g<16; ++g) {
+        const combiner_group *group = &combiner->groups[g];
+        if(group->count > 0 && !group->complete && !group->error &&
+           group->count >= group->member_threshold &&
+           combiner->groups_complete < combiner->group_threshold) {
+            int error = complete_group(combiner, g);
+            if(result == 0) {
+                result = error;
+            }
+        }
+    }
+    return result;
+}
+
+int slip39_combiner_add(
+    slip39_combiner *combiner,
+    const uint16_t *mnemonic,
+    uint32_t mnemonic_length,
+    const char *password
+) {
+    slip39_shard shard;
+    shard.value_length = 32;
+    int result = decode_mnemonic(mnemonic, mnemonic_length, &shard);
+    if(result >= 0 && password) {
+        decrypt_shard(&shard, password);
+    }
+    if(result >= 0) {
+        result = check_shard(combiner, &shard);
+    }
+
+    if(result == 0) {
+        if(!combiner->started) {
+            combiner->started = 1;
+            combiner->identifier = shard.identifier;
+            combiner->iteration_exponent = shard.iteration_exponent;
+            combiner->group_threshold = shard.group_threshold;
+            combiner->group_count = shard.group_count;
+            combiner->value_length = shard.value_length;
+        }
+
+        // once a group is complete further members add nothing, but they
+        // are kept so that a conflicting share is still noticed
+        combiner_group *group = &combiner->groups[shard.group_index];
+        group->member_threshold = shard.member_threshold;
+        group->members |= (uint16_t) 1 << shard.member_index;
+        group->member_index[group->count] = shard.member_index;
+        memcpy(group->value[group->count], shard.value, shard.value_length);
+        group->count++;
+
+        if(!group->complete && !group->error && group->count == group->member_threshold &&
+           combiner->groups_complete < combiner->group_threshold) {
+            result = complete_group(combiner, shard.group_index);
+        }
+    }
+
+    memset(&shard, 0, sizeof(shard));
+    if(result < 0) {
+        return result;
+    }
+    return combiner->ems_ready;
+}
+
+int slip39_combiner_remove(
+    slip39_combiner *combiner,
+    uint8_t group_index,
+    uint8_t member_index
+) {
+    if(group_index >= 16 || member_index >= 16) {
+        return ERROR_INVALID_SHARD_SET;
+    }
+    combiner_group *group = &combiner->groups[group_index];
+    if(!(group->members & ((uint16_t) 1 << member_index))) {
+        return ERROR_INVALID_SHARD_SET;
+    }
+
+    uint8_t i = 0;
+    while(group->member_index[i] != member_index) {
+        ++i;
+    }
+    group->count--;
+    memmove(&group->member_index[i], &group->member_index[i + 1], group->count - i);
+    memmove(group->value[i], group->value[i + 1], sizeof(group->value[0]) * (group->count - i));
+    memset(group->value[group->count], 0, sizeof(group->value[0]));
+    group->members &= ~((uint16_t) 1 << member_index);
+    group->error = 0;
+
+    // a complete group that loses a member is worked out again, along
+    // with the master secret it went into
+    if(group->complete) {
+        group->complete = 0;
+        memset(group->secret, 0, sizeof(group->secret));
+        uint8_t j = 0;
+        while(combiner->complete_index[j] != group_index) {
+            ++j;
+        }
+        combiner->groups_complete--;
+        memmove(&combiner->complete_index[j], &combiner->complete_index[j + 1],
+            combiner->groups_complete - j);
+        combiner->ems_ready = 0;
+        combiner->error = 0;
+        memset(combiner->ems, 0, sizeof(combiner->ems));
+    }
+
+    int result = complete_groups(combiner);
+    if(result < 0) {
+        return result;
+    }
+    return combiner->ems_ready;
+}
+
+void slip39_combiner_report(
+    const slip39_combiner *combiner,
+    slip39_combiner_status *status
+) {
+    memset(status, 0, sizeof(slip39_combiner_status));
+    if(!combiner->started) {
+        return;
+    }
+    status->identifier = combiner->identifier;
+    status->iteration_exponent = combiner->iteration_exponent;
+    status->group_threshold = combiner->group_threshold;
+    status->group_count = combiner->group_count;
+    status->groups_complete = combiner->groups_complete;
+    status->groups_needed = combiner->group_threshold - combiner->groups_complete;
+    status->error = combiner->error;
+    for(uint8_t g=0; g<16; ++g) {
+        const combiner_group *group = &combiner->groups[g];
+        slip39_combiner_group *s = &status->groups[g];
+        s->member_threshold = group->count > 0 ? group->member_threshold : 0;
+        s->member_count = group->count;
+        s->members_needed = group->count < s->member_threshold ? s->member_threshold - group->count : 0;
+        s->complete = group->complete;
+        s->error = group->error;
+        s->members = group->members;
+    }
+}
+
+int slip39_combiner_secret(
+    const slip39_combiner *combiner,
+    const char *passphrase,
+    uint8_t *buffer,
+    uint32_t buffer_length
+) {
+    if(!combiner->ems_ready) {
+        return ERROR_NOT_ENOUGH_GROUPS;
+    }
+    if(buffer_length < combiner->value_length) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+    slip39_decrypt(combiner->ems, combiner->value_length, passphrase,
+        combiner->iteration_exponent, combiner->identifier, buffer);
+    return combiner->value_length;
+}
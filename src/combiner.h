@@ -0,0 +1,155 @@
+//
+//  combiner.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#ifndef COMBINER_H
+#define COMBINER_H
+
+#include <stdint.h>
+
+/**
+ * collects the shares of one split as they arrive, one at a time. Each
+ * share is decoded once and checked against the first. A group's secret
+ * is recovered as soon as it has enough members, and the encrypted master
+ * secret as soon as enough groups have theirs, so nothing is ever worked
+ * out twice. Everything is wiped when the combiner is freed.
+ */
+typedef struct slip39_combiner_struct slip39_combiner;
+
+/**
+ * how far a combiner has got with one group
+ */
+typedef struct slip39_combiner_group_struct {
+    uint8_t member_threshold;   // 0 until a share of the group arrives
+    uint8_t member_count;       // distinct members added
+    uint8_t members_needed;     // more members needed, 0 once complete
+    uint8_t complete;           // 1 once the group secret is recovered
+    int error;                  // ERROR_INCONSISTENT_GROUP if the members
+                                //   added do not recover a secret, else 0
+    uint16_t members;           // a bit for each member index added
+} slip39_combiner_group;
+
+/**
+ * how far a combiner has got
+ */
+typedef struct slip39_combiner_status_struct {
+    uint16_t identifier;
+    uint8_t iteration_exponent;
+    uint8_t group_threshold;        // 0 until the first share arrives
+    uint8_t group_count;
+    uint8_t groups_complete;
+    uint8_t groups_needed;          // more complete groups needed, 0 once
+                                    //   the secret can be recovered
+    int error;                      // ERROR_INCONSISTENT_GROUP if the
+                                    //   complete groups do not recover the
+                                    //   master secret, else 0
+    slip39_combiner_group groups[16];
+} slip39_combiner_status;
+
+/**
+ * create an empty combiner
+ *
+ * returns: 0, or ERROR_INSUFFICIENT_SPACE if memory could not be allocated
+ *
+ * inputs: combiner: location to store the handle, which must be released
+ *                   with slip39_combiner_free. Set to NULL when
+ *                   unsuccessful.
+ */
+int slip39_combiner_new(
+    slip39_combiner **combiner
+);
+
+/**
+ * wipe and release a combiner
+ */
+void slip39_combiner_free(
+    slip39_combiner *combiner
+);
+
+/**
+ * add a share. A share that is rejected leaves the combiner as it was.
+ * Adding a share a second time does nothing.
+ *
+ * A share whose group then has enough members but does not recover a
+ * secret is kept, not rejected: the share that arrived last is no more
+ * likely to be the bad one than any other member of the group. The group
+ * is reported as inconsistent until a share is taken out of it with
+ * slip39_combiner_remove, and recovers nothing in the meantime. The same
+ * goes for the complete groups when they do not recover the master secret.
+ *
+ * returns: 1 if the master secret can now be recovered, 0 if more shares
+ *          are needed, or a negative error code: any error decoding the
+ *          share gives, ERROR_INVALID_SHARD_SET if its identifier,
+ *          iteration exponent, group threshold, group count or secret
+ *          length differ from the first share's or its group index is out
+ *          of range, ERROR_INVALID_MEMBER_THRESHOLD if its member threshold
+ *          differs from its group's, ERROR_DUPLICATE_MEMBER_INDEX if a
+ *          different share with the same group and member index was added,
+ *          or ERROR_INCONSISTENT_GROUP if the share was added but its group,
+ *          or the groups between them, are inconsistent
+ *
+ * inputs: combiner: the combiner
+ *         mnemonic: the words of the share
+ *         mnemonic_length: number of words
+ *         password: the password protecting the share, or NULL
+ */
+int slip39_combiner_add(
+    slip39_combiner *combiner,
+    const uint16_t *mnemonic,
+    uint32_t mnemonic_length,
+    const char *password
+);
+
+/**
+ * take a share back out, such as one suspected of making its group
+ * inconsistent. A group that was complete is worked out again from the
+ * members that are left, and so is the master secret.
+ *
+ * returns: 1 if the master secret can be recovered, 0 if more shares are
+ *          needed, ERROR_INVALID_SHARD_SET if there is no such share, or
+ *          ERROR_INCONSISTENT_GROUP if a group worked out again turns out
+ *          to be inconsistent
+ *
+ * inputs: combiner: the combiner
+ *         group_index: the group index of the share
+ *         member_index: the member index of the share
+ */
+int slip39_combiner_remove(
+    slip39_combiner *combiner,
+    uint8_t group_index,
+    uint8_t member_index
+);
+
+/**
+ * report which groups have enough members and how many more are needed
+ *
+ * inputs: combiner: the combiner
+ *         status: location to store the status
+ */
+void slip39_combiner_report(
+    const slip39_combiner *combiner,
+    slip39_combiner_status *status
+);
+
+/**
+ * decrypt the master secret once enough shares have been added
+ *
+ * returns: the length of the master secret, ERROR_NOT_ENOUGH_GROUPS if
+ *          more shares are needed, or ERROR_INSUFFICIENT_SPACE
+ *
+ * inputs: combiner: the combiner
+ *         passphrase: passphrase to unlock the master secret
+ *         buffer: location to store the master secret
+ *         buffer_length: maximum space available in buffer
+ */
+int slip39_combiner_secret(
+    const slip39_combiner *combiner,
+    const char *passphrase,
+    uint8_t *buffer,
+    uint32_t buffer_length
+);
+
+#endif /* COMBINER_H */
@@ -0,0 +1,509 @@
+//
+//  container.c
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#include "container.h"
+#include "encoding.h"
+#include "mnemonics.h"
+#include "parser.h"
+#include "slip39-errors.h"
+#include "util.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ARDUINO
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define CONTAINER_HEADER_LENGTH 32
+#define CONTAINER_INDEX_ENTRY_LENGTH 8
+#define CONTAINER_PATH_LENGTH 4096
+
+static const uint8_t magic[8] = {'S', 'L', 'I', 'P', '3', '9', 'S', 'C'};
+
+#ifdef ARDUINO
+
+// there is no file system to keep containers on
+
+int slip39_container_write(
+    const char *path,
+    const uint16_t *const *shares,
+    const uint32_t *lengths,
+    uint32_t count
+) {
+    return ERROR_CONTAINER_IO;
+}
+
+int slip39_container_open(
+    const char *path,
+    slip39_container **container
+) {
+    *container = NULL;
+    return ERROR_CONTAINER_IO;
+}
+
+void slip39_container_close(slip39_container *container) {
+}
+
+uint32_t slip39_container_count(const slip39_container *container) {
+    return 0;
+}
+
+const uint8_t *slip39_container_share(
+    const slip39_container *container,
+    uint32_t index,
+    uint32_t *length
+) {
+    return NULL;
+}
+
+int32_t slip39_container_words(
+    const slip39_container *container,
+    uint32_t index,
+    uint16_t *words,
+    uint32_t max
+) {
+    return ERROR_INVALID_CONTAINER;
+}
+
+uint32_t slip39_container_find(
+    const slip39_container *container,
+    uint16_t identifier,
+    int16_t group_index,
+    uint32_t *records,
+    uint32_t max
+) {
+    return 0;
+}
+
+int slip39_container_from_text(
+    const char *text_path,
+    const char *container_path
+) {
+    return ERROR_CONTAINER_IO;
+}
+
+int slip39_container_to_text(
+    const char *container_path,
+    const char *text_path
+) {
+    return ERROR_CONTAINER_IO;
+}
+
+#else
+
+struct slip39_container_struct {
+    const uint8_t *map;
+    size_t size;
+    uint32_t count;
+    uint32_t stride;
+    size_t record_length;
+    const uint8_t *records;
+    const uint8_t *index;
+};
+
+// a record is the number of words, then the words packed to the stride
+static size_t record_length_for(uint32_t stride) {
+    return 2 + slip39_packed_size_for_words(stride);
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    put16(p, v);
+    put16(p + 2, v >> 16);
+}
+
+static uint16_t get16(const uint8_t *p) {
+    return p[0] | p[1] << 8;
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return get16(p) | (uint32_t) get16(p + 2) << 16;
+}
+
+// the sort key of an index entry: identifier, group index, member index
+static uint32_t entry_key(const uint8_t *entry) {
+    return (uint32_t) get16(entry) << 16 | entry[2] << 8 | entry[3];
+}
+
+static int compare_entries(const void *a, const void *b) {
+    uint32_t ka = entry_key(a);
+    uint32_t kb = entry_key(b);
+    if(ka != kb) {
+        return ka < kb ? -1 : 1;
+    }
+    uint32_t ra = get32((const uint8_t *) a + 4);
+    uint32_t rb = get32((const uint8_t *) b + 4);
+    return ra < rb ? -1 : ra > rb;
+}
+
+static int write_all(int fd, const uint8_t *data, size_t length) {
+    while(length > 0) {
+        ssize_t n = write(fd, data, length);
+        if(n <= 0) {
+            return ERROR_CONTAINER_IO;
+        }
+        data += n;
+        length -= n;
+    }
+    return 0;
+}
+
+int slip39_container_write(
+    const char *path,
+    const uint16_t *const *shares,
+    const uint32_t *lengths,
+    uint32_t count
+) {
+    uint32_t stride = 0;
+    for(uint32_t i=0; i<count; ++i) {
+        if(lengths[i] < MIN_MNEMONIC_LENGTH_WORDS) {
+            return ERROR_NOT_ENOUGH_MNEMONIC_WORDS;
+        }
+        if(lengths[i] > SLIP39_MAX_SHARE_WORDS) {
+            return ERROR_TOO_MANY_WORDS;
+        }
+        for(uint32_t j=0; j<lengths[i]; ++j) {
+            if(shares[i][j] >= 1024) {
+                return ERROR_INVALID_WORD;
+            }
+        }
+        if(lengths[i] > stride) {
+            stride = lengths[i];
+        }
+    }
+
+    size_t record_length = record_length_for(stride);
+    size_t records_length = record_length * count;
+    size_t index_length = (size_t) CONTAINER_INDEX_ENTRY_LENGTH * count;
+    size_t size = CONTAINER_HEADER_LENGTH + records_length + index_length;
+    if(size > UINT32_MAX) {
+        return ERROR_CONTAINER_IO;
+    }
+
+    uint8_t *file = calloc(1, size);
+    if(file == NULL) {
+        return ERROR_CONTAINER_IO;
+    }
+
+    memcpy(file, magic, sizeof(magic));
+    put32(file + 8, SLIP39_CONTAINER_VERSION);
+    put32(file + 12, count);
+    put32(file + 16, stride);
+    put32(file + 20, CONTAINER_HEADER_LENGTH);
+    put32(file + 24, CONTAINER_HEADER_LENGTH + records_length);
+
+    uint8_t *records = file + CONTAINER_HEADER_LENGTH;
+    uint8_t *index = records + records_length;
+    for(uint32_t i=0; i<count; ++i) {
+        const uint16_t *share = shares[i];
+        uint8_t *record = records + i * record_length;
+        put16(record, lengths[i]);
+        slip39_pack_words(share, lengths[i], record + 2, record_length - 2);
+
+        // the fields decode_mnemonic reads from the first four words
+        uint8_t *entry = index + i * CONTAINER_INDEX_ENTRY_LENGTH;
+        put16(entry, share[0] << 5 | share[1] >> 5);
+        entry[2] = share[2] >> 6;
+        entry[3] = (share[3] >> 4) & 15;
+        put32(entry + 4, i);
+    }
+    qsort(index, count, CONTAINER_INDEX_ENTRY_LENGTH, compare_entries);
+
+    char temporary[CONTAINER_PATH_LENGTH];
+    int n = snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+    int error = n <= 0 || n >= (int) sizeof(temporary) ? ERROR_CONTAINER_IO : 0;
+    int fd = -1;
+    if(!error) {
+        fd = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        error = fd < 0 ? ERROR_CONTAINER_IO : 0;
+    }
+    if(!error) {
+        error = write_all(fd, file, size);
+        error |= fsync(fd) != 0 ? ERROR_CONTAINER_IO : 0;
+        error |= close(fd) != 0 ? ERROR_CONTAINER_IO : 0;
+        if(error || rename(temporary, path) != 0) {
+            unlink(temporary);
+            error = ERROR_CONTAINER_IO;
+        }
+    }
+
+    free(file);
+    return error ? error : (int) count;
+}
+
+// map a whole file read only
+static int map_file(const char *path, const uint8_t **map, size_t *size) {
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        return ERROR_CONTAINER_IO;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        return ERROR_CONTAINER_IO;
+    }
+    *size = st.st_size;
+    *map = NULL;
+    if(*size > 0) {
+        void *p = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(p == MAP_FAILED) {
+            close(fd);
+            return ERROR_CONTAINER_IO;
+        }
+        *map = p;
+    }
+    close(fd);
+    return 0;
+}
+
+int slip39_container_open(
+    const char *path,
+    slip39_container **container
+) {
+    *container = NULL;
+
+    const uint8_t *map;
+    size_t size;
+    int error = map_file(path, &map, &size);
+    if(error) {
+        return error;
+    }
+
+    error = ERROR_INVALID_CONTAINER;
+    if(size < CONTAINER_HEADER_LENGTH || memcmp(map, magic, sizeof(magic)) != 0 ||
+       get32(map + 8) != SLIP39_CONTAINER_VERSION) {
+        goto fail;
+    }
+
+    uint32_t count = get32(map + 12);
+    uint32_t stride = get32(map + 16);
+    uint64_t records = get32(map + 20);
+    uint64_t index = get32(map + 24);
+    if(stride > SLIP39_MAX_SHARE_WORDS) {
+        goto fail;
+    }
+    uint64_t record_length = record_length_for(stride);
+    if(records < CONTAINER_HEADER_LENGTH ||
+       records + record_length * count > size ||
+       index < records + record_length * count ||
+       index + (uint64_t) CONTAINER_INDEX_ENTRY_LENGTH * count > size) {
+        goto fail;
+    }
+
+    // every index entry names a record, in order
+    for(uint32_t i=0; i<count; ++i) {
+        const uint8_t *entry = map + index + (size_t) i * CONTAINER_INDEX_ENTRY_LENGTH;
+        if(get32(entry + 4) >= count ||
+           (i > 0 && entry_key(entry - CONTAINER_INDEX_ENTRY_LENGTH) > entry_key(entry))) {
+            goto fail;
+        }
+    }
+
+    slip39_container *c = malloc(sizeof(slip39_container));
+    if(c == NULL) {
+        error = ERROR_CONTAINER_IO;
+        goto fail;
+    }
+    c->map = map;
+    c->size = size;
+    c->count = count;
+    c->stride = stride;
+    c->record_length = record_length;
+    c->records = map + records;
+    c->index = map + index;
+    *container = c;
+    return 0;
+
+fail:
+    if(map != NULL) {
+        munmap((void *) map, size);
+    }
+    return error;
+}
+
+void slip39_container_close(slip39_container *container) {
+    if(container == NULL) {
+        return;
+    }
+    if(container->map != NULL) {
+        munmap((void *) container->map, container->size);
+    }
+    free(container);
+}
+
+uint32_t slip39_container_count(const slip39_container *container) {
+    return container->count;
+}
+
+const uint8_t *slip39_container_share(
+    const slip39_container *container,
+    uint32_t index,
+    uint32_t *length
+) {
+    if(index >= container->count) {
+        return NULL;
+    }
+    const uint8_t *record = container->records + (size_t) index * container->record_length;
+    uint16_t n = get16(record);
+    if(n > container->stride) {
+        return NULL;
+    }
+    *length = n;
+    return record + 2;
+}
+
+int32_t slip39_container_words(
+    const slip39_container *container,
+    uint32_t index,
+    uint16_t *words,
+    uint32_t max
+) {
+    uint32_t length;
+    const uint8_t *packed = slip39_container_share(container, index, &length);
+    if(packed == NULL) {
+        return ERROR_INVALID_CONTAINER;
+    }
+    return slip39_unpack_words(packed, length, words, max);
+}
+
+uint32_t slip39_container_find(
+    const slip39_container *container,
+    uint16_t identifier,
+    int16_t group_index,
+    uint32_t *records,
+    uint32_t max
+) {
+    // the entries for a group, or for every group, have keys from low up
+    // to (not including) high
+    uint32_t low = (uint32_t) identifier << 16;
+    uint32_t high = low + 0x10000;
+    if(group_index >= 0) {
+        low |= (uint32_t) group_index << 8;
+        high = low + 0x100;
+    }
+
+    uint32_t lo = 0;
+    uint32_t hi = container->count;
+    while(lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if(entry_key(container->index + (size_t) mid * CONTAINER_INDEX_ENTRY_LENGTH) < low) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    uint32_t found = 0;
+    for(uint32_t i=lo; i<container->count; ++i, ++found) {
+        const uint8_t *entry = container->index + (size_t) i * CONTAINER_INDEX_ENTRY_LENGTH;
+        if(entry_key(entry) >= high) {
+            break;
+        }
+        if(found < max) {
+            records[found] = get32(entry + 4);
+        }
+    }
+    return found;
+}
+
+int slip39_container_from_text(
+    const char *text_path,
+    const char *container_path
+) {
+    const uint8_t *text;
+    size_t size;
+    int error = map_file(text_path, &text, &size);
+    if(error) {
+        return error;
+    }
+
+    // a word takes at least two bytes with its separator, and a share at
+    // least one word
+    uint32_t capacity = size / 2 + 1 + SLIP39_MAX_SHARE_WORDS;
+    uint16_t *words = malloc(sizeof(uint16_t) * capacity);
+    uint32_t *offsets = malloc(sizeof(uint32_t) * (capacity + 1));
+    int32_t *errors = malloc(sizeof(int32_t) * capacity);
+    const uint16_t **shares = malloc(sizeof(uint16_t *) * capacity);
+    uint32_t *lengths = malloc(sizeof(uint32_t) * capacity);
+
+    if(words == NULL || offsets == NULL || errors == NULL || shares == NULL || lengths == NULL) {
+        error = ERROR_CONTAINER_IO;
+    } else {
+        slip39_share_parser parser;
+        slip39_share_parser_init(&parser, words, capacity, offsets, errors, capacity);
+        slip39_share_parser_feed(&parser, (const char *) text, size);
+        slip39_share_parser_finish(&parser);
+
+        for(uint32_t i=0; i<parser.share_count && !error; ++i) {
+            error = errors[i];
+            shares[i] = words + offsets[i];
+            lengths[i] = offsets[i+1] - offsets[i];
+        }
+        if(!error) {
+            error = slip39_container_write(container_path, shares, lengths, parser.share_count);
+        }
+    }
+
+    free(lengths);
+    free(shares);
+    free(errors);
+    free(offsets);
+    free(words);
+    if(text != NULL) {
+        munmap((void *) text, size);
+    }
+    return error;
+}
+
+int slip39_container_to_text(
+    const char *container_path,
+    const char *text_path
+) {
+    slip39_container *container;
+    int error = slip39_container_open(container_path, &container);
+    if(error) {
+        return error;
+    }
+
+    size_t line_size = (size_t) container->stride * 9 + 1;
+    char *line = malloc(line_size);
+    uint16_t share[SLIP39_MAX_SHARE_WORDS];
+    FILE *file = fopen(text_path, "w");
+    error = line == NULL || file == NULL ? ERROR_CONTAINER_IO : 0;
+
+    for(uint32_t i=0; i<container->count && !error; ++i) {
+        int32_t length = slip39_container_words(container, i, share, SLIP39_MAX_SHARE_WORDS);
+        if(length < 0) {
+            error = ERROR_INVALID_CONTAINER;
+            break;
+        }
+        size_t n = slip39_format_words(share, length, line, line_size);
+        line[n - 1] = '\n';
+        if(fwrite(line, 1, n, file) != n) {
+            error = ERROR_CONTAINER_IO;
+        }
+    }
+
+    if(file != NULL && fclose(file) != 0 && !error) {
+        error = ERROR_CONTAINER_IO;
+    }
+    free(line);
+    uint32_t count = container->count;
+    slip39_container_close(container);
+    return error ? error : (int) count;
+}
+
+#endif
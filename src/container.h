@@ -0,0 +1,177 @@
+//
+//  container.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#ifndef CONTAINER_H
+#define CONTAINER_H
+
+#include <stdint.h>
+
+/**
+ * a binary file of shares, read through mmap so that each share can be
+ * handed to decode_packed_mnemonic where it lies in the file.
+ *
+ * All numbers are little-endian. The file is
+ *
+ *   header, 32 bytes:
+ *     "SLIP39SC"                          magic
+ *     uint32 version                      SLIP39_CONTAINER_VERSION
+ *     uint32 count                        number of shares
+ *     uint32 stride                       words in the longest share
+ *     uint32 records                      offset of the first record
+ *     uint32 index                        offset of the index
+ *     uint32 reserved                     0
+ *   count records, 2 + slip39_packed_size_for_words(stride) bytes each,
+ *   in the order written:
+ *     uint16 length                       words in the share
+ *     uint8 packed[]                      the share as slip39_pack_words
+ *                                         packs it, metadata and value
+ *                                         words alike, then zeros
+ *   count index entries, 8 bytes each, sorted by identifier, group index
+ *   and member index:
+ *     uint16 identifier
+ *     uint8 group_index
+ *     uint8 member_index
+ *     uint32 record
+ *
+ * Packing four words to five bytes makes the file about a sixth of the
+ * size of the text form. Version 1 kept each word in 16 bits and is no
+ * longer read.
+ */
+typedef struct slip39_container_struct slip39_container;
+
+#define SLIP39_CONTAINER_VERSION 2
+
+/**
+ * write shares to a container file. The file is written beside the
+ * destination and renamed into place, so readers see the old file or the
+ * new one.
+ *
+ * returns: the number of shares written, or a negative error code:
+ *          ERROR_NOT_ENOUGH_MNEMONIC_WORDS, ERROR_TOO_MANY_WORDS or
+ *          ERROR_INVALID_WORD for a share that is too short, longer than
+ *          SLIP39_MAX_SHARE_WORDS or has a word wider than 10 bits,
+ *          ERROR_CONTAINER_IO if the file could not be written
+ *
+ * inputs: path: the file to write
+ *         shares: the shares
+ *         lengths: the number of words in each share
+ *         count: the number of shares
+ */
+int slip39_container_write(
+    const char *path,
+    const uint16_t *const *shares,
+    const uint32_t *lengths,
+    uint32_t count
+);
+
+/**
+ * map a container file for reading
+ *
+ * returns: 0, ERROR_CONTAINER_IO if the file could not be read, or
+ *          ERROR_INVALID_CONTAINER if it is not a container this library
+ *          can read
+ *
+ * inputs: path: the file to read
+ *         container: location to store the handle, which must be released
+ *                    with slip39_container_close. Set to NULL when
+ *                    unsuccessful.
+ */
+int slip39_container_open(
+    const char *path,
+    slip39_container **container
+);
+
+/**
+ * unmap a container, invalidating every share it handed out
+ */
+void slip39_container_close(slip39_container *container);
+
+/**
+ * returns: the number of shares in the container
+ */
+uint32_t slip39_container_count(const slip39_container *container);
+
+/**
+ * a share as it lies in the mapped file, packed by slip39_pack_words and
+ * ready for decode_packed_mnemonic or slip39_combine_packed. Valid until
+ * the container is closed.
+ *
+ * returns: the packed share, or NULL if index is out of range or the
+ *          record is damaged
+ *
+ * inputs: container: the container
+ *         index: the record number, in the order the shares were written
+ *         length: location to store the number of words in the share
+ */
+const uint8_t *slip39_container_share(
+    const slip39_container *container,
+    uint32_t index,
+    uint32_t *length
+);
+
+/**
+ * unpack a share of a container into words
+ *
+ * returns: the number of words, ERROR_INVALID_CONTAINER if index is out of
+ *          range or the record is damaged, or ERROR_INSUFFICIENT_SPACE
+ *
+ * inputs: container: the container
+ *         index: the record number, in the order the shares were written
+ *         words: location to store the words
+ *         max: maximum number of words to store
+ */
+int32_t slip39_container_words(
+    const slip39_container *container,
+    uint32_t index,
+    uint16_t *words,
+    uint32_t max
+);
+
+/**
+ * look up the shares of a secret, or of one group of it, in the index
+ *
+ * returns: the number of shares found, which may be more than max (only
+ *          max are stored)
+ *
+ * inputs: container: the container
+ *         identifier: the identifier of the secret
+ *         group_index: the group, or -1 for every group
+ *         records: location to store the record numbers, ordered by group
+ *                  and member index
+ *         max: maximum number of record numbers to store
+ */
+uint32_t slip39_container_find(
+    const slip39_container *container,
+    uint16_t identifier,
+    int16_t group_index,
+    uint32_t *records,
+    uint32_t max
+);
+
+/**
+ * convert a text file of shares, one per line, to a container
+ *
+ * returns: the number of shares, ERROR_CONTAINER_IO, or the first error
+ *          slip39_share_parser reported for a line
+ */
+int slip39_container_from_text(
+    const char *text_path,
+    const char *container_path
+);
+
+/**
+ * convert a container to a text file of shares, one per line
+ *
+ * returns: the number of shares, or any error slip39_container_open
+ *          returns
+ */
+int slip39_container_to_text(
+    const char *container_path,
+    const char *text_path
+);
+
+#endif /* CONTAINER_H */
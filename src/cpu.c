@@ -0,0 +1,98 @@
+//
+//  cpu.c
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#include "cpu.h"
+
+#if !defined(ARDUINO) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CPU_X86 1
+#include <cpuid.h>
+#endif
+
+#if !defined(ARDUINO) && defined(__aarch64__) && defined(__linux__)
+#define CPU_ARM_LINUX 1
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+#ifdef CPU_X86
+// the extended register state has to be enabled by the operating
+// system, not just supported by the processor
+static uint64_t xgetbv(uint32_t index) {
+    uint32_t eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+    return ((uint64_t)edx << 32) | eax;
+}
+
+static uint32_t detect_features(void) {
+    uint32_t eax, ebx, ecx, edx;
+    uint32_t features = 0;
+    uint8_t sse41, osxsave;
+    uint64_t xcr0 = 0;
+
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    sse41 = (ecx >> 19) & 1;
+    osxsave = (ecx >> 27) & 1;
+    if(osxsave) {
+        xcr0 = xgetbv(0);
+    }
+
+    if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+
+    if(sse41 && ((ebx >> 29) & 1)) {
+        features |= SLIP39_CPU_SHA_NI;
+    }
+    // xmm and ymm state
+    if(((ebx >> 5) & 1) && (xcr0 & 0x06) == 0x06) {
+        features |= SLIP39_CPU_AVX2;
+    }
+    // plus opmask and zmm state
+    if(((ebx >> 16) & 1) && (xcr0 & 0xe6) == 0xe6) {
+        features |= SLIP39_CPU_AVX512;
+    }
+
+    return features;
+}
+#elif defined(CPU_ARM_LINUX)
+static uint32_t detect_features(void) {
+    uint32_t features = 0;
+#ifdef HWCAP_SHA2
+    if(getauxval(AT_HWCAP) & HWCAP_SHA2) {
+        features |= SLIP39_CPU_ARMV8_SHA2;
+    }
+#endif
+    return features;
+}
+#elif defined(__aarch64__) && defined(__APPLE__)
+static uint32_t detect_features(void) {
+    // every Apple arm64 processor has the SHA-2 instructions
+    return SLIP39_CPU_ARMV8_SHA2;
+}
+#else
+static uint32_t detect_features(void) {
+    return 0;
+}
+#endif
+
+// marks the cached value as filled in
+#define CPU_DETECTED (1u << 31)
+
+uint32_t slip39_cpu_features(void) {
+    // detection is idempotent and the answer is a single word, so
+    // threads racing here just store the same value
+    static volatile uint32_t cached = 0;
+    uint32_t features = cached;
+
+    if(!(features & CPU_DETECTED)) {
+        features = detect_features() | CPU_DETECTED;
+        cached = features;
+    }
+    return features & ~CPU_DETECTED;
+}
@@ -0,0 +1,26 @@
+//
+//  cpu.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#ifndef CPU_H
+#define CPU_H
+
+#include <stdint.h>
+
+#define SLIP39_CPU_SHA_NI        (1 << 0)
+#define SLIP39_CPU_AVX2          (1 << 1)
+#define SLIP39_CPU_AVX512        (1 << 2)
+#define SLIP39_CPU_ARMV8_SHA2    (1 << 3)
+
+/**
+ * returns: the set of SLIP39_CPU_* features the processor and operating
+ *          system support. Only features the library can make use of on
+ *          the current architecture are reported. The answer is
+ *          computed on the first call and cached.
+ */
+uint32_t slip39_cpu_features(void);
+
+#endif /* CPU_H */
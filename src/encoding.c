@@ -6,7 +6,10 @@
 //
 
 #include "slip39-errors.h"
+#include "encoding.h"
+#include "cpu.h"
 #include "wordlist-english.h"
+#include "wordlist-english-hash.h"
 #include "util.h"
 
 #include <stdint.h>
@@ -14,10 +17,121 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#if !defined(ARDUINO) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ENCODING_X86 1
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+// the longest string the edit distance functions accept
+#define MAX_DISTANCE_LENGTH 16
+
 //////////////////////////////////////////////////
 // slip39 words
 //
+// zero pad a word to the width of the packed table, returning its length,
+// or 9 if it is too long to be a code word
+static uint32_t pad_word(const char *word, char padded[8]) {
+    uint32_t length = 0;
+    memset(padded, 0, 8);
+    while(length < 8 && word[length]) {
+        padded[length] = word[length];
+        ++length;
+    }
+    return word[length] ? 9 : length;
+}
+
+// the word with the same first four letters, if there is one
+static uint16_t hash_word(const char padded[8]) {
+    uint32_t key = (uint32_t) (uint8_t) padded[0] |
+        (uint32_t) (uint8_t) padded[1] << 8 |
+        (uint32_t) (uint8_t) padded[2] << 16 |
+        (uint32_t) (uint8_t) padded[3] << 24;
+    uint32_t bucket = (key * WORDLIST_HASH_BUCKET_MULTIPLIER) >> (32 - WORDLIST_HASH_BUCKET_BITS);
+    uint32_t slot = ((key * WORDLIST_HASH_SLOT_MULTIPLIER) >> (32 - WORDLIST_HASH_SLOT_BITS)) ^
+        wordlist_hash_displacement[bucket];
+    return wordlist_hash_slots[slot];
+}
+
 int16_t slip39_word_for_string(const char *word) {
+    char padded[8];
+    if(pad_word(word, padded) > 8) {
+        return -1;
+    }
+
+    // every word is unique in its first four letters
+    uint16_t index = hash_word(padded);
+    if(memcmp(padded, wordlist_packed[index], 8) != 0) {
+        return -1;
+    }
+    return index;
+}
+
+int16_t slip39_word_for_abbreviation(const char *word) {
+    char padded[8];
+    uint32_t length = pad_word(word, padded);
+    return slip39_word_for_padded(padded, length);
+}
+
+int16_t slip39_word_for_padded(const char padded[8], uint32_t length) {
+    if(length < 4 || length > 8) {
+        return -1;
+    }
+
+    uint16_t index = hash_word(padded);
+    if(memcmp(padded, wordlist_packed[index], length) != 0) {
+        return -1;
+    }
+    return index;
+}
+
+uint32_t slip39_words_with_prefix(
+    const char *prefix,
+    uint16_t *words,
+    uint32_t max
+) {
+    char padded[8];
+    uint32_t length = pad_word(prefix, padded);
+    uint32_t lo = 0;
+    uint32_t hi = WORDLIST_SIZE;
+
+    if(length > 8) {
+        return 0;
+    }
+    for(uint32_t k=0; k<length && k<2; ++k) {
+        if(padded[k] < 'a' || padded[k] > 'z') {
+            return 0;
+        }
+    }
+
+    // the first one or two letters come from the range table
+    if(length == 1) {
+        uint32_t x = padded[0] - 'a';
+        lo = wordlist_prefix_start[x * 26];
+        hi = wordlist_prefix_start[(x + 1) * 26];
+    } else if(length >= 2) {
+        uint32_t xy = (padded[0] - 'a') * 26 + (padded[1] - 'a');
+        lo = wordlist_prefix_start[xy];
+        hi = wordlist_prefix_start[xy + 1];
+    }
+
+    // and each further letter narrows the range from both ends
+    for(uint32_t k=2; k<length; ++k) {
+        while(lo < hi && wordlist_packed[lo][k] != padded[k]) {
+            ++lo;
+        }
+        while(lo < hi && wordlist_packed[hi-1][k] != padded[k]) {
+            --hi;
+        }
+    }
+
+    for(uint32_t i=lo; i<hi && i-lo<max; ++i) {
+        words[i-lo] = i;
+    }
+    return hi - lo;
+}
+
+int16_t slip39_word_for_string_reference(const char *word) {
     int16_t hi=WORDLIST_SIZE;
     int16_t lo=-1;
 
@@ -47,29 +161,55 @@ char* slip39_strings_for_words(
   const uint16_t* words,
   size_t words_len
 ) {
-  if(words_len == 0) {
-    char* result = malloc(1);
-    result[0] = '\0';
-    return result;
-  }
-
-  size_t result_len = words_len; // space characters + nul
-  const char* strings[words_len];
-  for(int i = 0; i < words_len; i++) {
-    strings[i] = slip39_string_for_word(words[i]);
-    result_len += strlen(strings[i]);
-  }
+  size_t result_len = slip39_format_words(words, words_len, NULL, 0);
   char* result_string = malloc(result_len);
-  result_string[0] = '\0';
+  slip39_format_words(words, words_len, result_string, result_len);
+  return result_string;
+}
+
+size_t slip39_format_words(
+    const uint16_t *words,
+    size_t words_length,
+    char *buffer,
+    size_t buffer_size
+) {
+    // a space after every word, the last of which becomes the nul
+    size_t needed = words_length > 0 ? words_length : 1;
+    for(size_t i=0; i<words_length; ++i) {
+        needed += words[i] < WORDLIST_SIZE ? wordlist_length[words[i]] : 0;
+    }
+    if(needed > buffer_size) {
+        return needed;
+    }
 
-  for(int i = 0; i < words_len; i++) {
-    strcat(result_string, strings[i]);
-    if(i != words_len - 1) {
-      strcat(result_string, " ");
+    char *p = buffer;
+    for(size_t i=0; i<words_length; ++i) {
+        uint16_t word = words[i];
+        if(word < WORDLIST_SIZE) {
+            memcpy(p, wordlist_packed[word], wordlist_length[word]);
+            p += wordlist_length[word];
+        }
+        *p++ = ' ';
     }
-  }
+    buffer[needed - 1] = 0;
+    return needed;
+}
 
-  return result_string;
+size_t slip39_format_shares(
+    const uint16_t *mnemonics,
+    uint32_t share_count,
+    uint32_t mnemonic_length,
+    char *arena,
+    size_t arena_size,
+    size_t *offsets
+) {
+    size_t pos = 0;
+    for(uint32_t i=0; i<share_count; ++i) {
+        offsets[i] = pos;
+        pos += slip39_format_words(mnemonics + i * mnemonic_length, mnemonic_length,
+            pos < arena_size ? arena + pos : NULL, pos < arena_size ? arena_size - pos : 0);
+    }
+    return pos;
 }
 
 uint32_t slip39_words_for_strings(
@@ -97,10 +237,9 @@ uint32_t slip39_words_for_strings(
         }
 
         if(j<words_length) {
-            int16_t w = slip39_word_for_string(buf);
+            int16_t w = slip39_word_for_abbreviation(buf);
             if(w<0) {
-                printf("%s is not valid.\n", buf);
-                return -1;
+                return UINT32_MAX;
             } else {
                 words[j] = w;
             }
@@ -117,7 +256,7 @@ uint32_t slip39_words_for_strings(
 
 // convert a buffer of bytes into 10-bit mnemonic words
 // returns the number of words written or -1 if there was an error
-int32_t slip39_words_for_data(
+int32_t slip39_words_for_data_reference(
     const uint8_t *buffer, // byte buffer to encode into 10-bit words
     uint32_t size,   // buffer size
     uint16_t *words, // destination for words
@@ -168,7 +307,7 @@ int32_t slip39_words_for_data(
 }
 
 // returns the number of bytes written, or -1 if there was an error
-int32_t slip39_data_for_words(
+int32_t slip39_data_for_words_reference(
     const uint16_t *words, // words to decode
     uint32_t wordsize,       // number of words to decode
     uint8_t *buffer,          // space for result
@@ -228,3 +367,481 @@ int32_t slip39_data_for_words(
 
     return byte;
 }
+
+//////////////////////////////////////////////////
+// 5 byte / 4 word kernels
+//
+// 40 bits are exactly 5 bytes or 4 words, so past a short head the
+// conversions go a group at a time with no bits carried between groups.
+// Within a group the 40 bit big-endian value sits in the low bits of a
+// 64 bit integer.
+
+static void words_for_groups_scalar(
+    const uint8_t *bytes,
+    uint32_t groups,
+    uint16_t *words
+) {
+    for(uint32_t g=0; g<groups; ++g, bytes+=5, words+=4) {
+        uint64_t v = (uint64_t) bytes[0] << 32 | (uint64_t) bytes[1] << 24 |
+            (uint64_t) bytes[2] << 16 | (uint64_t) bytes[3] << 8 | bytes[4];
+        words[0] = v >> 30;
+        words[1] = (v >> 20) & 1023;
+        words[2] = (v >> 10) & 1023;
+        words[3] = v & 1023;
+    }
+}
+
+static void groups_for_words_scalar(
+    const uint16_t *words,
+    uint32_t groups,
+    uint8_t *bytes
+) {
+    for(uint32_t g=0; g<groups; ++g, bytes+=5, words+=4) {
+        uint64_t v = (uint64_t) words[0] << 30 | (uint64_t) words[1] << 20 |
+            (uint64_t) words[2] << 10 | words[3];
+        bytes[0] = v >> 32;
+        bytes[1] = v >> 24;
+        bytes[2] = v >> 16;
+        bytes[3] = v >> 8;
+        bytes[4] = v;
+    }
+}
+
+#ifdef ENCODING_X86
+// four groups at a time, one in each 64 bit lane. Each 128 bit half
+// loads 16 bytes for its two groups, so the loads read 6 bytes past the
+// fourth group and there must be more groups after it. The four words of
+// a group go to the four 16 bit lanes of its 64 bit lane, first word
+// lowest.
+AVX2_TARGET
+static void words_for_groups_avx2(
+    const uint8_t *bytes,
+    uint32_t groups,
+    uint16_t *words
+) {
+    // reverse each group's bytes into the bottom of its lane
+    const __m256i order = _mm256_setr_epi8(
+        4, 3, 2, 1, 0, -1, -1, -1, 9, 8, 7, 6, 5, -1, -1, -1,
+        4, 3, 2, 1, 0, -1, -1, -1, 9, 8, 7, 6, 5, -1, -1, -1);
+    const __m256i mask0 = _mm256_set1_epi64x(0x3FF);
+    const __m256i mask1 = _mm256_set1_epi64x(0x3FFll << 16);
+    const __m256i mask2 = _mm256_set1_epi64x(0x3FFll << 32);
+    const __m256i mask3 = _mm256_set1_epi64x(0x3FFll << 48);
+
+    for(; groups >= 6; groups -= 4, bytes += 20, words += 16) {
+        __m256i v = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) bytes)),
+            _mm_loadu_si128((const __m128i *) (bytes + 10)), 1);
+        v = _mm256_shuffle_epi8(v, order);
+        __m256i lanes = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_and_si256(_mm256_srli_epi64(v, 30), mask0),
+                _mm256_and_si256(_mm256_srli_epi64(v, 4), mask1)),
+            _mm256_or_si256(
+                _mm256_and_si256(_mm256_slli_epi64(v, 22), mask2),
+                _mm256_and_si256(_mm256_slli_epi64(v, 48), mask3)));
+        _mm256_storeu_si256((__m256i *) words, lanes);
+    }
+
+    words_for_groups_scalar(bytes, groups, words);
+}
+
+// the reverse, storing 16 bytes for every 10 so that the stores write 6
+// bytes past the fourth group
+AVX2_TARGET
+static void groups_for_words_avx2(
+    const uint16_t *words,
+    uint32_t groups,
+    uint8_t *bytes
+) {
+    const __m256i order = _mm256_setr_epi8(
+        4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1,
+        4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1);
+    const __m256i mask0 = _mm256_set1_epi64x(0x3FFll << 30);
+    const __m256i mask1 = _mm256_set1_epi64x(0x3FFll << 20);
+    const __m256i mask2 = _mm256_set1_epi64x(0x3FFll << 10);
+    const __m256i mask3 = _mm256_set1_epi64x(0x3FF);
+
+    for(; groups >= 6; groups -= 4, bytes += 20, words += 16) {
+        __m256i lanes = _mm256_loadu_si256((const __m256i *) words);
+        __m256i v = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_and_si256(_mm256_slli_epi64(lanes, 30), mask0),
+                _mm256_and_si256(_mm256_slli_epi64(lanes, 4), mask1)),
+            _mm256_or_si256(
+                _mm256_and_si256(_mm256_srli_epi64(lanes, 22), mask2),
+                _mm256_and_si256(_mm256_srli_epi64(lanes, 48), mask3)));
+        v = _mm256_shuffle_epi8(v, order);
+        _mm_storeu_si128((__m128i *) bytes, _mm256_castsi256_si128(v));
+        _mm_storeu_si128((__m128i *) (bytes + 10), _mm256_extracti128_si256(v, 1));
+    }
+
+    groups_for_words_scalar(words, groups, bytes);
+}
+#endif
+
+// below this many groups the vector setup is not worth it
+#define AVX2_MIN_GROUPS 16
+
+static void words_for_groups(
+    const uint8_t *bytes,
+    uint32_t groups,
+    uint16_t *words
+) {
+#ifdef ENCODING_X86
+    if(groups >= AVX2_MIN_GROUPS && (slip39_cpu_features() & SLIP39_CPU_AVX2)) {
+        words_for_groups_avx2(bytes, groups, words);
+        return;
+    }
+#endif
+    words_for_groups_scalar(bytes, groups, words);
+}
+
+static void groups_for_words(
+    const uint16_t *words,
+    uint32_t groups,
+    uint8_t *bytes
+) {
+#ifdef ENCODING_X86
+    if(groups >= AVX2_MIN_GROUPS && (slip39_cpu_features() & SLIP39_CPU_AVX2)) {
+        groups_for_words_avx2(words, groups, bytes);
+        return;
+    }
+#endif
+    groups_for_words_scalar(words, groups, bytes);
+}
+
+int32_t slip39_words_for_data(
+    const uint8_t *buffer,
+    uint32_t size,
+    uint16_t *words,
+    uint32_t max
+) {
+    uint32_t count = slip39_word_count_for_bytes(size);
+    if(max < count) {
+        printf("Not enough space to encode into 10-bit words \n");
+        return -1;
+    }
+
+    // the first size % 5 bytes, with two bits of padding for each, make
+    // as many words, and the rest are whole groups
+    uint32_t head = size % 5;
+    uint32_t v = 0;
+    for(uint32_t i=0; i<head; ++i) {
+        v = (v << 8) | buffer[i];
+    }
+    for(uint32_t i=0; i<head; ++i) {
+        words[i] = (v >> (10 * (head - 1 - i))) & 1023;
+    }
+
+    words_for_groups(buffer + head, size / 5, words + head);
+    return count;
+}
+
+int32_t slip39_data_for_words(
+    const uint16_t *words,
+    uint32_t wordsize,
+    uint8_t *buffer,
+    size_t size
+) {
+    // the first wordsize % 4 words carry two bits of padding each, which
+    // must be zero
+    uint32_t head = wordsize % 4;
+    if(head > 0 && (words[0] & (1023 << (10 - 2 * head)))) {
+        return ERROR_INVALID_PADDING;
+    }
+
+    // an odd number of groups may have had a zero byte dropped from the
+    // front, and words wider than 10 bits spill into their neighbours;
+    // both are left to the bit at a time version
+    uint16_t wide = 0;
+    for(uint32_t i=0; i<wordsize; ++i) {
+        wide |= words[i];
+    }
+    if((wordsize % 4 == 0 && (wordsize & 4)) || wide >= 1024) {
+        return slip39_data_for_words_reference(words, wordsize, buffer, size);
+    }
+
+    uint32_t count = slip39_byte_count_for_words(wordsize);
+    if(size < count) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+
+    uint32_t v = 0;
+    for(uint32_t i=0; i<head; ++i) {
+        v = (v << 10) | words[i];
+    }
+    for(uint32_t i=0; i<head; ++i) {
+        buffer[i] = v >> (8 * (head - 1 - i));
+    }
+
+    groups_for_words(words + head, wordsize / 4, buffer + head);
+    return count;
+}
+
+int32_t slip39_pack_words(
+    const uint16_t *words,
+    uint32_t count,
+    uint8_t *packed,
+    size_t size
+) {
+    uint32_t bytes = slip39_packed_size_for_words(count);
+    if(size < bytes) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+    uint16_t wide = 0;
+    for(uint32_t i=0; i<count; ++i) {
+        wide |= words[i];
+    }
+    if(wide >= 1024) {
+        return ERROR_INVALID_WORD;
+    }
+
+    // whole groups, then the last few words left aligned in a short group
+    uint32_t groups = count / 4;
+    groups_for_words(words, groups, packed);
+    uint32_t tail = count % 4;
+    if(tail > 0) {
+        uint64_t v = 0;
+        for(uint32_t i=0; i<tail; ++i) {
+            v |= (uint64_t) words[4 * groups + i] << (30 - 10 * i);
+        }
+        uint8_t *p = packed + 5 * groups;
+        for(uint32_t i=0; i<bytes - 5 * groups; ++i) {
+            p[i] = v >> (32 - 8 * i);
+        }
+    }
+    return bytes;
+}
+
+int32_t slip39_unpack_words(
+    const uint8_t *packed,
+    uint32_t count,
+    uint16_t *words,
+    uint32_t max
+) {
+    if(max < count) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+
+    uint32_t groups = count / 4;
+    words_for_groups(packed, groups, words);
+    uint32_t tail = count % 4;
+    if(tail > 0) {
+        const uint8_t *p = packed + 5 * groups;
+        uint64_t v = 0;
+        for(uint32_t i=0; i<slip39_packed_size_for_words(tail); ++i) {
+            v |= (uint64_t) p[i] << (32 - 8 * i);
+        }
+        for(uint32_t i=0; i<tail; ++i) {
+            words[4 * groups + i] = (v >> (30 - 10 * i)) & 1023;
+        }
+    }
+    return count;
+}
+
+//////////////////////////////////////////////////
+// fuzzy matching
+//
+
+uint32_t slip39_string_distance(const char *a, const char *b) {
+    uint32_t m = strlen(a);
+    uint32_t n = strlen(b);
+    if(m > MAX_DISTANCE_LENGTH || n > MAX_DISTANCE_LENGTH) {
+        return UINT32_MAX;
+    }
+
+    // Lowrance-Wagner: d is offset by one so that row and column 0 can
+    // hold a distance larger than any real one, and last holds the last
+    // row each letter of a was seen in
+    uint8_t d[MAX_DISTANCE_LENGTH+2][MAX_DISTANCE_LENGTH+2];
+    uint8_t last[256] = {0};
+    uint8_t infinity = m + n;
+
+    d[0][0] = infinity;
+    for(uint32_t i=0; i<=m; ++i) {
+        d[i+1][0] = infinity;
+        d[i+1][1] = i;
+    }
+    for(uint32_t j=0; j<=n; ++j) {
+        d[0][j+1] = infinity;
+        d[1][j+1] = j;
+    }
+
+    for(uint32_t i=1; i<=m; ++i) {
+        uint32_t match = 0;
+        for(uint32_t j=1; j<=n; ++j) {
+            uint32_t k = last[(uint8_t) b[j-1]];
+            uint32_t l = match;
+            uint8_t cost = 1;
+            if(a[i-1] == b[j-1]) {
+                cost = 0;
+                match = j;
+            }
+            uint8_t best = d[i][j] + cost;
+            if(d[i+1][j] + 1 < best) {
+                best = d[i+1][j] + 1;
+            }
+            if(d[i][j+1] + 1 < best) {
+                best = d[i][j+1] + 1;
+            }
+            if(d[k][l] + (i-k-1) + 1 + (j-l-1) < best) {
+                best = d[k][l] + (i-k-1) + 1 + (j-l-1);
+            }
+            d[i+1][j+1] = best;
+        }
+        last[(uint8_t) a[i-1]] = i;
+    }
+
+    return d[m+1][n+1];
+}
+
+uint32_t slip39_word_distance(uint16_t a, uint16_t b) {
+    if(a >= WORDLIST_SIZE || b >= WORDLIST_SIZE) {
+        return UINT32_MAX;
+    }
+    return slip39_string_distance(wordlist[a], wordlist[b]);
+}
+
+uint32_t slip39_nearest_words(
+    const char *string,
+    uint32_t max_distance,
+    uint16_t *words,
+    uint8_t *distances,
+    uint32_t max
+) {
+    if(strlen(string) > MAX_DISTANCE_LENGTH) {
+        return 0;
+    }
+
+    uint16_t found_words[WORDLIST_SIZE];
+    uint8_t found_distances[WORDLIST_SIZE];
+    uint32_t found = 0;
+
+    // walk the BK-tree, by the triangle inequality only children whose
+    // distance from their parent is within max_distance of the string's
+    // can hold a match
+    uint16_t stack[WORDLIST_SIZE];
+    uint32_t top = 0;
+    stack[top++] = 0;
+
+    while(top > 0) {
+        uint16_t node = stack[--top];
+        uint16_t word = wordlist_bktree_word[node];
+        uint32_t d = slip39_string_distance(string, wordlist[word]);
+
+        if(d <= max_distance) {
+            found_words[found] = word;
+            found_distances[found] = d;
+            ++found;
+        }
+
+        for(uint32_t child = wordlist_bktree_first_child[node];
+            child < wordlist_bktree_first_child[node+1]; ++child) {
+            uint32_t edge = wordlist_bktree_distance[child];
+            if(edge + max_distance >= d && edge <= d + max_distance) {
+                stack[top++] = child;
+            }
+        }
+    }
+
+    // nearest first, then in wordlist order
+    for(uint32_t i=1; i<found; ++i) {
+        uint16_t word = found_words[i];
+        uint8_t distance = found_distances[i];
+        uint32_t j = i;
+        while(j > 0 && (found_distances[j-1] > distance ||
+              (found_distances[j-1] == distance && found_words[j-1] > word))) {
+            found_words[j] = found_words[j-1];
+            found_distances[j] = found_distances[j-1];
+            --j;
+        }
+        found_words[j] = word;
+        found_distances[j] = distance;
+    }
+
+    for(uint32_t i=0; i<found && i<max; ++i) {
+        words[i] = found_words[i];
+        if(distances) {
+            distances[i] = found_distances[i];
+        }
+    }
+    return found;
+}
+
+uint32_t slip39_word_candidates_for_strings(
+    const char *words_string,
+    uint32_t max_distance,
+    slip39_word_candidates *candidates,
+    uint32_t candidates_length
+) {
+    char buf[MAX_DISTANCE_LENGTH+1];
+    uint32_t j = 0;
+    const char *p = words_string;
+
+    while(*p) {
+        // unlike slip39_words_for_strings, capitals are taken as letters
+        // since scanned text is often mixed case
+        uint32_t i = 0;
+        for(; (*p>='a' && *p<='z') || (*p>='A' && *p<='Z'); p++) {
+            if(i < MAX_DISTANCE_LENGTH) {
+                buf[i] = *p | 0x20;
+            }
+            i++;
+        }
+        buf[i < MAX_DISTANCE_LENGTH ? i : MAX_DISTANCE_LENGTH] = 0;
+
+        if(i > 0) {
+            if(j < candidates_length) {
+                slip39_word_candidates *c = candidates + j;
+                int16_t w = slip39_word_for_abbreviation(buf);
+                if(w >= 0) {
+                    c->words[0] = w;
+                    c->distances[0] = 0;
+                    c->count = 1;
+                } else {
+                    uint32_t found = slip39_nearest_words(buf, max_distance,
+                        c->words, c->distances, SLIP39_MAX_CANDIDATES);
+                    c->count = found < SLIP39_MAX_CANDIDATES ? found : SLIP39_MAX_CANDIDATES;
+                }
+            }
+            j++;
+        }
+
+        while(*p && !((*p>='a' && *p<='z') || (*p>='A' && *p<='Z'))) {
+            p++;
+        }
+    }
+
+    return j;
+}
+
+//////////////////////////////////////////////////
+// ranking corrections
+//
+
+void slip39_rank_corrections(
+    const uint16_t *words,
+    rs1024_correction *corrections,
+    uint32_t count
+) {
+    for(uint32_t i=0; i<count; ++i) {
+        rs1024_correction *c = corrections + i;
+        if(c->kind == RS1024_SUBSTITUTION) {
+            c->distance = slip39_word_distance(words[c->position], c->word);
+        } else {
+            c->distance = 0;
+        }
+    }
+
+    // insertion sort, there are only ever a handful and it keeps ties in order
+    for(uint32_t i=1; i<count; ++i) {
+        rs1024_correction c = corrections[i];
+        uint32_t j = i;
+        while(j > 0 && corrections[j-1].distance > c.distance) {
+            corrections[j] = corrections[j-1];
+            --j;
+        }
+        corrections[j] = c;
+    }
+}
@@ -8,10 +8,45 @@
 #ifndef ENCODING_H
 #define ENCODING_H
 
+#include <stddef.h>
+#include "rs1024.h"
+
 // returns the 10-bit integer that a string represents, or -1
 // if the string is not a code word.
 int16_t slip39_word_for_string(const char *word);
 
+// like slip39_word_for_string, but also accepts the first four or more
+// letters of a word, which are enough to tell any two words apart.
+// returns the 10-bit integer, or -1 if the string is not a code word or
+// an abbreviation of one.
+int16_t slip39_word_for_abbreviation(const char *word);
+
+// slip39_word_for_abbreviation for length letters already in lower case
+// and zero padded to 8 bytes, for parsers that have them that way
+int16_t slip39_word_for_padded(const char padded[8], uint32_t length);
+
+/**
+ * find the words that start with a prefix, as typed into a share entry
+ * form. The words come out in wordlist order.
+ *
+ * returns: the number of words that start with the prefix, which may be
+ *          more than max (only max are stored)
+ *
+ * inputs: prefix: the letters typed so far, an empty string matches
+ *                 every word
+ *         words: location to store the matching words
+ *         max: maximum number of words to store
+ */
+uint32_t slip39_words_with_prefix(
+    const char *prefix,
+    uint16_t *words,
+    uint32_t max
+);
+
+// the binary search slip39_word_for_string used before the perfect hash,
+// kept for testing and benchmarking
+int16_t slip39_word_for_string_reference(const char *word);
+
 const char *slip39_string_for_word(int16_t word);
 
 /**
@@ -29,12 +64,59 @@ char* slip39_strings_for_words(
   size_t words_len
 );
 
+/**
+ * write the words of a share into a buffer, separated by single spaces
+ * and terminated by a nul. Nothing is allocated, and nothing is written
+ * unless it all fits.
+ *
+ * returns: the size of buffer needed, including the nul, which is more
+ *          than buffer_size if the words did not fit
+ *
+ * inputs: words: the words to write
+ *         words_length: number of words
+ *         buffer: location to write the string, may be NULL if
+ *                 buffer_size is 0
+ *         buffer_size: size of the buffer in bytes
+ */
+size_t slip39_format_words(
+    const uint16_t *words,
+    size_t words_length,
+    char *buffer,
+    size_t buffer_size
+);
+
+/**
+ * write every share from a slip39_generate output buffer into one arena,
+ * each as a nul terminated string in the form of slip39_format_words.
+ *
+ * returns: the size of arena needed, which is more than arena_size if
+ *          the shares did not all fit. Shares that do fit are written.
+ *
+ * inputs: mnemonics: the shares, one after the other
+ *         share_count: number of shares
+ *         mnemonic_length: number of words in each share
+ *         arena: location to write the strings
+ *         arena_size: size of the arena in bytes
+ *         offsets: location to store where each share's string starts in
+ *                  the arena, share_count entries
+ */
+size_t slip39_format_shares(
+    const uint16_t *mnemonics,
+    uint32_t share_count,
+    uint32_t mnemonic_length,
+    char *arena,
+    size_t arena_size,
+    size_t *offsets
+);
+
 /**
  * converts a string of whitespace delimited mnemonic words
  * to an array of 10-bit integers. Returns the number of integers
- * written to the buffer.
+ * written to the buffer. Words may be abbreviated to their first
+ * four letters.
  *
- * returns: number of ints written to the words buffer
+ * returns: number of ints written to the words buffer, or UINT32_MAX if
+ *          one of the words is not in the wordlist
  *
  * inputs: word_string: space delimited group of mnemonic words
  * words: space to return results
@@ -65,6 +147,22 @@ int32_t slip39_words_for_data(
     uint32_t max     // maximum number of words to write
 );
 
+// the bit at a time versions of slip39_words_for_data and
+// slip39_data_for_words, kept for testing and benchmarking
+int32_t slip39_words_for_data_reference(
+    const uint8_t *buffer,
+    uint32_t size,
+    uint16_t *words,
+    uint32_t max
+);
+
+int32_t slip39_data_for_words_reference(
+    const uint16_t *words,
+    uint32_t wordsize,
+    uint8_t *buffer,
+    size_t size
+);
+
 /**
  * convert a buffer of words into bytes
  *
@@ -82,4 +180,132 @@ int32_t slip39_data_for_words(
     size_t size            // total space available
 );
 
+/**
+ * pack 10-bit words four to five bytes, big-endian, for keeping large
+ * numbers of shares in memory. Word i takes bits 10 * i to 10 * i + 9
+ * counting from the top bit of the first byte, and the unused bits of the
+ * last byte are zero. Unlike slip39_data_for_words there is no padding at
+ * the front, so the metadata words of a share fill the first five bytes.
+ *
+ * returns: the number of bytes written, slip39_packed_size_for_words(count),
+ *          ERROR_INSUFFICIENT_SPACE, or ERROR_INVALID_WORD if a word is
+ *          wider than 10 bits
+ *
+ * inputs: words: the words to pack
+ *         count: number of words
+ *         packed: location to write the packed words
+ *         size: size of packed in bytes
+ */
+int32_t slip39_pack_words(
+    const uint16_t *words,
+    uint32_t count,
+    uint8_t *packed,
+    size_t size
+);
+
+/**
+ * unpack words packed by slip39_pack_words
+ *
+ * returns: count, or ERROR_INSUFFICIENT_SPACE
+ *
+ * inputs: packed: the packed words
+ *         count: number of words to unpack
+ *         words: location to store the words
+ *         max: maximum number of words to store
+ */
+int32_t slip39_unpack_words(
+    const uint8_t *packed,
+    uint32_t count,
+    uint16_t *words,
+    uint32_t max
+);
+
+/**
+ * the Damerau-Levenshtein distance between two strings, that is the
+ * number of letters inserted, deleted, changed or swapped with a
+ * neighbour that it takes to turn one into the other.
+ *
+ * returns: the distance, or UINT32_MAX if either string is longer than 16
+ */
+uint32_t slip39_string_distance(const char *a, const char *b);
+
+/**
+ * the slip39_string_distance between the spellings of two words. Small
+ * values suggest a slip of the pen rather than a different word.
+ *
+ * returns: the distance, or UINT32_MAX if either is not a code word
+ */
+uint32_t slip39_word_distance(uint16_t a, uint16_t b);
+
+/**
+ * find the words within an edit distance of a possibly misspelled string,
+ * using a precomputed BK-tree over the wordlist.
+ *
+ * returns: the number of words found, which may be more than max (only
+ *          the max nearest are stored)
+ *
+ * inputs: string: the string to match, at most 16 letters
+ *         max_distance: the largest slip39_string_distance to accept
+ *         words: location to store the words, nearest first and in
+ *                wordlist order among equals
+ *         distances: location to store the distance of each word, or NULL
+ *         max: maximum number of words to store
+ */
+uint32_t slip39_nearest_words(
+    const char *string,
+    uint32_t max_distance,
+    uint16_t *words,
+    uint8_t *distances,
+    uint32_t max
+);
+
+// the most candidates slip39_word_candidates_for_strings keeps per word
+#define SLIP39_MAX_CANDIDATES 8
+
+/**
+ * the words a possibly misspelled word in a share could be
+ */
+typedef struct slip39_word_candidates_struct {
+    uint16_t words[SLIP39_MAX_CANDIDATES];      // nearest first
+    uint8_t distances[SLIP39_MAX_CANDIDATES];   // slip39_string_distance of each
+    uint8_t count;                              // 0 if nothing was close enough
+} slip39_word_candidates;
+
+/**
+ * a forgiving version of slip39_words_for_strings for scanned or
+ * hand-copied shares. Rather than giving up at the first word that is
+ * not in the wordlist, it lists the nearest words for every position. A
+ * word or an abbreviation of one is its only candidate, at distance 0.
+ *
+ * returns: the number of words in the string, which may be more than
+ *          candidates_length (only that many are stored)
+ *
+ * inputs: words_string: whitespace delimited words, in either case
+ *         max_distance: the largest slip39_string_distance to accept
+ *         candidates: location to store the candidates for each word
+ *         candidates_length: maximum number of words to store
+ */
+uint32_t slip39_word_candidates_for_strings(
+    const char *words_string,
+    uint32_t max_distance,
+    slip39_word_candidates *candidates,
+    uint32_t candidates_length
+);
+
+/**
+ * rank the corrections found by rs1024_locate_errors, most plausible
+ * first. A substitution is scored by the slip39_word_distance between the
+ * word written and the suggested one, a transposition as 0 since swapping
+ * two whole words is a common mistake. Ties keep their order.
+ *
+ * inputs: words: the share the corrections were found for
+ *         corrections: the corrections, scored and sorted in place
+ *         count: number of corrections
+ */
+void slip39_rank_corrections(
+    const uint16_t *words,
+    rs1024_correction *corrections,
+    uint32_t count
+);
+
 #endif /* ENCODING_H */
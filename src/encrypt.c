@@ -6,15 +6,11 @@
 //
 
 #include "encrypt.h"
-
-#ifdef ARDUINO
-#include "bc-crypto-base.h"
-#else
-#include <bc-crypto-base/bc-crypto-base.h>
-#endif
+#include "sha256.h"
+#include "slip39-errors.h"
 
 #include <string.h>
-#include <stdio.h>
+#include <stdlib.h>
 
 //////////////////////////////////////////////////
 // encrypt/decrypt
@@ -29,10 +25,22 @@ static const uint8_t customization[] = {
     's', 'h', 'a', 'm', 'i', 'r',
 };
 
-int32_t _get_salt(    uint16_t identifier, uint8_t *result, uint32_t result_length);
-void feistel(uint8_t forward, const uint8_t *input, uint32_t input_length, const char *passphrase,
-    uint8_t iteration_exponent, uint16_t identifier, uint8_t *output);
+struct slip39_kdf_context_struct {
+    uint32_t inner[ROUND_COUNT][SHA256_STATE_WORDS];
+    uint32_t outer[ROUND_COUNT][SHA256_STATE_WORDS];
+};
 
+// where a monitored key derivation has got to
+typedef struct kdf_progress_struct {
+    const slip39_kdf_monitor *monitor;
+    uint8_t round;          // rounds finished so far
+    uint64_t done;          // iterations done in this round
+    uint64_t total;         // iterations in this round
+} kdf_progress;
+
+int32_t _get_salt(    uint16_t identifier, uint8_t *result, uint32_t result_length);
+int feistel(uint8_t forward, const uint8_t *input, uint32_t input_length, const slip39_kdf_context *context,
+    uint8_t iteration_exponent, uint16_t identifier, uint8_t *output, const slip39_kdf_monitor *monitor);
 int32_t _get_salt(
     uint16_t identifier,
     uint8_t *result,
@@ -51,6 +59,210 @@ int32_t _get_salt(
     return 8;
 }
 
+/**
+ * compute the HMAC midstates for the key used in round i, which is the
+ * round index followed by the passphrase.
+ */
+static void prepare_round_key(
+    uint8_t i,
+    const char *passphrase,
+    uint32_t inner[SHA256_STATE_WORDS],
+    uint32_t outer[SHA256_STATE_WORDS]
+) {
+    uint32_t pass_length = (uint32_t)strlen(passphrase);
+    uint8_t key[SHA256_BLOCK_LENGTH];
+
+    if(pass_length + 1 <= SHA256_BLOCK_LENGTH) {
+        key[0] = i;
+        memcpy(key+1, passphrase, pass_length);
+        slip39_hmac_sha256_prepare(key, pass_length + 1, inner, outer);
+    } else {
+        // long keys get hashed down before use, so stream them
+        // through the hash rather than building a copy
+        slip39_sha256_ctx ctx;
+        uint32_t digest[SHA256_STATE_WORDS];
+        slip39_sha256_init(&ctx);
+        slip39_sha256_update(&ctx, &i, 1);
+        slip39_sha256_update(&ctx, (const uint8_t *) passphrase, pass_length);
+        slip39_sha256_final(&ctx, digest);
+        slip39_sha256_store(digest, key, SHA256_DIGEST_LENGTH);
+        slip39_hmac_sha256_prepare(key, SHA256_DIGEST_LENGTH, inner, outer);
+        memset(digest, 0, sizeof(digest));
+    }
+
+    memset(key, 0, sizeof(key));
+}
+
+/**
+ * the first HMAC of a PBKDF2 block, U1 = HMAC(key, salt || r || INT(block_index)),
+ * starting from precomputed HMAC midstates. The salt is passed in two
+ * pieces so callers don't have to concatenate them. This goes through the
+ * general hash since the salt can be any length, every later HMAC is a
+ * fixed size message and goes through slip39_hmac_sha256_iterate.
+ */
+static void pbkdf2_first(
+    const uint32_t inner[SHA256_STATE_WORDS],
+    const uint32_t outer[SHA256_STATE_WORDS],
+    const uint8_t *salt,
+    uint32_t salt_length,
+    const uint8_t *r,
+    uint32_t r_length,
+    uint32_t block_index,
+    uint32_t u[SHA256_STATE_WORDS]
+) {
+    slip39_sha256_ctx ctx;
+    uint8_t block[SHA256_DIGEST_LENGTH];
+    uint8_t index[4] = {
+        block_index >> 24, block_index >> 16, block_index >> 8, block_index
+    };
+
+    slip39_sha256_resume(&ctx, inner, SHA256_BLOCK_LENGTH);
+    slip39_sha256_update(&ctx, salt, salt_length);
+    slip39_sha256_update(&ctx, r, r_length);
+    slip39_sha256_update(&ctx, index, 4);
+    slip39_sha256_final(&ctx, u);
+    slip39_sha256_store(u, block, SHA256_DIGEST_LENGTH);
+    slip39_sha256_resume(&ctx, outer, SHA256_BLOCK_LENGTH);
+    slip39_sha256_update(&ctx, block, SHA256_DIGEST_LENGTH);
+    slip39_sha256_final(&ctx, u);
+
+    memset(block, 0, sizeof(block));
+}
+
+/**
+ * count iterations done, tell the monitor about them and check whether
+ * it wants us to stop
+ *
+ * returns: 0 to carry on, or ERROR_CANCELLED
+ */
+static int kdf_advance(
+    kdf_progress *progress,
+    uint64_t iterations
+) {
+    const slip39_kdf_monitor *monitor = progress->monitor;
+
+    progress->done += iterations;
+    if(monitor->progress != NULL) {
+        monitor->progress(progress->round, progress->done, progress->total, monitor->context);
+    }
+    if(monitor->cancel != NULL && __atomic_load_n(monitor->cancel, __ATOMIC_ACQUIRE)) {
+        return ERROR_CANCELLED;
+    }
+    return 0;
+}
+
+/**
+ * one output block of PBKDF2-HMAC-SHA256, starting from precomputed HMAC
+ * midstates. With a monitor the loop runs in slices of its granularity,
+ * reporting between them.
+ *
+ * dest_length must not exceed SHA256_DIGEST_LENGTH
+ *
+ * returns: 0, or ERROR_CANCELLED with nothing written to dest
+ */
+static int pbkdf2_block(
+    const uint32_t inner[SHA256_STATE_WORDS],
+    const uint32_t outer[SHA256_STATE_WORDS],
+    const uint8_t *salt,
+    uint32_t salt_length,
+    const uint8_t *r,
+    uint32_t r_length,
+    uint32_t block_index,
+    uint64_t iterations,
+    uint8_t *dest,
+    uint32_t dest_length,
+    kdf_progress *progress
+) {
+    uint32_t u[SHA256_STATE_WORDS];
+    uint32_t t[SHA256_STATE_WORDS];
+    uint32_t slice = UINT32_MAX;
+    int result = 0;
+
+    if(progress != NULL && progress->monitor->granularity > 0) {
+        slice = progress->monitor->granularity;
+    }
+
+    pbkdf2_first(inner, outer, salt, salt_length, r, r_length, block_index, u);
+    memcpy(t, u, sizeof(t));
+    if(progress != NULL) {
+        progress->done += 1;
+    }
+
+    // Uk = HMAC(key, Uk-1), T = U1 ^ U2 ^ ... ^ Uc
+    for(uint64_t remaining = iterations - 1; remaining > 0 && !result; ) {
+        uint32_t count = remaining < slice ? (uint32_t) remaining : slice;
+        slip39_hmac_sha256_iterate(inner, outer, u, t, count);
+        remaining -= count;
+        if(progress != NULL) {
+            result = kdf_advance(progress, count);
+        }
+    }
+
+    if(!result) {
+        slip39_sha256_store(t, dest, dest_length);
+    }
+
+    memset(u, 0, sizeof(u));
+    memset(t, 0, sizeof(t));
+
+    return result;
+}
+
+/**
+ * PBKDF2-HMAC-SHA256 for any output length. The Fiestel network never
+ * asks for more than one block, this is only here to keep round_function
+ * general.
+ */
+static int pbkdf2_prepared(
+    const uint32_t inner[SHA256_STATE_WORDS],
+    const uint32_t outer[SHA256_STATE_WORDS],
+    const uint8_t *salt,
+    uint32_t salt_length,
+    const uint8_t *r,
+    uint32_t r_length,
+    uint64_t iterations,
+    uint8_t *dest,
+    uint32_t dest_length,
+    kdf_progress *progress
+) {
+    int result = 0;
+    for(uint32_t b=1; dest_length > 0 && !result; ++b) {
+        uint32_t n = dest_length < SHA256_DIGEST_LENGTH ? dest_length : SHA256_DIGEST_LENGTH;
+        result = pbkdf2_block(inner, outer, salt, salt_length, r, r_length, b, iterations, dest, n, progress);
+        dest += n;
+        dest_length -= n;
+    }
+    return result;
+}
+
+static void kdf_context_init(
+    slip39_kdf_context *context,
+    const char *passphrase
+) {
+    for(uint8_t i=0; i<ROUND_COUNT; ++i) {
+        prepare_round_key(i, passphrase, context->inner[i], context->outer[i]);
+    }
+}
+
+slip39_kdf_context *slip39_kdf_context_new(
+    const char *passphrase
+) {
+    slip39_kdf_context *context = malloc(sizeof(slip39_kdf_context));
+    if(context) {
+        kdf_context_init(context, passphrase);
+    }
+    return context;
+}
+
+void slip39_kdf_context_free(
+    slip39_kdf_context *context
+) {
+    if(context) {
+        memset(context, 0, sizeof(slip39_kdf_context));
+        free(context);
+    }
+}
+
 void round_function(
     uint8_t i,
     const char *passphrase,
@@ -62,34 +274,44 @@ void round_function(
     uint8_t *dest,
     uint32_t dest_length
 ) {
-    uint32_t pass_length = (uint32_t)strlen(passphrase) + 1;
-    uint8_t pass[pass_length+2];
-    sprintf( (char *) (pass+1), "%s", passphrase);
-    pass[0] = i;
-    uint32_t iterations = BASE_ITERATION_COUNT << exp;
-    uint8_t saltr[salt_length + r_length];
+    uint32_t inner[SHA256_STATE_WORDS];
+    uint32_t outer[SHA256_STATE_WORDS];
+    uint64_t iterations = (uint64_t) BASE_ITERATION_COUNT << exp;
 
-    memcpy(saltr, salt, salt_length);
-    memcpy(saltr+salt_length, r, r_length);
+    prepare_round_key(i, passphrase, inner, outer);
+    pbkdf2_prepared(inner, outer, salt, salt_length, r, r_length, iterations, dest, dest_length, NULL);
 
-    pbkdf2_hmac_sha256(pass, pass_length,
-                       saltr, salt_length+r_length,
-                       iterations,
-                       dest, dest_length);
+    memset(inner, 0, sizeof(inner));
+    memset(outer, 0, sizeof(outer));
 }
 
-void feistel(
+/**
+ * the Fiestel network. With a monitor it reports progress and can be
+ * cancelled, in which case output is wiped.
+ *
+ * returns: 0, or ERROR_CANCELLED
+ */
+int feistel(
     uint8_t forward,
     const uint8_t *input,
     uint32_t input_length,
-    const char *passphrase,
+    const slip39_kdf_context *context,
     uint8_t iteration_exponent,
     uint16_t identifier,
-    uint8_t *output
+    uint8_t *output,
+    const slip39_kdf_monitor *monitor
 ) {
     uint32_t half_length = input_length / 2;
     uint8_t *l, *r, *t, f[half_length];
     uint8_t salt[8];
+    uint64_t iterations = (uint64_t) BASE_ITERATION_COUNT << iteration_exponent;
+    kdf_progress progress;
+    int result = 0;
+
+    if(monitor != NULL) {
+        progress.monitor = monitor;
+        progress.total = iterations * ((half_length + SHA256_DIGEST_LENGTH - 1) / SHA256_DIGEST_LENGTH);
+    }
 
     memcpy(output, input+half_length, half_length);
     memcpy(output + half_length, input, half_length);
@@ -99,14 +321,22 @@ void feistel(
 
     _get_salt(identifier, salt, 8);
 
-    for(uint8_t i=0; i<ROUND_COUNT; ++i) {
+    for(uint8_t i=0; i<ROUND_COUNT && !result; ++i) {
         uint8_t index;
         if(forward) {
             index = i;
         } else {
             index = ROUND_COUNT-1-i;
         }
-        round_function(index, passphrase, iteration_exponent, salt, 8, r, half_length, f, half_length);
+        if(monitor != NULL) {
+            progress.round = i;
+            progress.done = 0;
+        }
+        result = pbkdf2_prepared(context->inner[index], context->outer[index],
+            salt, 8, r, half_length, iterations, f, half_length, monitor != NULL ? &progress : NULL);
+        if(result) {
+            break;
+        }
         t = l;
         l = r;
         r = t;
@@ -114,6 +344,13 @@ void feistel(
             r[j] = r[j] ^ f[j];
         }
     }
+
+    if(result) {
+        memset(output, 0, input_length);
+    }
+    memset(f, 0, sizeof(f));
+
+    return result;
 }
 
 void slip39_encrypt(
@@ -124,7 +361,10 @@ void slip39_encrypt(
     uint16_t identifier,
     uint8_t *output
 ) {
-    feistel(1, input, input_length, passphrase, iteration_exponent, identifier, output);
+    slip39_kdf_context context;
+    kdf_context_init(&context, passphrase);
+    feistel(1, input, input_length, &context, iteration_exponent, identifier, output, NULL);
+    memset(&context, 0, sizeof(context));
 }
 
 void slip39_decrypt(
@@ -135,5 +375,163 @@ void slip39_decrypt(
     uint16_t identifier,
     uint8_t *output
 ) {
-    feistel(0, input, input_length, passphrase, iteration_exponent, identifier, output);
+    slip39_kdf_context context;
+    kdf_context_init(&context, passphrase);
+    feistel(0, input, input_length, &context, iteration_exponent, identifier, output, NULL);
+    memset(&context, 0, sizeof(context));
+}
+
+int slip39_encrypt_monitored(
+    const uint8_t *input,
+    uint32_t input_length,
+    const char *passphrase,
+    uint8_t iteration_exponent,
+    uint16_t identifier,
+    uint8_t *output,
+    const slip39_kdf_monitor *monitor
+) {
+    slip39_kdf_context context;
+    kdf_context_init(&context, passphrase);
+    int result = feistel(1, input, input_length, &context, iteration_exponent, identifier, output, monitor);
+    memset(&context, 0, sizeof(context));
+    return result;
+}
+
+int slip39_decrypt_monitored(
+    const uint8_t *input,
+    uint32_t input_length,
+    const char *passphrase,
+    uint8_t iteration_exponent,
+    uint16_t identifier,
+    uint8_t *output,
+    const slip39_kdf_monitor *monitor
+) {
+    slip39_kdf_context context;
+    kdf_context_init(&context, passphrase);
+    int result = feistel(0, input, input_length, &context, iteration_exponent, identifier, output, monitor);
+    memset(&context, 0, sizeof(context));
+    return result;
+}
+
+/**
+ * run the Fiestel network for a batch of requests at once. Round i of
+ * every request is independent of the others, so the PBKDF2 chains for a
+ * round run side by side through slip39_hmac_sha256_iterate_many. Each
+ * half of an input takes a single PBKDF2 block, so inputs are limited to
+ * 64 bytes.
+ */
+static int feistel_many(
+    uint8_t forward,
+    const slip39_crypt_request *requests,
+    uint32_t count
+) {
+    slip39_kdf_context contexts[SHA256_MAX_LANES];
+    slip39_hmac_sha256_lane lanes[SHA256_MAX_LANES];
+    uint64_t remaining[SHA256_MAX_LANES];
+    uint8_t salt[8];
+
+    for(uint32_t l=0; l<count; ++l) {
+        if(requests[l].input_length % 2 == 1 || requests[l].input_length > 2 * SHA256_DIGEST_LENGTH) {
+            return ERROR_INVALID_SECRET_LENGTH;
+        }
+        if(requests[l].iteration_exponent > MAX_ITERATION_EXPONENT) {
+            return ERROR_INVALID_ITERATION_EXPONENT;
+        }
+    }
+
+    while(count > 0) {
+        uint32_t n = count < SHA256_MAX_LANES ? count : SHA256_MAX_LANES;
+
+        for(uint32_t l=0; l<n; ++l) {
+            const slip39_crypt_request *request = &requests[l];
+            uint32_t half_length = request->input_length / 2;
+            kdf_context_init(&contexts[l], request->passphrase);
+            memcpy(request->output, request->input+half_length, half_length);
+            memcpy(request->output + half_length, request->input, half_length);
+        }
+
+        for(uint8_t i=0; i<ROUND_COUNT; ++i) {
+            uint8_t index = forward ? i : ROUND_COUNT-1-i;
+
+            // the first HMAC of each chain, then all of them together
+            for(uint32_t l=0; l<n; ++l) {
+                const slip39_crypt_request *request = &requests[l];
+                uint32_t half_length = request->input_length / 2;
+                uint8_t *r = (i % 2) ? request->output + half_length : request->output;
+                _get_salt(request->identifier, salt, 8);
+
+                lanes[l].inner = contexts[l].inner[index];
+                lanes[l].outer = contexts[l].outer[index];
+                remaining[l] = ((uint64_t) BASE_ITERATION_COUNT << request->iteration_exponent) - 1;
+                pbkdf2_first(lanes[l].inner, lanes[l].outer, salt, 8, r, half_length, 1, lanes[l].u);
+                memcpy(lanes[l].t, lanes[l].u, sizeof(lanes[l].t));
+            }
+
+            // the largest exponents need more iterations than a lane counts
+            for(uint8_t more = 1; more; ) {
+                more = 0;
+                for(uint32_t l=0; l<n; ++l) {
+                    lanes[l].count = remaining[l] < UINT32_MAX ? (uint32_t) remaining[l] : UINT32_MAX;
+                    remaining[l] -= lanes[l].count;
+                    more |= remaining[l] > 0;
+                }
+                slip39_hmac_sha256_iterate_many(lanes, n);
+            }
+
+            for(uint32_t l=0; l<n; ++l) {
+                const slip39_crypt_request *request = &requests[l];
+                uint32_t half_length = request->input_length / 2;
+                uint8_t *dest = (i % 2) ? request->output : request->output + half_length;
+                uint8_t f[SHA256_DIGEST_LENGTH];
+                slip39_sha256_store(lanes[l].t, f, half_length);
+                for(uint32_t j=0; j<half_length; ++j) {
+                    dest[j] ^= f[j];
+                }
+                memset(f, 0, sizeof(f));
+            }
+        }
+
+        requests += n;
+        count -= n;
+    }
+
+    memset(contexts, 0, sizeof(contexts));
+    memset(lanes, 0, sizeof(lanes));
+    return 0;
+}
+
+int slip39_encrypt_many(
+    const slip39_crypt_request *requests,
+    uint32_t count
+) {
+    return feistel_many(1, requests, count);
+}
+
+int slip39_decrypt_many(
+    const slip39_crypt_request *requests,
+    uint32_t count
+) {
+    return feistel_many(0, requests, count);
+}
+
+void slip39_encrypt_ctx(
+    const uint8_t *input,
+    uint32_t input_length,
+    const slip39_kdf_context *context,
+    uint8_t iteration_exponent,
+    uint16_t identifier,
+    uint8_t *output
+) {
+    feistel(1, input, input_length, context, iteration_exponent, identifier, output, NULL);
+}
+
+void slip39_decrypt_ctx(
+    const uint8_t *input,
+    uint32_t input_length,
+    const slip39_kdf_context *context,
+    uint8_t iteration_exponent,
+    uint16_t identifier,
+    uint8_t *output
+) {
+    feistel(0, input, input_length, context, iteration_exponent, identifier, output, NULL);
 }
@@ -13,6 +13,35 @@
 #define BASE_ITERATION_COUNT 2500
 #define ROUND_COUNT 4
 
+// the iteration exponent is stored in 5 bits of a share
+#define MAX_ITERATION_EXPONENT 31
+
+/**
+ * an opaque structure holding the HMAC key schedule for every round of the
+ * Fiestel network for one passphrase. Building it once lets a passphrase be
+ * used against many secrets without redoing the key setup each time.
+ */
+typedef struct slip39_kdf_context_struct slip39_kdf_context;
+
+/**
+ * create a key derivation context for a passphrase
+ *
+ * returns: a context that must be released with slip39_kdf_context_free,
+ *          or NULL if memory could not be allocated
+ *
+ * inputs: passphrase: null terminated ascii string
+ */
+slip39_kdf_context *slip39_kdf_context_new(
+    const char *passphrase
+);
+
+/**
+ * wipe and release a key derivation context
+ */
+void slip39_kdf_context_free(
+    slip39_kdf_context *context
+);
+
 /**
  * this is the round function described in the slip39 spec for the Fiestel network
  * it uses to encrypt/decrypt secrets with a passphrase
@@ -77,4 +106,142 @@ void slip39_decrypt(
     uint8_t *output
 );
 
+/**
+ * reports on the progress of a key derivation
+ *
+ * inputs: round: the round of the Fiestel network being worked on, counting
+ *                from 0 in the order the rounds are run
+ *         iterations_done: PBKDF2 iterations done so far in this round
+ *         iterations_total: PBKDF2 iterations in each round
+ *         context: the context of the monitor
+ */
+typedef void (*slip39_kdf_progress_fn)(
+    uint8_t round,
+    uint64_t iterations_done,
+    uint64_t iterations_total,
+    void *context
+);
+
+/**
+ * watches over a long key derivation: progress is reported, and the
+ * cancel flag checked, every granularity iterations of the PBKDF2 loop
+ */
+typedef struct slip39_kdf_monitor_struct {
+    uint32_t granularity;               // 0 to report only once per round
+    slip39_kdf_progress_fn progress;    // may be NULL
+    void *context;                      // passed through to progress
+    const uint8_t *cancel;              // may be NULL; set non-zero from any thread to stop
+} slip39_kdf_monitor;
+
+/**
+ * same as slip39_encrypt, but reports progress to a monitor and can be
+ * cancelled through it. A cancelled encryption leaves output zeroed.
+ *
+ * returns: 0 on success, or ERROR_CANCELLED
+ */
+int slip39_encrypt_monitored(
+    const uint8_t *input,
+    uint32_t input_length,
+    const char *passphrase,
+    uint8_t iteration_exponent,
+    uint16_t identifier,
+    uint8_t *output,
+    const slip39_kdf_monitor *monitor
+);
+
+/**
+ * same as slip39_decrypt, but reports progress to a monitor and can be
+ * cancelled through it. A cancelled decryption leaves output zeroed.
+ *
+ * returns: 0 on success, or ERROR_CANCELLED
+ */
+int slip39_decrypt_monitored(
+    const uint8_t *input,
+    uint32_t input_length,
+    const char *passphrase,
+    uint8_t iteration_exponent,
+    uint16_t identifier,
+    uint8_t *output,
+    const slip39_kdf_monitor *monitor
+);
+
+/**
+ * same as slip39_encrypt, but uses a key derivation context built
+ * with slip39_kdf_context_new instead of a passphrase
+ */
+void slip39_encrypt_ctx(
+    const uint8_t *input,
+    uint32_t input_length,
+    const slip39_kdf_context *context,
+    uint8_t iteration_exponent,
+    uint16_t identifier,
+    uint8_t *output
+);
+
+/**
+ * same as slip39_decrypt, but uses a key derivation context built
+ * with slip39_kdf_context_new instead of a passphrase
+ */
+void slip39_decrypt_ctx(
+    const uint8_t *input,
+    uint32_t input_length,
+    const slip39_kdf_context *context,
+    uint8_t iteration_exponent,
+    uint16_t identifier,
+    uint8_t *output
+);
+
+/**
+ * one secret to encrypt or decrypt as part of a batch
+ *
+ * fields:  input: array of bytes to encrypt or decrypt, at most 64 bytes
+ *          input_length: length of input array
+ *          passphrase: null terminated ascii string
+ *          iteration_exponent: exponent for the number of pbkd rounds to use
+ *          identifier: identifier for the shard set (used as part of the salt)
+ *          output: memory location to write output to (same length as the input)
+ */
+typedef struct slip39_crypt_request_struct {
+    const uint8_t *input;
+    uint32_t input_length;
+    const char *passphrase;
+    uint8_t iteration_exponent;
+    uint16_t identifier;
+    uint8_t *output;
+} slip39_crypt_request;
+
+/**
+ * encrypts a batch of inputs, each exactly as slip39_encrypt would. The
+ * key derivations of the batch run side by side in vector lanes where the
+ * processor supports it, so requests that share an iteration exponent
+ * are best submitted together.
+ *
+ * returns: 0, or a negative error code if any request is invalid, in
+ *          which case none are processed: ERROR_INVALID_SECRET_LENGTH for
+ *          an odd input length or one over 64 bytes,
+ *          ERROR_INVALID_ITERATION_EXPONENT for an exponent over
+ *          MAX_ITERATION_EXPONENT
+ *
+ * inputs:  requests: array of requests
+ *          count: number of requests
+ */
+int slip39_encrypt_many(
+    const slip39_crypt_request *requests,
+    uint32_t count
+);
+
+/**
+ * decrypts a batch of inputs, each exactly as slip39_decrypt would.
+ * See slip39_encrypt_many.
+ *
+ * returns: as slip39_encrypt_many
+ *
+ * inputs:  requests: array of requests
+ *          count: number of requests
+ */
+int slip39_decrypt_many(
+    const slip39_crypt_request *requests,
+    uint32_t count
+);
+
 #endif /* ENCRYPT_H */
@@ -0,0 +1,391 @@
+//
+//  job.c
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#include "job.h"
+#include "parallel.h"
+#include "sha256.h"
+#include "slip39-errors.h"
+
+#include <string.h>
+
+#ifndef ARDUINO
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+#endif
+
+#define JOB_PATH_LENGTH 4096
+
+uint64_t slip39_job_chunk_count(
+    uint64_t total,
+    uint64_t chunk_size
+) {
+    if(chunk_size == 0) {
+        return 0;
+    }
+    return total / chunk_size + (total % chunk_size ? 1 : 0);
+}
+
+#ifdef ARDUINO
+
+int slip39_job_run(
+    const slip39_ems *ems,
+    const slip39_passphrase_source *source,
+    const slip39_job *job,
+    slip39_verify_fn verify,
+    void *verify_context,
+    const slip39_search_options *options,
+    slip39_search_result *result
+) {
+    // there is no file system to coordinate through
+    memset(result, 0, sizeof(slip39_search_result));
+    return ERROR_JOB_IO;
+}
+
+#else
+
+static void hash_string(slip39_sha256_ctx *ctx, const char *s) {
+    // the nul keeps "ab" "c" apart from "a" "bc"
+    slip39_sha256_update(ctx, (const uint8_t *) s, strlen(s) + 1);
+}
+
+/**
+ * describe a search well enough that processes only join in on the same
+ * one: its size, its chunking, the share set, and a hash of the ems and
+ * of the candidates. A callback source is known only by its count.
+ */
+static void job_fingerprint(
+    char *fingerprint,
+    size_t fingerprint_length,
+    const slip39_ems *ems,
+    const slip39_passphrase_source *source,
+    uint64_t total,
+    uint64_t chunk_size
+) {
+    slip39_sha256_ctx ctx;
+    uint32_t digest[SHA256_STATE_WORDS];
+    uint32_t ems_length = slip39_ems_length(ems);
+    uint8_t header[5] = { source->kind, ems_length >> 24, ems_length >> 16, ems_length >> 8, ems_length };
+
+    slip39_sha256_init(&ctx);
+    slip39_sha256_update(&ctx, header, sizeof(header));
+    slip39_sha256_update(&ctx, slip39_ems_value(ems), ems_length);
+    if(source->kind == SLIP39_SOURCE_DICTIONARY) {
+        for(uint32_t i=0; i<source->word_count; ++i) {
+            hash_string(&ctx, source->words[i]);
+        }
+    } else if(source->kind == SLIP39_SOURCE_MASK) {
+        hash_string(&ctx, source->mask);
+    }
+    for(uint32_t i=0; source->rules != NULL && i<source->rule_count; ++i) {
+        hash_string(&ctx, source->rules[i]);
+    }
+    slip39_sha256_final(&ctx, digest);
+
+    snprintf(fingerprint, fingerprint_length, "%" PRIu64 " %" PRIu64 " %" PRIu64 " %08" PRIx32 "%08" PRIx32,
+        total, chunk_size, ((uint64_t) slip39_ems_identifier(ems) << 8) | slip39_ems_iteration_exponent(ems), digest[0], digest[1]);
+    memset(&ctx, 0, sizeof(ctx));
+}
+
+static int job_path(char *path, const slip39_job *job, const char *name) {
+    int n = snprintf(path, JOB_PATH_LENGTH, "%s/%s", job->directory, name);
+    return n > 0 && n < JOB_PATH_LENGTH ? 0 : ERROR_JOB_IO;
+}
+
+static int chunk_path(char *path, const slip39_job *job, uint64_t chunk, const char *suffix) {
+    char name[64];
+    snprintf(name, sizeof(name), "chunk-%" PRIu64 ".%s", chunk, suffix);
+    return job_path(path, job, name);
+}
+
+static uint8_t exists(const char *path) {
+    return access(path, F_OK) == 0;
+}
+
+/**
+ * create a file only if it does not exist yet, atomically, with the given
+ * contents
+ *
+ * returns: 1 if it was created, 0 if it was already there, or ERROR_JOB_IO
+ */
+static int create_exclusive(const char *path, const char *contents) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if(fd < 0) {
+        return errno == EEXIST ? 0 : ERROR_JOB_IO;
+    }
+    size_t length = strlen(contents);
+    int error = write(fd, contents, length) != (ssize_t) length;
+    error |= fsync(fd) != 0;
+    error |= close(fd) != 0;
+    return error ? ERROR_JOB_IO : 1;
+}
+
+// read a small file into buffer, returns 0 if it does not exist
+static int read_small(const char *path, char *buffer, size_t buffer_length) {
+    FILE *file = fopen(path, "r");
+    if(file == NULL) {
+        return errno == ENOENT ? 0 : ERROR_JOB_IO;
+    }
+    size_t n = fread(buffer, 1, buffer_length - 1, file);
+    int error = ferror(file);
+    fclose(file);
+    buffer[n] = 0;
+    return error ? ERROR_JOB_IO : 1;
+}
+
+// replace the checkpoint all at once, so a crash leaves the old one or the new one
+static int write_checkpoint(const slip39_job *job, const char *fingerprint, uint64_t chunk, uint64_t next) {
+    char temporary[JOB_PATH_LENGTH];
+    int n = snprintf(temporary, sizeof(temporary), "%s.tmp", job->checkpoint);
+    if(n <= 0 || n >= (int) sizeof(temporary)) {
+        return ERROR_JOB_IO;
+    }
+
+    FILE *file = fopen(temporary, "w");
+    if(file == NULL) {
+        return ERROR_JOB_IO;
+    }
+    int error = fprintf(file, "%s %" PRIu64 " %" PRIu64 "\n", fingerprint, chunk, next) < 0;
+    error |= fflush(file) != 0;
+    error |= fsync(fileno(file)) != 0;
+    error |= fclose(file) != 0;
+    if(error || rename(temporary, job->checkpoint) != 0) {
+        unlink(temporary);
+        return ERROR_JOB_IO;
+    }
+    return 0;
+}
+
+/**
+ * load the checkpoint, if any
+ *
+ * returns: 1 if there is one, 0 if not, or a negative error code
+ */
+static int read_checkpoint(const slip39_job *job, const char *fingerprint, uint64_t *chunk, uint64_t *next) {
+    char contents[256];
+
+    int result = read_small(job->checkpoint, contents, sizeof(contents));
+    if(result <= 0) {
+        return result;
+    }
+
+    // the fingerprint, then the chunk and where to carry on from
+    size_t length = strlen(fingerprint);
+    if(strncmp(contents, fingerprint, length) != 0 || contents[length] != ' ') {
+        return ERROR_JOB_MISMATCH;
+    }
+    if(sscanf(contents + length, " %" SCNu64 " %" SCNu64, chunk, next) != 2) {
+        return ERROR_JOB_IO;
+    }
+    return 1;
+}
+
+// record what is being searched in the directory, or check it matches
+static int check_job_file(const slip39_job *job, const char *fingerprint) {
+    char path[JOB_PATH_LENGTH];
+    char contents[256];
+    char expected[256];
+
+    int result = job_path(path, job, "job");
+    if(result) {
+        return result;
+    }
+
+    snprintf(expected, sizeof(expected), "%s\n", fingerprint);
+    result = create_exclusive(path, expected);
+    if(result != 0) {
+        return result < 0 ? result : 0;
+    }
+
+    // somebody else got there first, it has to be the same job
+    result = read_small(path, contents, sizeof(contents));
+    if(result < 0) {
+        return result;
+    }
+    return strcmp(contents, expected) == 0 ? 0 : ERROR_JOB_MISMATCH;
+}
+
+/**
+ * claim a chunk for this process. When resuming from a checkpoint, a
+ * claim this process made before it was stopped is also its own.
+ *
+ * returns: 1 if the chunk is this process's to work on, 0 if it isn't,
+ *          or ERROR_JOB_IO
+ */
+static int claim_chunk(const slip39_job *job, uint64_t chunk, uint8_t resume) {
+    char path[JOB_PATH_LENGTH];
+    char contents[256];
+    char expected[256];
+
+    if(chunk_path(path, job, chunk, "done")) {
+        return ERROR_JOB_IO;
+    }
+    if(exists(path)) {
+        return 0;
+    }
+
+    chunk_path(path, job, chunk, "claim");
+    snprintf(expected, sizeof(expected), "%s\n", job->worker);
+    int result = create_exclusive(path, expected);
+    if(result != 0 || !resume) {
+        return result;
+    }
+
+    result = read_small(path, contents, sizeof(contents));
+    if(result < 0) {
+        return result;
+    }
+    return strcmp(contents, expected) == 0;
+}
+
+static int finish_chunk(const slip39_job *job, uint64_t chunk) {
+    char path[JOB_PATH_LENGTH];
+    int result = chunk_path(path, job, chunk, "done");
+    if(!result) {
+        result = create_exclusive(path, "");
+    }
+    return result < 0 ? result : 0;
+}
+
+int slip39_job_run(
+    const slip39_ems *ems,
+    const slip39_passphrase_source *source,
+    const slip39_job *job,
+    slip39_verify_fn verify,
+    void *verify_context,
+    const slip39_search_options *options,
+    slip39_search_result *result
+) {
+    char fingerprint[128];
+    char found_path[JOB_PATH_LENGTH];
+    uint64_t tried = 0;
+    double seconds = 0;
+    uint64_t chunk = 0, next = 0;
+    int error;
+
+    memset(result, 0, sizeof(slip39_search_result));
+
+    int64_t total = slip39_source_count(source);
+    if(total < 0) {
+        return (int) total;
+    }
+    if(job->chunk_size == 0) {
+        return ERROR_JOB_MISMATCH;
+    }
+    if(job->worker == NULL || job->worker[0] == 0) {
+        return ERROR_INVALID_WORKER;
+    }
+
+    uint64_t chunk_count = slip39_job_chunk_count(total, job->chunk_size);
+    uint64_t last_chunk = job->last_chunk == 0 || job->last_chunk > chunk_count ? chunk_count : job->last_chunk;
+    // by default each thread fills its vector lanes once between
+    // checkpoints, so a restart repeats no more than one batch
+    uint64_t interval = job->checkpoint_interval;
+    if(interval == 0) {
+        uint32_t threads = options != NULL && options->threads > 0 ? options->threads : slip39_processor_count();
+        interval = (uint64_t) slip39_sha256_lane_width() * threads;
+    }
+
+    job_fingerprint(fingerprint, sizeof(fingerprint), ems, source, total, job->chunk_size);
+
+    if((error = check_job_file(job, fingerprint)) || (error = job_path(found_path, job, "found"))) {
+        return error;
+    }
+
+    // pick up where the checkpoint left off, if the chunk is still ours.
+    // A process that is starting again may also have been killed between
+    // claiming a chunk and recording it, so its own claims are its to take
+    // back; a fresh start records that it has begun before claiming
+    // anything, so the same holds for its very first claim.
+    int resuming = read_checkpoint(job, fingerprint, &chunk, &next);
+    if(resuming < 0) {
+        return resuming;
+    }
+    int working = 0;
+    if(resuming) {
+        working = claim_chunk(job, chunk, 1);
+        if(working < 0) {
+            return working;
+        }
+    } else if((error = write_checkpoint(job, fingerprint, job->first_chunk, job->first_chunk * job->chunk_size))) {
+        return error;
+    }
+
+    uint64_t candidate_chunk = job->first_chunk;
+
+    for(;;) {
+        if(exists(found_path)) {
+            break;
+        }
+
+        if(!working) {
+            while(candidate_chunk < last_chunk) {
+                chunk = candidate_chunk++;
+                working = claim_chunk(job, chunk, resuming);
+                if(working) {
+                    break;
+                }
+            }
+            if(working < 0) {
+                return working;
+            }
+            if(!working) {
+                break;
+            }
+            next = chunk * job->chunk_size;
+            if((error = write_checkpoint(job, fingerprint, chunk, next))) {
+                return error;
+            }
+        }
+
+        uint64_t chunk_end = (chunk + 1) * job->chunk_size;
+        if(chunk_end > (uint64_t) total) {
+            chunk_end = total;
+        }
+
+        while(next < chunk_end) {
+            uint64_t slice_end = chunk_end - next > interval ? next + interval : chunk_end;
+
+            int found = slip39_search_ems_range(ems, source, next, slice_end, verify, verify_context, options, result);
+            tried += result->tried;
+            seconds += result->seconds;
+
+            if(found == 1) {
+                create_exclusive(found_path, "");
+                finish_chunk(job, chunk);
+                unlink(job->checkpoint);
+            }
+            if(found != 0) {
+                result->tried = tried;
+                result->seconds = seconds;
+                result->rate = seconds > 0 ? tried / seconds : 0;
+                return found;
+            }
+
+            next = slice_end;
+            if((error = write_checkpoint(job, fingerprint, chunk, next))) {
+                return error;
+            }
+        }
+
+        if((error = finish_chunk(job, chunk))) {
+            return error;
+        }
+        working = 0;
+    }
+
+    unlink(job->checkpoint);
+
+    result->tried = tried;
+    result->seconds = seconds;
+    result->rate = seconds > 0 ? tried / seconds : 0;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,82 @@
+//
+//  job.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#ifndef JOB_H
+#define JOB_H
+
+#include <stdint.h>
+#include "search.h"
+
+/**
+ * a passphrase search split into numbered chunks of consecutive
+ * candidates, so that it can be shared between processes on different
+ * machines and survive being stopped.
+ *
+ * The processes coordinate through a shared directory. A process claims a
+ * chunk by creating chunk-N.claim there, which only one of them can do,
+ * and marks it finished with chunk-N.done. The first process to find the
+ * passphrase creates found, and the others stop claiming chunks when they
+ * see it. The directory also records the size of the search and of its
+ * chunks and a hash of the ems and of the candidates, so a process started
+ * with different settings is turned away.
+ *
+ * Every process needs a worker name of its own that stays the same when
+ * it is started again, such as host:slot. A claim counts for the process
+ * that created it, and a claim left by an earlier run is taken back only
+ * by a process of the same name starting again from its checkpoint, so
+ * two processes sharing a name could both work on it.
+ *
+ * Each process also keeps a checkpoint file of its own, recording the
+ * chunk it is working on and how far it has got. It is rewritten when a
+ * chunk is claimed and every checkpoint_interval candidates, by default
+ * once each thread has filled its vector lanes, so a process that is
+ * killed and started again repeats at most one batch per thread. A larger
+ * interval saves writes at the cost of repeating more work.
+ */
+typedef struct slip39_job_struct {
+    const char *directory;          // shared by every process of the job
+    const char *checkpoint;         // this process's checkpoint file
+    const char *worker;             // unique name of this process, written into its claims
+    uint64_t chunk_size;            // candidates per chunk
+    uint64_t first_chunk;           // the chunks this process may claim,
+    uint64_t last_chunk;            //   up to (not including) last_chunk, 0 for all
+    uint64_t checkpoint_interval;   // candidates between checkpoints, 0 for a
+                                    //   batch of slip39_sha256_lane_width per thread
+} slip39_job;
+
+/**
+ * returns: the number of chunks a search of total candidates splits into
+ */
+uint64_t slip39_job_chunk_count(
+    uint64_t total,
+    uint64_t chunk_size
+);
+
+/**
+ * work on a job until the passphrase is found or there are no chunks left
+ * for this process to claim, resuming from the checkpoint if there is one.
+ * Otherwise as slip39_search_ems; the statistics in result cover this
+ * call only.
+ *
+ * returns: 1 if this process found the passphrase, 0 if there is nothing
+ *          left for it to do, or a negative error code: ERROR_CANCELLED,
+ *          ERROR_JOB_MISMATCH if the directory or checkpoint belong to a
+ *          different search, ERROR_INVALID_WORKER if the job has no worker
+ *          name, ERROR_JOB_IO if a file could not be read or
+ *          written, or any error slip39_search_ems returns
+ */
+int slip39_job_run(
+    const slip39_ems *ems,
+    const slip39_passphrase_source *source,
+    const slip39_job *job,
+    slip39_verify_fn verify,
+    void *verify_context,
+    const slip39_search_options *options,
+    slip39_search_result *result
+);
+
+#endif /* JOB_H */
@@ -18,8 +18,16 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+struct slip39_ems_struct {
+    uint8_t value[32];
+    uint32_t length;
+    uint16_t identifier;
+    uint8_t iteration_exponent;
+};
+
 //////////////////////////////////////////////////
 // encode mnemonic
 int encode_mnemonic(
@@ -50,19 +58,11 @@ int encode_mnemonic(
 
 //////////////////////////////////////////////////
 // decode mnemonic
-int decode_mnemonic(
+// the group and member fields of the four metadata words
+static int decode_metadata(
     const uint16_t *mnemonic,
-    uint32_t mnemonic_length,
     slip39_shard *shard
 ) {
-    if(mnemonic_length < MIN_MNEMONIC_LENGTH_WORDS) {
-        return ERROR_NOT_ENOUGH_MNEMONIC_WORDS;
-    }
-
-    if( !rs1024_verify_checksum(mnemonic, mnemonic_length) ) {
-        return ERROR_INVALID_MNEMONIC_CHECKSUM;
-    }
-
     uint8_t group_threshold = ((mnemonic[2] >> 2) & 15) +1;
     uint8_t group_count = (((mnemonic[2]&3) << 2) | ((mnemonic[3]>>8)&3)) +1;
 
@@ -77,11 +77,12 @@ int decode_mnemonic(
     shard->group_count = group_count;
     shard->member_index = (mnemonic[3]>>4) & 15;
     shard->member_threshold = (mnemonic[3]&15) + 1;
-    int32_t result = slip39_data_for_words(mnemonic+4, mnemonic_length - 7, shard->value, 32);
-    if(result < 0) {
-        return result;
-    }
-    shard->value_length = result;
+    return 0;
+}
+
+static int check_value_length(
+    const slip39_shard *shard
+) {
     if(shard->value_length < MIN_STRENGTH_BYTES) {
         return ERROR_SECRET_TOO_SHORT;
     }
@@ -91,6 +92,80 @@ int decode_mnemonic(
     return shard->value_length;
 }
 
+int decode_mnemonic(
+    const uint16_t *mnemonic,
+    uint32_t mnemonic_length,
+    slip39_shard *shard
+) {
+    if(mnemonic_length < MIN_MNEMONIC_LENGTH_WORDS) {
+        return ERROR_NOT_ENOUGH_MNEMONIC_WORDS;
+    }
+
+    if( !rs1024_verify_checksum(mnemonic, mnemonic_length) ) {
+        return ERROR_INVALID_MNEMONIC_CHECKSUM;
+    }
+
+    int result = decode_metadata(mnemonic, shard);
+    if(result < 0) {
+        return result;
+    }
+    result = slip39_data_for_words(mnemonic+4, mnemonic_length - 7, shard->value, 32);
+    if(result < 0) {
+        return result;
+    }
+    shard->value_length = result;
+    return check_value_length(shard);
+}
+
+int decode_packed_mnemonic(
+    const uint8_t *packed,
+    uint32_t mnemonic_length,
+    slip39_shard *shard
+) {
+    if(mnemonic_length < MIN_MNEMONIC_LENGTH_WORDS) {
+        return ERROR_NOT_ENOUGH_MNEMONIC_WORDS;
+    }
+
+    if( !rs1024_verify_checksum_packed(packed, mnemonic_length) ) {
+        return ERROR_INVALID_MNEMONIC_CHECKSUM;
+    }
+
+    // the four metadata words are exactly the first five bytes
+    uint16_t metadata[4];
+    slip39_unpack_words(packed, 4, metadata, 4);
+    int result = decode_metadata(metadata, shard);
+    if(result < 0) {
+        return result;
+    }
+
+    // the value words start on a byte boundary, so the value can be
+    // shifted out of the packed bytes as slip39_data_for_words would
+    // decode it: two bits of padding for each of the first
+    // value_words % 4 words, or a zero top byte dropped when there is an
+    // odd number of whole groups
+    const uint8_t *value = packed + 5;
+    uint32_t value_words = mnemonic_length - 7;
+    uint32_t length = slip39_byte_count_for_words(value_words);
+    uint32_t skip = 2 * (value_words % 4);
+    if(skip > 0 && (value[0] >> (8 - skip))) {
+        return ERROR_INVALID_PADDING;
+    }
+    if(length > 32) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+    if(skip == 0 && (value_words & 4) && value[0] == 0) {
+        skip = 8;
+        length -= 1;
+    }
+    for(uint32_t i=0; i<length; ++i) {
+        uint32_t bit = skip + 8 * i;
+        uint32_t shift = bit & 7;
+        const uint8_t *p = value + (bit >> 3);
+        shard->value[i] = shift ? (p[0] << shift | p[1] >> (8 - shift)) : p[0];
+    }
+    shard->value_length = length;
+    return check_value_length(shard);
+}
 
 void print_hex(
     const uint8_t *buffer,
@@ -156,6 +231,77 @@ int count_shards(
     return total_shards;
 }
 
+//////////////////////////////////////////////////
+// split an encrypted master secret into shards, the second half of
+// generate_shards. The group policy must already have been checked, and
+// shards must have room for all of them.
+//
+static int split_ems(
+    uint8_t group_threshold,
+    const group_descriptor *groups,
+    uint8_t groups_length,
+    const uint8_t *ems,
+    uint32_t ems_length,
+    uint16_t identifier,
+    uint8_t iteration_exponent,
+    slip39_shard *shards,
+    void* ctx,
+    void (*random_generator)(uint8_t *, size_t, void*),
+    const slip39_kdf_monitor *monitor
+) {
+    uint8_t group_shares[ems_length * groups_length];
+
+    split_secret(group_threshold, groups_length, ems, ems_length, group_shares, ctx, random_generator);
+
+    uint8_t *group_share = group_shares;
+
+    unsigned int shard_count = 0;
+    slip39_shard *shard = &shards[shard_count];
+
+    int error = 0;
+
+    for(uint8_t i=0; !error && i<groups_length; ++i, group_share += ems_length) {
+        uint8_t member_shares[ems_length *groups[i].count];
+        split_secret(groups[i].threshold, groups[i].count, group_share, ems_length, member_shares, ctx, random_generator);
+
+        uint8_t *value = member_shares;
+        for(uint8_t j=0; !error && j< groups[i].count; ++j, value += ems_length) {
+            shard = &shards[shard_count];
+
+            shard->identifier = identifier;
+            shard->iteration_exponent = iteration_exponent;
+            shard->group_threshold = group_threshold;
+            shard->group_count = groups_length;
+            shard->value_length = ems_length;
+            shard->group_index = i;
+            shard->member_threshold = groups[i].threshold;
+            shard->member_index = j;
+            memset(shard->value, 0, 32);
+            memcpy(shard->value, value, ems_length);
+
+            if(groups[i].passwords && groups[i].passwords[j]) {
+                error = encrypt_shard_monitored(shard, groups[i].passwords[j], monitor);
+            }
+
+            shard_count++;
+        }
+
+        // clean up
+        memset(member_shares, 0, sizeof(member_shares));
+    }
+
+    // clean up stack
+    memset(group_shares, 0, sizeof(group_shares));
+
+    if(error) {
+        memset(shards, 0, shard_count * sizeof(slip39_shard));
+        return error;
+    }
+
+    // return the number of shards generated
+    return shard_count;
+}
+
 //////////////////////////////////////////////////
 // generate shards
 //
@@ -170,7 +316,8 @@ int generate_shards(
     slip39_shard *shards,
     uint16_t shards_size,
     void* ctx,
-    void (*random_generator)(uint8_t *, size_t, void*)
+    void (*random_generator)(uint8_t *, size_t, void*),
+    const slip39_kdf_monitor *monitor
 ) {
 
     if(master_secret_length < MIN_STRENGTH_BYTES) {
@@ -212,53 +359,47 @@ int generate_shards(
 
     uint8_t encrypted_master_secret[master_secret_length];
 
-    slip39_encrypt(master_secret,master_secret_length,passphrase,iteration_exponent,identifier, encrypted_master_secret);
-
-    uint8_t group_shares[master_secret_length * groups_length];
-
-    split_secret(group_threshold, groups_length, encrypted_master_secret, master_secret_length, group_shares, ctx, random_generator);
-
-    uint8_t *group_share = group_shares;
-
-    unsigned int shard_count = 0;
-    slip39_shard *shard = &shards[shard_count];
+    int error = slip39_encrypt_monitored(master_secret, master_secret_length, passphrase,
+        iteration_exponent, identifier, encrypted_master_secret, monitor);
+    if(error) {
+        return error;
+    }
 
-    for(uint8_t i=0; i<groups_length; ++i, group_share += master_secret_length) {
-        uint8_t member_shares[master_secret_length *groups[i].count];
-        split_secret(groups[i].threshold, groups[i].count, group_share, master_secret_length, member_shares, ctx, random_generator);
+    error = split_ems(group_threshold, groups, groups_length, encrypted_master_secret,
+        master_secret_length, identifier, iteration_exponent, shards, ctx, random_generator, monitor);
 
-        uint8_t *value = member_shares;
-        for(uint8_t j=0; j< groups[i].count; ++j, value += master_secret_length) {
-            shard = &shards[shard_count];
+    // clean up stack
+    memset(encrypted_master_secret, 0, sizeof(encrypted_master_secret));
 
-            shard->identifier = identifier;
-            shard->iteration_exponent = iteration_exponent;
-            shard->group_threshold = group_threshold;
-            shard->group_count = groups_length;
-            shard->value_length = master_secret_length;
-            shard->group_index = i;
-            shard->member_threshold = groups[i].threshold;
-            shard->member_index = j;
-            memset(shard->value, 0, 32);
-            memcpy(shard->value, value, master_secret_length);
+    return error;
+}
 
-            if(groups[i].passwords && groups[i].passwords[j]) {
-                encrypt_shard(shard, groups[i].passwords[j]);
-            }
+//////////////////////////////////////////////////
+// encode a set of shards as mnemonics, one after the other
+//
+static int encode_shards(
+    const slip39_shard *shards,
+    int total_shards,
+    uint32_t *mnemonic_length,
+    uint16_t *mnemonics,
+    uint32_t buffer_size
+) {
+    uint16_t *mnemonic = mnemonics;
+    unsigned int remaining_buffer = buffer_size;
+    unsigned int word_count = 0;
 
-            shard_count++;
+    for(uint16_t i =0; i<total_shards ; ++i) {
+        int words = encode_mnemonic(&shards[i], mnemonic, remaining_buffer);
+        if(words < 0) {
+            return words;
         }
-
-        // clean up
-        memset(member_shares, 0, sizeof(member_shares));
+        word_count = words;
+        remaining_buffer -= word_count;
+        mnemonic += word_count;
     }
 
-    // clean up stack
-    memset(encrypted_master_secret, 0, sizeof(encrypted_master_secret));
-    memset(group_shares, 0, sizeof(group_shares));
-
-    // return the number of shards generated
-    return shard_count;
+    *mnemonic_length = word_count;
+    return 0;
 }
 
 //////////////////////////////////////////////////
@@ -277,6 +418,26 @@ int slip39_generate(
     uint32_t buffer_size,
     void* ctx,
     void (*random_generator)(uint8_t *, size_t, void*)
+) {
+    return slip39_generate_monitored(group_threshold, groups, groups_length,
+        master_secret, master_secret_length, passphrase, iteration_exponent,
+        mnemonic_length, mnemonics, buffer_size, ctx, random_generator, NULL);
+}
+
+int slip39_generate_monitored(
+    uint8_t group_threshold,
+    const group_descriptor *groups,
+    uint8_t groups_length,
+    const uint8_t *master_secret,
+    uint32_t master_secret_length,
+    const char *passphrase,
+    uint8_t iteration_exponent,
+    uint32_t *mnemonic_length,
+    uint16_t *mnemonics,
+    uint32_t buffer_size,
+    void* ctx,
+    void (*random_generator)(uint8_t *, size_t, void*),
+    const slip39_kdf_monitor *monitor
 ) {
     if(master_secret_length < MIN_STRENGTH_BYTES) {
         return ERROR_SECRET_TOO_SHORT;
@@ -302,34 +463,65 @@ int slip39_generate(
 
     // generate shards
     total_shards = generate_shards(group_threshold, groups, groups_length, master_secret, master_secret_length,
-        passphrase, iteration_exponent, shards, total_shards, ctx, random_generator);
+        passphrase, iteration_exponent, shards, total_shards, ctx, random_generator, monitor);
 
     if(total_shards < 0) {
         error = total_shards;
     }
 
-    uint16_t *mnemonic = mnemonics;
-    unsigned int remaining_buffer = buffer_size;
-    unsigned int word_count = 0;
+    if(!error) {
+        error = encode_shards(shards, total_shards, mnemonic_length, mnemonics, buffer_size);
+    }
 
-    for(uint16_t i =0; !error && i<total_shards ; ++i) {
-        int words = encode_mnemonic(&shards[i], mnemonic, remaining_buffer);
-        if(words < 0) {
-            error = words;
-            break;
-        }
-        word_count = words;
-        remaining_buffer -= word_count;
-        mnemonic += word_count;
+    memset(shards,0,sizeof(shards));
+    if(error) {
+        memset(mnemonics, 0, buffer_size * sizeof(uint16_t));
+        return error;
+    }
+
+    return total_shards;
+}
+
+//////////////////////////////////////////////////
+// generate mnemonics from an encrypted master secret
+//
+int slip39_generate_from_ems(
+    uint8_t group_threshold,
+    const group_descriptor *groups,
+    uint8_t groups_length,
+    const slip39_ems *ems,
+    uint32_t *mnemonic_length,
+    uint16_t *mnemonics,
+    uint32_t buffer_size,
+    void* ctx,
+    void (*random_generator)(uint8_t *, size_t, void*)
+) {
+    // Figure out how many shards we are dealing with
+    int total_shards = count_shards(group_threshold, groups, groups_length);
+    if(total_shards < 0) {
+        return total_shards;
+    }
+
+    uint32_t shard_length = METADATA_LENGTH_WORDS + slip39_word_count_for_bytes(ems->length);
+    if(buffer_size < shard_length * total_shards) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+
+    slip39_shard shards[total_shards];
+
+    int error = split_ems(group_threshold, groups, groups_length, ems->value, ems->length,
+        ems->identifier, ems->iteration_exponent, shards, ctx, random_generator, NULL);
+
+    if(error > 0) {
+        error = encode_shards(shards, total_shards, mnemonic_length, mnemonics, buffer_size);
     }
 
     memset(shards,0,sizeof(shards));
     if(error) {
-        memset(mnemonics, 0, buffer_size);
-        return 0;
+        memset(mnemonics, 0, buffer_size * sizeof(uint16_t));
+        return error;
     }
 
-    *mnemonic_length = word_count;
     return total_shards;
 }
 
@@ -339,7 +531,19 @@ int combine_shards_internal(
     const char *passphrase,     // passphrase to unlock master secret
     const char **passwords,     // passwords for the shards
     uint8_t *buffer,            // working space, and place to return secret
-    uint32_t buffer_length      // total amount of working space
+    uint32_t buffer_length,     // total amount of working space
+    const slip39_kdf_monitor *monitor
+);
+
+int recover_ems_internal(
+    slip39_shard *shards,           // array of shard structures
+    uint16_t shards_count,          // number of shards in array
+    const char **passwords,         // passwords for the shards
+    uint8_t *ems,                   // place to return the encrypted master secret
+    uint32_t ems_length,            // space available in ems
+    uint16_t *identifier,           // place to return the shard set identifier
+    uint8_t *iteration_exponent,    // place to return the iteration exponent
+    const slip39_kdf_monitor *monitor
 );
 
 
@@ -358,7 +562,7 @@ int combine_shards(
     slip39_shard working_shards[shards_count];
     memcpy(working_shards, shards, sizeof(working_shards));
 
-    int result = combine_shards_internal(working_shards, shards_count, passphrase, passwords, buffer, buffer_length);
+    int result = combine_shards_internal(working_shards, shards_count, passphrase, passwords, buffer, buffer_length, NULL);
 
     memset(working_shards,0, sizeof(working_shards));
 
@@ -376,7 +580,47 @@ int combine_shards_internal(
     const char *passphrase,     // passphrase to unlock master secret
     const char **passwords,     // passwords for the shards
     uint8_t *buffer,            // working space, and place to return secret
-    uint32_t buffer_length      // total amount of working space
+    uint32_t buffer_length,     // total amount of working space
+    const slip39_kdf_monitor *monitor
+) {
+    uint8_t ems[32];
+    uint16_t identifier = 0;
+    uint8_t iteration_exponent = 0;
+
+    int result = recover_ems_internal(shards, shards_count, passwords, ems, sizeof(ems),
+        &identifier, &iteration_exponent, monitor);
+
+    if(result > 0 && buffer_length < (uint32_t) result) {
+        result = ERROR_INSUFFICIENT_SPACE;
+    }
+
+    // decrypt copy the result to the beinning of the buffer supplied
+    if(result > 0) {
+        int error = slip39_decrypt_monitored(ems, result, passphrase, iteration_exponent, identifier, buffer, monitor);
+        if(error) {
+            result = error;
+        }
+    }
+
+    memset(ems, 0, sizeof(ems));
+
+    return result;
+}
+
+/**
+ * Everything combine_shards_internal does short of decrypting the master
+ * secret: check that the shards are consistent, and run both levels of
+ * secret recovery. Modifies the shard structures in place.
+ */
+int recover_ems_internal(
+    slip39_shard *shards,           // array of shard structures
+    uint16_t shards_count,          // number of shards in array
+    const char **passwords,         // passwords for the shards
+    uint8_t *ems,                   // place to return the encrypted master secret
+    uint32_t ems_length,            // space available in ems
+    uint16_t *identifier_out,       // place to return the shard set identifier
+    uint8_t *iteration_exponent_out,// place to return the iteration exponent
+    const slip39_kdf_monitor *monitor
 ) {
     int error = 0;
     uint16_t identifier = 0;
@@ -395,7 +639,10 @@ int combine_shards_internal(
     for(unsigned int i=0; !error && i<shards_count; ++i) {
         slip39_shard *shard = &shards[i];
         if(passwords && passwords[i]) {
-            decrypt_shard(shard, passwords[i]);
+            error = decrypt_shard_monitored(shard, passwords[i], monitor);
+            if(error) {
+                return error;
+            }
         }
 
         if( i == 0) {
@@ -446,7 +693,7 @@ int combine_shards_internal(
         }
     }
 
-    if(buffer_length < secret_length) {
+    if(ems_length < secret_length) {
         error = ERROR_INSUFFICIENT_SPACE;
     } else if(next_group < group_threshold) {
         error = ERROR_NOT_ENOUGH_GROUPS;
@@ -459,7 +706,7 @@ int combine_shards_internal(
     const uint8_t *gy[16];
 
     // allocate enough space for the group shards and the encrypted master secret
-    uint8_t group_shares[secret_length * (group_threshold + 1)];
+    uint8_t group_shares[secret_length * (next_group + 1)];
     uint8_t *group_share = group_shares;
 
     for(uint8_t i=0; !error && i<next_group; ++i) {
@@ -491,9 +738,10 @@ int combine_shards_internal(
         error = recovery;
     }
 
-    // decrypt copy the result to the beinning of the buffer supplied
     if(!error) {
-        slip39_decrypt(group_share, secret_length, passphrase, iteration_exponent, identifier, buffer);
+        memcpy(ems, group_share, secret_length);
+        *identifier_out = identifier;
+        *iteration_exponent_out = iteration_exponent;
     }
 
     // clean up stack
@@ -510,6 +758,26 @@ int combine_shards_internal(
 }
 
 
+/////////////////////////////////////////////////
+// decode a set of mnemonics into shards
+static int decode_mnemonics(
+    const uint16_t **mnemonics, // array of pointers to 10-bit words
+    uint32_t mnemonics_words,   // number of words in each shard
+    uint32_t mnemonics_shards,  // total number of shards
+    slip39_shard *shards        // place to put the decoded shards
+) {
+    for(unsigned int i=0; i<mnemonics_shards; ++i) {
+        shards[i].value_length = 32;
+
+        int32_t bytes = decode_mnemonic(mnemonics[i], mnemonics_words, &shards[i]);
+
+        if(bytes < 0) {
+            return bytes;
+        }
+    }
+    return 0;
+}
+
 /////////////////////////////////////////////////
 // slip39_combine
 int slip39_combine(
@@ -520,6 +788,20 @@ int slip39_combine(
     const char **passwords,     // passwords for the shards
     uint8_t *buffer,            // working space, and place to return secret
     uint32_t buffer_length      // total amount of working space
+) {
+    return slip39_combine_monitored(mnemonics, mnemonics_words, mnemonics_shards,
+        passphrase, passwords, buffer, buffer_length, NULL);
+}
+
+int slip39_combine_monitored(
+    const uint16_t **mnemonics, // array of pointers to 10-bit words
+    uint32_t mnemonics_words,   // number of words in each shard
+    uint32_t mnemonics_shards,  // total number of shards
+    const char *passphrase,     // passphrase to unlock master secret
+    const char **passwords,     // passwords for the shards
+    uint8_t *buffer,            // working space, and place to return secret
+    uint32_t buffer_length,     // total amount of working space
+    const slip39_kdf_monitor *monitor
 ) {
     int result = 0;
 
@@ -529,18 +811,45 @@ int slip39_combine(
 
     slip39_shard shards[mnemonics_shards];
 
-    for(unsigned int i=0; !result && i<mnemonics_shards; ++i) {
-        shards[i].value_length = 32;
+    result = decode_mnemonics(mnemonics, mnemonics_words, mnemonics_shards, shards);
 
-        int32_t bytes = decode_mnemonic(mnemonics[i], mnemonics_words, &shards[i]);
+    if(!result) {
+        result = combine_shards_internal(shards, mnemonics_shards, passphrase, passwords, buffer, buffer_length, monitor);
+    }
+
+    memset(shards,0,sizeof(shards));
+
+    return result;
+}
+
+/////////////////////////////////////////////////
+// slip39_combine_packed
+int slip39_combine_packed(
+    const uint8_t **mnemonics,
+    uint32_t mnemonics_words,
+    uint32_t mnemonics_shards,
+    const char *passphrase,
+    const char **passwords,
+    uint8_t *buffer,
+    uint32_t buffer_length
+) {
+    int result = 0;
+
+    if(mnemonics_shards == 0) {
+        return ERROR_EMPTY_MNEMONIC_SET;
+    }
 
+    slip39_shard shards[mnemonics_shards];
+
+    for(unsigned int i=0; i<mnemonics_shards && !result; ++i) {
+        int32_t bytes = decode_packed_mnemonic(mnemonics[i], mnemonics_words, &shards[i]);
         if(bytes < 0) {
             result = bytes;
         }
     }
 
     if(!result) {
-        result = combine_shards_internal(shards, mnemonics_shards, passphrase, passwords, buffer, buffer_length);
+        result = combine_shards_internal(shards, mnemonics_shards, passphrase, passwords, buffer, buffer_length, NULL);
     }
 
     memset(shards,0,sizeof(shards));
@@ -548,6 +857,92 @@ int slip39_combine(
     return result;
 }
 
+/////////////////////////////////////////////////
+// slip39_recover_ems
+int slip39_recover_ems(
+    const uint16_t **mnemonics, // array of pointers to 10-bit words
+    uint32_t mnemonics_words,   // number of words in each shard
+    uint32_t mnemonics_shards,  // total number of shards
+    const char **passwords,     // passwords for the shards
+    slip39_ems **ems            // place to return the handle
+) {
+    *ems = NULL;
+
+    if(mnemonics_shards == 0) {
+        return ERROR_EMPTY_MNEMONIC_SET;
+    }
+
+    slip39_ems *result = malloc(sizeof(slip39_ems));
+    if(result == NULL) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+
+    slip39_shard shards[mnemonics_shards];
+
+    int length = decode_mnemonics(mnemonics, mnemonics_words, mnemonics_shards, shards);
+
+    if(!length) {
+        length = recover_ems_internal(shards, mnemonics_shards, passwords, result->value,
+            sizeof(result->value), &result->identifier, &result->iteration_exponent, NULL);
+    }
+
+    memset(shards,0,sizeof(shards));
+
+    if(length < 0) {
+        slip39_ems_free(result);
+        return length;
+    }
+
+    result->length = length;
+    *ems = result;
+    return length;
+}
+
+void slip39_ems_free(
+    slip39_ems *ems
+) {
+    if(ems) {
+        memset(ems, 0, sizeof(slip39_ems));
+        free(ems);
+    }
+}
+
+uint32_t slip39_ems_length(
+    const slip39_ems *ems
+) {
+    return ems->length;
+}
+
+const uint8_t *slip39_ems_value(
+    const slip39_ems *ems
+) {
+    return ems->value;
+}
+
+uint16_t slip39_ems_identifier(
+    const slip39_ems *ems
+) {
+    return ems->identifier;
+}
+
+uint8_t slip39_ems_iteration_exponent(
+    const slip39_ems *ems
+) {
+    return ems->iteration_exponent;
+}
+
+int slip39_ems_decrypt(
+    const slip39_ems *ems,
+    const char *passphrase,
+    uint8_t *buffer,
+    uint32_t buffer_length
+) {
+    if(buffer_length < ems->length) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+    slip39_decrypt(ems->value, ems->length, passphrase, ems->iteration_exponent, ems->identifier, buffer);
+    return ems->length;
+}
 
 ////
 // encrypt/decrypt shards
@@ -556,16 +951,46 @@ void encrypt_shard(
     slip39_shard *shard,
     const char *passphrase
 ) {
-    uint8_t temp[shard->value_length];
-    slip39_encrypt(shard->value, shard->value_length, passphrase, shard->iteration_exponent, shard->identifier, temp);
-    memcpy(shard->value, temp, shard->value_length);
+    encrypt_shard_monitored(shard, passphrase, NULL);
 }
 
 void decrypt_shard(
     slip39_shard *shard,
     const char *passphrase
+) {
+    decrypt_shard_monitored(shard, passphrase, NULL);
+}
+
+int encrypt_shard_monitored(
+    slip39_shard *shard,
+    const char *passphrase,
+    const slip39_kdf_monitor *monitor
+) {
+    uint8_t temp[shard->value_length];
+    int result = slip39_encrypt_monitored(shard->value, shard->value_length, passphrase,
+        shard->iteration_exponent, shard->identifier, temp, monitor);
+    if(result) {
+        memset(shard->value, 0, sizeof(shard->value));
+    } else {
+        memcpy(shard->value, temp, shard->value_length);
+    }
+    memset(temp, 0, sizeof(temp));
+    return result;
+}
+
+int decrypt_shard_monitored(
+    slip39_shard *shard,
+    const char *passphrase,
+    const slip39_kdf_monitor *monitor
 ) {
     uint8_t temp[shard->value_length];
-    slip39_decrypt(shard->value, shard->value_length, passphrase, shard->iteration_exponent, shard->identifier, temp);
-    memcpy(shard->value, temp, shard->value_length);
+    int result = slip39_decrypt_monitored(shard->value, shard->value_length, passphrase,
+        shard->iteration_exponent, shard->identifier, temp, monitor);
+    if(result) {
+        memset(shard->value, 0, sizeof(shard->value));
+    } else {
+        memcpy(shard->value, temp, shard->value_length);
+    }
+    memset(temp, 0, sizeof(temp));
+    return result;
 }
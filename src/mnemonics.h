@@ -12,6 +12,7 @@
 #include "util.h"
 #include "shard.h"
 #include "group.h"
+#include "encrypt.h"
 
 #define METADATA_LENGTH_WORDS 7
 #define MIN_STRENGTH_BYTES 16
@@ -39,6 +40,30 @@ void decrypt_shard(
     const char *passphrase
 );
 
+/**
+ * same as encrypt_shard, but reports progress to a monitor and can be
+ * cancelled through it. A cancelled shard has its value wiped.
+ *
+ * returns: 0 on success, or ERROR_CANCELLED
+ */
+int encrypt_shard_monitored(
+    slip39_shard *shard,
+    const char *passphrase,
+    const slip39_kdf_monitor *monitor
+);
+
+/**
+ * same as decrypt_shard, but reports progress to a monitor and can be
+ * cancelled through it. A cancelled shard has its value wiped.
+ *
+ * returns: 0 on success, or ERROR_CANCELLED
+ */
+int decrypt_shard_monitored(
+    slip39_shard *shard,
+    const char *passphrase,
+    const slip39_kdf_monitor *monitor
+);
+
 /**
  * generate a set of shards that can be used to reconstuct a secret
  * using the given group policy, but encode them as mnemonic codes
@@ -78,6 +103,28 @@ int slip39_generate(
     void (*random_generator)(uint8_t *, size_t, void*)
 );
 
+/**
+ * same as slip39_generate, but reports the progress of each key
+ * derivation (the master secret first, then any member passwords) to a
+ * monitor and can be cancelled through it. A cancelled call returns
+ * ERROR_CANCELLED with the mnemonics buffer and all intermediate secret
+ * state wiped.
+ */
+int slip39_generate_monitored(
+    uint8_t group_threshold,
+    const group_descriptor *groups,
+    uint8_t groups_length,
+    const uint8_t *master_secret,
+    uint32_t master_secret_length,
+    const char *passphrase,
+    uint8_t iteration_exponent,
+    uint32_t *mnemonic_length,
+    uint16_t *mnemonics,
+    uint32_t buffer_size,
+    void* ctx,
+    void (*random_generator)(uint8_t *, size_t, void*),
+    const slip39_kdf_monitor *monitor
+);
 
 /**
  * combine a set of mnemonic encoded shards to reconstuct a secret
@@ -107,4 +154,203 @@ int slip39_combine(
     uint32_t buffer_length      // total amount of working space
 );
 
+/**
+ * decode a share into a shard, checking the checksum
+ *
+ * returns: the length of the share value, or a negative error code as
+ *          for slip39_combine
+ *
+ * inputs: mnemonic: the words of the share
+ *         mnemonic_length: number of words in the share
+ *         shard: location to store the decoded shard
+ */
+int decode_mnemonic(
+    const uint16_t *mnemonic,
+    uint32_t mnemonic_length,
+    slip39_shard *shard
+);
+
+/**
+ * combine decoded shards to recover the master secret, as slip39_combine
+ * does for mnemonics. The shards are not modified.
+ */
+int combine_shards(
+    const slip39_shard *shards, // array of shard structures
+    uint16_t shards_count,      // number of shards in array
+    const char *passphrase,     // passphrase to unlock master secret
+    const char **passwords,     // passwords for the shards
+    uint8_t *buffer,            // working space, and place to return secret
+    uint32_t buffer_length      // total amount of working space
+);
+
+/**
+ * decode a share packed by slip39_pack_words into a shard, checking the
+ * checksum and reading the metadata and value from the packed bytes
+ * without unpacking the words first
+ *
+ * returns: the length of the share value, or a negative error code as
+ *          for slip39_combine
+ *
+ * inputs: packed: the packed share
+ *         mnemonic_length: number of words in the share
+ *         shard: location to store the decoded shard
+ */
+int decode_packed_mnemonic(
+    const uint8_t *packed,
+    uint32_t mnemonic_length,
+    slip39_shard *shard
+);
+
+/**
+ * same as slip39_combine, for shares packed by slip39_pack_words
+ */
+int slip39_combine_packed(
+    const uint8_t **mnemonics,  // array of pointers to packed shares
+    uint32_t mnemonics_words,   // number of words in each shard
+    uint32_t mnemonics_shards,  // total number of shards
+    const char *passphrase,     // passphrase to unlock master secret
+    const char **passwords,     // passwords protecting shards
+    uint8_t *buffer,            // working space, and place to return secret
+    uint32_t buffer_length      // total amount of working space
+);
+
+/**
+ * same as slip39_combine, but reports the progress of each key derivation
+ * (any member passwords first, then the master secret) to a monitor and
+ * can be cancelled through it. A cancelled call returns ERROR_CANCELLED
+ * with the buffer and all intermediate secret state wiped.
+ */
+int slip39_combine_monitored(
+    const uint16_t **mnemonics, // array of pointers to 10-bit words
+    uint32_t mnemonics_words,   // number of words in each shard
+    uint32_t mnemonics_shards,  // total number of shards
+    const char *passphrase,     // passphrase to unlock master secret
+    const char **passwords,     // passwords protecting shards
+    uint8_t *buffer,            // working space, and place to return secret
+    uint32_t buffer_length,     // total amount of working space
+    const slip39_kdf_monitor *monitor
+);
+
+/**
+ * an opaque handle on the encrypted master secret of a share set, along
+ * with the identifier and iteration exponent needed to decrypt it. The
+ * secret is wiped when the handle is freed.
+ */
+typedef struct slip39_ems_struct slip39_ems;
+
+/**
+ * combine a set of mnemonic encoded shards to recover the encrypted master
+ * secret, doing all of the work of slip39_combine except the final
+ * decryption, and keep the result in a handle so it can be decrypted any
+ * number of times with slip39_ems_decrypt or searched with
+ * slip39_search_ems
+ *
+ * returns: the length of the encrypted master secret if successful
+ *          or a negative number indicating an error code when unsuccessful
+ *
+ * inputs: mnemonics: an array of pointers to arrays of mnemonic codes
+ *         mnemonics_words: length of each array of mnemonic codes
+ *         mnemonics_shards: length of the mnemonics array
+ *         passwords: array of strings to use to decrypt shard data, as for
+ *                    slip39_combine
+ *         ems: location to store the handle, which must be released with
+ *              slip39_ems_free. Set to NULL when unsuccessful.
+ */
+int slip39_recover_ems(
+    const uint16_t **mnemonics, // array of pointers to 10-bit words
+    uint32_t mnemonics_words,   // number of words in each shard
+    uint32_t mnemonics_shards,  // total number of shards
+    const char **passwords,     // passwords protecting shards
+    slip39_ems **ems            // place to return the handle
+);
+
+/**
+ * wipe and release an encrypted master secret handle
+ */
+void slip39_ems_free(
+    slip39_ems *ems
+);
+
+/**
+ * returns: the length of the encrypted master secret, and so of the master
+ *          secret, in bytes
+ */
+uint32_t slip39_ems_length(
+    const slip39_ems *ems
+);
+
+/**
+ * returns: the encrypted master secret itself, slip39_ems_length bytes,
+ *          valid until the handle is freed
+ */
+const uint8_t *slip39_ems_value(
+    const slip39_ems *ems
+);
+
+/**
+ * returns: the identifier of the share set
+ */
+uint16_t slip39_ems_identifier(
+    const slip39_ems *ems
+);
+
+/**
+ * returns: the iteration exponent of the share set
+ */
+uint8_t slip39_ems_iteration_exponent(
+    const slip39_ems *ems
+);
+
+/**
+ * decrypt the master secret with a passphrase. Any passphrase gives a
+ * result, only the right one gives the original secret.
+ *
+ * returns: the length of the master secret if successful, or
+ *          ERROR_INSUFFICIENT_SPACE
+ *
+ * inputs: ems: the encrypted master secret
+ *         passphrase: a NULL terminated ascii string
+ *         buffer: location to store the master secret
+ *         buffer_length: maximum space available in buffer
+ */
+int slip39_ems_decrypt(
+    const slip39_ems *ems,
+    const char *passphrase,
+    uint8_t *buffer,
+    uint32_t buffer_length
+);
+
+/**
+ * generate a new set of mnemonic shards for the master secret held in an
+ * encrypted master secret handle, under a new group policy. The shards
+ * keep the identifier, iteration exponent and passphrase of the set the
+ * handle was recovered from, and since the secret is already encrypted no
+ * key derivation is needed, except for any member passwords.
+ *
+ * returns: the number of shards generated if successful,
+ *          or a negative number indicating an error code when unsuccessful
+ *
+ * inputs: group_threshold: the number of groups that need to be satisfied in order
+ *                          to reconstruct the secret
+ *         groups: an array of group descriptors
+ *         groups_length: the length of the groups array
+ *         ems: the encrypted master secret, from slip39_recover_ems
+ *         mnemonic_length: pointer to an integer that will be filled with the number of
+ *                          mnemonic words in each shard
+ *         mnemonics: array of shards represented as mnemonic codes
+ *         buffer_size: maximum number of mnemonic codes to write to the mnemonics array
+ *         random_generator: function to generate random bytes, as for slip39_generate
+ */
+int slip39_generate_from_ems(
+    uint8_t group_threshold,
+    const group_descriptor *groups,
+    uint8_t groups_length,
+    const slip39_ems *ems,
+    uint32_t *mnemonic_length,
+    uint16_t *mnemonics,
+    uint32_t buffer_size,
+    void* ctx,
+    void (*random_generator)(uint8_t *, size_t, void*)
+);
+
 #endif /* MNEMONICS_H */
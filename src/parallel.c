@@ -0,0 +1,238 @@
+//
+//  parallel.c
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#include "parallel.h"
+
+#ifndef ARDUINO
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+// upper limit on the size of the pool, whatever the caller asks for
+#define PARALLEL_MAX_THREADS 256
+
+static uint8_t stopped(const uint8_t *stop) {
+    return stop != NULL && __atomic_load_n(stop, __ATOMIC_ACQUIRE) != 0;
+}
+
+#ifdef ARDUINO
+
+uint32_t slip39_processor_count(void) {
+    return 1;
+}
+
+uint32_t slip39_parallel_for(
+    uint64_t count,
+    uint32_t threads,
+    uint64_t grain,
+    slip39_parallel_fn fn,
+    void *context,
+    const uint8_t *stop
+) {
+    if(grain == 0) {
+        grain = 1;
+    }
+    for(uint64_t begin = 0; begin < count && !stopped(stop); begin += grain) {
+        uint64_t end = count - begin > grain ? begin + grain : count;
+        fn(begin, end, 0, context);
+    }
+    return 1;
+}
+
+#else
+
+// the part of the index range a worker still has to do. The owner takes
+// from the front and thieves take from the back, both under the lock.
+typedef struct parallel_range_struct {
+    pthread_mutex_t lock;
+    uint64_t begin;
+    uint64_t end;
+} parallel_range;
+
+typedef struct parallel_pool_struct {
+    parallel_range *ranges;
+    uint32_t count;
+    uint64_t grain;
+    slip39_parallel_fn fn;
+    void *context;
+    const uint8_t *stop;
+} parallel_pool;
+
+typedef struct parallel_worker_struct {
+    parallel_pool *pool;
+    uint32_t index;
+} parallel_worker;
+
+uint32_t slip39_processor_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (uint32_t) n : 1;
+}
+
+// take up to grain indices off the front of our own range
+static uint8_t claim(parallel_range *range, uint64_t grain, uint64_t *begin, uint64_t *end) {
+    uint8_t claimed = 0;
+    pthread_mutex_lock(&range->lock);
+    if(range->begin < range->end) {
+        *begin = range->begin;
+        *end = range->end - range->begin > grain ? range->begin + grain : range->end;
+        range->begin = *end;
+        claimed = 1;
+    }
+    pthread_mutex_unlock(&range->lock);
+    return claimed;
+}
+
+// move the back half of the fullest other range into our own
+static uint8_t steal(parallel_pool *pool, uint32_t thief) {
+    parallel_range *mine = &pool->ranges[thief];
+    for(;;) {
+        uint32_t victim = pool->count;
+        uint64_t most = 0;
+
+        // the victim may have moved on by the time we lock it again below
+        for(uint32_t i = 0; i < pool->count; ++i) {
+            if(i == thief) {
+                continue;
+            }
+            pthread_mutex_lock(&pool->ranges[i].lock);
+            uint64_t left = pool->ranges[i].end - pool->ranges[i].begin;
+            pthread_mutex_unlock(&pool->ranges[i].lock);
+            if(left > most) {
+                most = left;
+                victim = i;
+            }
+        }
+        if(victim == pool->count) {
+            return 0;
+        }
+
+        parallel_range *theirs = &pool->ranges[victim];
+        uint64_t begin = 0, end = 0;
+        pthread_mutex_lock(&theirs->lock);
+        uint64_t left = theirs->end - theirs->begin;
+        if(left > 0) {
+            // leave the victim the front half, which it is working towards
+            uint64_t take = left > 1 ? left / 2 : 1;
+            end = theirs->end;
+            begin = end - take;
+            theirs->end = begin;
+        }
+        pthread_mutex_unlock(&theirs->lock);
+
+        if(begin < end) {
+            pthread_mutex_lock(&mine->lock);
+            mine->begin = begin;
+            mine->end = end;
+            pthread_mutex_unlock(&mine->lock);
+            return 1;
+        }
+        // someone else emptied the victim first, look again
+    }
+}
+
+static void *run_worker(void *arg) {
+    parallel_worker *worker = (parallel_worker *) arg;
+    parallel_pool *pool = worker->pool;
+    parallel_range *range = &pool->ranges[worker->index];
+    uint64_t begin, end;
+
+    while(!stopped(pool->stop)) {
+        if(claim(range, pool->grain, &begin, &end)) {
+            pool->fn(begin, end, worker->index, pool->context);
+        } else if(!steal(pool, worker->index)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+uint32_t slip39_parallel_for(
+    uint64_t count,
+    uint32_t threads,
+    uint64_t grain,
+    slip39_parallel_fn fn,
+    void *context,
+    const uint8_t *stop
+) {
+    if(threads == 0) {
+        threads = slip39_processor_count();
+    }
+    if(threads > PARALLEL_MAX_THREADS) {
+        threads = PARALLEL_MAX_THREADS;
+    }
+    if(grain == 0) {
+        grain = 1;
+    }
+    // no point in threads that would start with nothing to do
+    if(count / grain < threads) {
+        threads = (uint32_t) ((count + grain - 1) / grain);
+    }
+    if(threads <= 1) {
+        for(uint64_t begin = 0; begin < count && !stopped(stop); begin += grain) {
+            uint64_t end = count - begin > grain ? begin + grain : count;
+            fn(begin, end, 0, context);
+        }
+        return 1;
+    }
+
+    parallel_range *ranges = malloc(threads * sizeof(parallel_range));
+    parallel_worker *workers = malloc(threads * sizeof(parallel_worker));
+    pthread_t *handles = malloc(threads * sizeof(pthread_t));
+    uint8_t *started = calloc(threads, 1);
+
+    if(ranges == NULL || workers == NULL || handles == NULL || started == NULL) {
+        free(ranges);
+        free(workers);
+        free(handles);
+        free(started);
+        return slip39_parallel_for(count, 1, grain, fn, context, stop);
+    }
+
+    parallel_pool pool = { ranges, threads, grain, fn, context, stop };
+
+    uint64_t share = count / threads;
+    uint64_t extra = count % threads;
+    uint64_t next = 0;
+    for(uint32_t i = 0; i < threads; ++i) {
+        pthread_mutex_init(&ranges[i].lock, NULL);
+        ranges[i].begin = next;
+        next += share + (i < extra ? 1 : 0);
+        ranges[i].end = next;
+        workers[i].pool = &pool;
+        workers[i].index = i;
+    }
+
+    // if a thread can't be started its range is simply stolen by the others
+    uint32_t running = 1;
+    for(uint32_t i = 1; i < threads; ++i) {
+        if(pthread_create(&handles[i], NULL, run_worker, &workers[i]) == 0) {
+            started[i] = 1;
+            ++running;
+        }
+    }
+
+    run_worker(&workers[0]);
+
+    for(uint32_t i = 1; i < threads; ++i) {
+        if(started[i]) {
+            pthread_join(handles[i], NULL);
+        }
+    }
+    for(uint32_t i = 0; i < threads; ++i) {
+        pthread_mutex_destroy(&ranges[i].lock);
+    }
+
+    free(ranges);
+    free(workers);
+    free(handles);
+    free(started);
+
+    return running;
+}
+
+#endif
@@ -0,0 +1,56 @@
+//
+//  parallel.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdint.h>
+
+/**
+ * the body of a parallel loop: handle indices begin up to (not including)
+ * end. worker identifies the thread, from 0 up to the thread count, and is
+ * stable for the life of the loop, so it can index per-thread state.
+ */
+typedef void (*slip39_parallel_fn)(
+    uint64_t begin,
+    uint64_t end,
+    uint32_t worker,
+    void *context
+);
+
+/**
+ * returns: the number of processors available to run threads on, at least 1
+ */
+uint32_t slip39_processor_count(void);
+
+/**
+ * run fn over the indices 0 to count - 1 on a pool of threads. Each thread
+ * starts with an equal share of the range and takes grain indices at a
+ * time from the front of it; a thread that runs out steals the back half
+ * of what another thread has left, so uneven work still balances out.
+ * Worker 0 runs on the calling thread. Builds without thread support run
+ * everything there.
+ *
+ * inputs: count: number of indices
+ *         threads: number of threads to use, 0 for one per processor
+ *         grain: number of indices to hand fn at a time, 0 for 1
+ *         fn: loop body
+ *         context: passed through to fn
+ *         stop: if not NULL, no more work is handed out once *stop is non-zero
+ *
+ * returns: the number of threads that took part
+ */
+uint32_t slip39_parallel_for(
+    uint64_t count,
+    uint32_t threads,
+    uint64_t grain,
+    slip39_parallel_fn fn,
+    void *context,
+    const uint8_t *stop
+);
+
+#endif /* PARALLEL_H */
@@ -0,0 +1,247 @@
+//
+//  parser.c
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#include "parser.h"
+#include "encoding.h"
+#include "slip39-errors.h"
+
+#include <string.h>
+
+#if !defined(ARDUINO) && defined(__SSE2__)
+#define PARSER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// every letter in lower case, and 0 for everything that separates words
+static const uint8_t lower_case[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o',
+    'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', 0, 0, 0, 0, 0,
+    0, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o',
+    'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+void slip39_share_parser_init(
+    slip39_share_parser *parser,
+    uint16_t *words,
+    uint32_t words_capacity,
+    uint32_t *offsets,
+    int32_t *errors,
+    uint32_t share_capacity
+) {
+    memset(parser, 0, sizeof(slip39_share_parser));
+    parser->words = words;
+    parser->words_capacity = words_capacity;
+    parser->offsets = offsets;
+    parser->errors = errors;
+    parser->share_capacity = share_capacity;
+    parser->offsets[0] = 0;
+}
+
+void slip39_share_parser_clear(slip39_share_parser *parser) {
+    // the words of a line still being read move to the front
+    uint32_t start = parser->offsets[parser->share_count];
+    memmove(parser->words, parser->words + start, sizeof(uint16_t) * (parser->word_count - start));
+    parser->word_count -= start;
+    parser->share_count = 0;
+    parser->offsets[0] = 0;
+}
+
+// add the letters data[begin] up to data[end] to the word being read
+static void append_token(
+    slip39_share_parser *parser,
+    const char *data,
+    size_t begin,
+    size_t end
+) {
+    for(size_t i=begin; i<end; ++i) {
+        if(parser->token_length < 8) {
+            parser->token[parser->token_length] = lower_case[(uint8_t) data[i]];
+        }
+        parser->token_length++;
+    }
+}
+
+static void end_token(slip39_share_parser *parser) {
+    int16_t word = slip39_word_for_padded(parser->token, parser->token_length);
+
+    if(word < 0) {
+        if(parser->line_error == 0) {
+            parser->line_error = ERROR_INVALID_WORD;
+        }
+    } else if(parser->line_words >= SLIP39_MAX_SHARE_WORDS) {
+        if(parser->line_error == 0) {
+            parser->line_error = ERROR_TOO_MANY_WORDS;
+        }
+    } else {
+        parser->words[parser->word_count++] = word;
+    }
+
+    parser->line_words++;
+    parser->token_length = 0;
+    parser->in_token = 0;
+}
+
+static void end_line(slip39_share_parser *parser) {
+    if(!parser->in_line) {
+        return;
+    }
+    parser->errors[parser->share_count] = parser->line_error;
+    parser->offsets[++parser->share_count] = parser->word_count;
+    parser->in_line = 0;
+    parser->line_words = 0;
+    parser->line_error = 0;
+}
+
+// whether a share of any length still fits
+static uint8_t has_room(const slip39_share_parser *parser) {
+    return parser->share_count < parser->share_capacity &&
+        parser->words_capacity - parser->word_count >= SLIP39_MAX_SHARE_WORDS;
+}
+
+// bit i of letters is set if data[i] is a letter, and of newlines if it
+// is a newline, for the count (at most 16) bytes at data
+static void classify(
+    const char *data,
+    uint32_t count,
+    uint32_t *letters,
+    uint32_t *newlines
+) {
+#ifdef PARSER_SSE2
+    if(count == 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *) data);
+        // fold to lower case and move 'a'..'z' to the bottom of the
+        // signed range, where a single compare picks them out
+        __m128i folded = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+        __m128i shifted = _mm_sub_epi8(folded, _mm_set1_epi8('a' - 128));
+        __m128i letter = _mm_cmplt_epi8(shifted, _mm_set1_epi8(-128 + 26));
+        __m128i newline = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'));
+        *letters = _mm_movemask_epi8(letter);
+        *newlines = _mm_movemask_epi8(newline);
+        return;
+    }
+#endif
+    *letters = 0;
+    *newlines = 0;
+    for(uint32_t i=0; i<count; ++i) {
+        *letters |= (uint32_t) (lower_case[(uint8_t) data[i]] != 0) << i;
+        *newlines |= (uint32_t) (data[i] == '\n') << i;
+    }
+}
+
+// finish the word that started at data[start] and ends before data[end]
+static void take_token(
+    slip39_share_parser *parser,
+    const char *data,
+    size_t length,
+    size_t start,
+    size_t end
+) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // a whole word with 8 bytes to read from its start folds to lower
+    // case and pads in one go
+    size_t word_length = end - start;
+    if(parser->token_length == 0 && word_length <= 8 && start + 8 <= length) {
+        uint64_t letters;
+        memcpy(&letters, data + start, 8);
+        letters |= 0x2020202020202020ull;
+        letters &= word_length == 8 ? ~0ull : (1ull << (8 * word_length)) - 1;
+        memcpy(parser->token, &letters, 8);
+        parser->token_length = word_length;
+        end_token(parser);
+        return;
+    }
+#endif
+    append_token(parser, data, start, end);
+    end_token(parser);
+}
+
+size_t slip39_share_parser_feed(
+    slip39_share_parser *parser,
+    const char *data,
+    size_t length
+) {
+    // where the word being read started, a word carried over from the
+    // last chunk continues from the start of this one
+    size_t token_start = 0;
+
+    for(size_t base=0; base<length; base+=16) {
+        uint32_t count = length - base < 16 ? length - base : 16;
+        uint32_t letters, newlines;
+        classify(data + base, count, &letters, &newlines);
+        uint32_t others = ~letters & (((uint32_t) 1 << count) - 1);
+        uint8_t carried = parser->in_token;
+
+        // the word carried over from the last block ends at the first
+        // thing that is not a letter, if there is one in this block
+        if(carried) {
+            if(!others) {
+                continue;
+            }
+            take_token(parser, data, length, token_start, base + __builtin_ctzl(others));
+        }
+
+        // then go from word to word, each starting at a letter after
+        // anything else and running up to the next thing that is not a
+        // letter, and ending the line at any newline in between
+        uint32_t starts = letters & ~((letters << 1) | carried);
+
+        while(starts) {
+            uint32_t i = __builtin_ctzl(starts);
+            uint32_t before = ((uint32_t) 1 << i) - 1;
+            if(newlines & before) {
+                end_line(parser);
+                newlines &= ~before;
+            }
+
+            if(!parser->in_line) {
+                if(!has_room(parser)) {
+                    return base + i;
+                }
+                parser->in_line = 1;
+            }
+
+            memset(parser->token, 0, 8);
+            uint32_t after = others & ~before;
+            if(!after) {
+                // continues into the next block
+                parser->in_token = 1;
+                token_start = base + i;
+                break;
+            }
+            take_token(parser, data, length, base + i, base + __builtin_ctzl(after));
+            starts &= starts - 1;
+        }
+
+        if(newlines && !parser->in_token) {
+            end_line(parser);
+        }
+    }
+
+    if(parser->in_token) {
+        append_token(parser, data, token_start, length);
+    }
+    return length;
+}
+
+void slip39_share_parser_finish(slip39_share_parser *parser) {
+    if(parser->in_token) {
+        end_token(parser);
+    }
+    end_line(parser);
+}
@@ -0,0 +1,90 @@
+//
+//  parser.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// the longest share: 7 words of metadata and checksum around a 32 byte secret
+#define SLIP39_MAX_SHARE_WORDS 33
+
+/**
+ * a streaming parser for text holding one share per line, as read from a
+ * file in chunks of any size. Words are separated by anything that is not
+ * a letter, may be in either case, and may be abbreviated to their first
+ * four letters. Blank lines are skipped.
+ *
+ * The shares go into arrays the caller provides: the words of share i are
+ * words[offsets[i]] up to words[offsets[i+1]], and errors[i] is 0 or the
+ * first problem with the line, ERROR_INVALID_WORD or ERROR_TOO_MANY_WORDS
+ * (when it has more than SLIP39_MAX_SHARE_WORDS words, the rest are
+ * dropped). Nothing is allocated and nothing is printed.
+ *
+ * The fields after share_count are the parser's own.
+ */
+typedef struct slip39_share_parser_struct {
+    uint16_t *words;            // the words of every share, one after the other
+    uint32_t words_capacity;    // at least SLIP39_MAX_SHARE_WORDS
+    uint32_t word_count;
+    uint32_t *offsets;          // share_capacity + 1 entries
+    int32_t *errors;            // share_capacity entries
+    uint32_t share_capacity;
+    uint32_t share_count;
+
+    char token[8];              // the word being read, lower case and zero padded
+    uint32_t token_length;      // may be more than 8, when it is not a word
+    uint8_t in_token;
+    uint8_t in_line;            // whether the line has had a word yet
+    uint32_t line_words;
+    int32_t line_error;
+} slip39_share_parser;
+
+/**
+ * start parsing into the given arrays
+ */
+void slip39_share_parser_init(
+    slip39_share_parser *parser,
+    uint16_t *words,
+    uint32_t words_capacity,
+    uint32_t *offsets,
+    int32_t *errors,
+    uint32_t share_capacity
+);
+
+/**
+ * parse the next chunk of text. Lines and words may be split between
+ * chunks. Parsing stops before a line that might not fit in the arrays;
+ * the caller then uses the shares so far, calls
+ * slip39_share_parser_clear and feeds the rest of the chunk again.
+ *
+ * returns: the number of bytes parsed, less than length if the arrays
+ *          are full
+ *
+ * inputs: parser: the parser
+ *         data: the text
+ *         length: the number of bytes of text
+ */
+size_t slip39_share_parser_feed(
+    slip39_share_parser *parser,
+    const char *data,
+    size_t length
+);
+
+/**
+ * finish the last line, for text that does not end with a newline
+ */
+void slip39_share_parser_finish(slip39_share_parser *parser);
+
+/**
+ * empty the arrays for more shares, keeping the place in the text. The
+ * words of a line that is not finished yet are kept.
+ */
+void slip39_share_parser_clear(slip39_share_parser *parser);
+
+#endif /* PARSER_H */
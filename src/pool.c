@@ -0,0 +1,367 @@
+//
+//  pool.c
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#include "pool.h"
+#include "mnemonics.h"
+#include "parallel.h"
+#include "slip39-errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// marks the end of a bucket's list of shares and an unused index slot
+#define POOL_NONE UINT32_MAX
+
+// the most shares a recovery can use: 16 groups of 16 members
+#define POOL_MAX_SELECTED 256
+
+typedef struct pool_bucket_struct {
+    uint32_t key;       // identifier, iteration exponent, group count - 1
+    uint32_t first;     // the shares in the order they were added, linked
+    uint32_t last;      //   through the pool's next array
+    uint32_t count;
+} pool_bucket;
+
+struct slip39_pool_struct {
+    slip39_shard *shards;
+    uint32_t *next;             // the share added after each in its bucket
+    uint32_t share_count;
+    uint32_t share_capacity;
+    pool_bucket *buckets;
+    uint32_t bucket_count;
+    uint32_t bucket_capacity;
+    uint32_t *index;            // bucket numbers by hash of key, POOL_NONE
+    uint32_t index_mask;        //   where unused; the size is a power of two
+};
+
+static uint32_t bucket_key(const slip39_shard *shard) {
+    return (uint32_t) shard->identifier |
+        (uint32_t) shard->iteration_exponent << 15 |
+        (uint32_t) (shard->group_count - 1) << 20;
+}
+
+static uint32_t hash_key(uint32_t key) {
+    key *= 0x9E3779B1;
+    return key ^ (key >> 15);
+}
+
+// move an array to a larger allocation, wiping the old one since it may
+// hold share values
+static void *grow(void *old, size_t old_size, size_t new_size) {
+    void *p = malloc(new_size);
+    if(p == NULL) {
+        return NULL;
+    }
+    if(old != NULL) {
+        memcpy(p, old, old_size);
+        memset(old, 0, old_size);
+        free(old);
+    }
+    return p;
+}
+
+static int grow_shards(slip39_pool *pool, uint32_t capacity) {
+    slip39_shard *shards = grow(pool->shards,
+        sizeof(slip39_shard) * pool->share_count, sizeof(slip39_shard) * capacity);
+    if(shards == NULL) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+    pool->shards = shards;
+    uint32_t *next = grow(pool->next,
+        sizeof(uint32_t) * pool->share_count, sizeof(uint32_t) * capacity);
+    if(next == NULL) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+    pool->next = next;
+    pool->share_capacity = capacity;
+    return 0;
+}
+
+// find the slot of the index holding a key's bucket, or the empty slot it
+// would go in
+static uint32_t find_slot(const slip39_pool *pool, uint32_t key) {
+    uint32_t slot = hash_key(key) & pool->index_mask;
+    while(pool->index[slot] != POOL_NONE && pool->buckets[pool->index[slot]].key != key) {
+        slot = (slot + 1) & pool->index_mask;
+    }
+    return slot;
+}
+
+// keep the index at most half full
+static int grow_buckets(slip39_pool *pool) {
+    uint32_t capacity = pool->bucket_capacity * 2;
+    uint32_t *index = malloc(sizeof(uint32_t) * capacity * 2);
+    if(index == NULL) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+    pool_bucket *buckets = grow(pool->buckets,
+        sizeof(pool_bucket) * pool->bucket_count, sizeof(pool_bucket) * capacity);
+    if(buckets == NULL) {
+        free(index);
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+    pool->buckets = buckets;
+    pool->bucket_capacity = capacity;
+
+    free(pool->index);
+    pool->index = index;
+    pool->index_mask = capacity * 2 - 1;
+    memset(index, 0xff, sizeof(uint32_t) * capacity * 2);
+    for(uint32_t i=0; i<pool->bucket_count; ++i) {
+        index[find_slot(pool, pool->buckets[i].key)] = i;
+    }
+    return 0;
+}
+
+int slip39_pool_new(
+    uint32_t expected_shares,
+    slip39_pool **pool
+) {
+    *pool = NULL;
+    slip39_pool *result = calloc(1, sizeof(slip39_pool));
+    if(result == NULL) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+    result->bucket_capacity = 8;
+    int error = grow_shards(result, expected_shares > 16 ? expected_shares : 16);
+    if(!error) {
+        error = grow_buckets(result);
+    }
+    if(error) {
+        slip39_pool_free(result);
+        return error;
+    }
+    *pool = result;
+    return 0;
+}
+
+void slip39_pool_free(
+    slip39_pool *pool
+) {
+    if(pool == NULL) {
+        return;
+    }
+    if(pool->shards != NULL) {
+        memset(pool->shards, 0, sizeof(slip39_shard) * pool->share_capacity);
+    }
+    free(pool->shards);
+    free(pool->next);
+    free(pool->buckets);
+    free(pool->index);
+    free(pool);
+}
+
+static int add_shard(
+    slip39_pool *pool,
+    const slip39_shard *shard
+) {
+    if(pool->share_count == pool->share_capacity) {
+        int error = grow_shards(pool, pool->share_capacity * 2);
+        if(error) {
+            return error;
+        }
+    }
+
+    uint32_t key = bucket_key(shard);
+    uint32_t slot = find_slot(pool, key);
+    if(pool->index[slot] == POOL_NONE) {
+        if(pool->bucket_count == pool->bucket_capacity) {
+            int error = grow_buckets(pool);
+            if(error) {
+                return error;
+            }
+            slot = find_slot(pool, key);
+        }
+        pool_bucket *bucket = &pool->buckets[pool->bucket_count];
+        bucket->key = key;
+        bucket->first = POOL_NONE;
+        bucket->last = POOL_NONE;
+        bucket->count = 0;
+        pool->index[slot] = pool->bucket_count++;
+    }
+
+    uint32_t b = pool->index[slot];
+    pool_bucket *bucket = &pool->buckets[b];
+    uint32_t s = pool->share_count++;
+    pool->shards[s] = *shard;
+    pool->next[s] = POOL_NONE;
+    if(bucket->last == POOL_NONE) {
+        bucket->first = s;
+    } else {
+        pool->next[bucket->last] = s;
+    }
+    bucket->last = s;
+    bucket->count++;
+    return b;
+}
+
+int slip39_pool_add(
+    slip39_pool *pool,
+    const uint16_t *mnemonic,
+    uint32_t mnemonic_length
+) {
+    slip39_shard shard;
+    shard.value_length = 32;
+    int result = decode_mnemonic(mnemonic, mnemonic_length, &shard);
+    if(result >= 0) {
+        result = add_shard(pool, &shard);
+    }
+    memset(&shard, 0, sizeof(shard));
+    return result;
+}
+
+int slip39_pool_add_packed(
+    slip39_pool *pool,
+    const uint8_t *packed,
+    uint32_t mnemonic_length
+) {
+    slip39_shard shard;
+    shard.value_length = 32;
+    int result = decode_packed_mnemonic(packed, mnemonic_length, &shard);
+    if(result >= 0) {
+        result = add_shard(pool, &shard);
+    }
+    memset(&shard, 0, sizeof(shard));
+    return result;
+}
+
+uint32_t slip39_pool_bucket_count(
+    const slip39_pool *pool
+) {
+    return pool->bucket_count;
+}
+
+//////////////////////////////////////////////////
+// combining buckets
+//
+
+typedef struct pool_group_struct {
+    uint8_t member_threshold;
+    uint8_t count;
+    uint16_t members;           // a bit for each member index seen
+    uint32_t shares[16];        // a share for each distinct member
+} pool_group;
+
+// pick the shares to recover a bucket from, checking as recovery would
+// that they belong together
+static int select_shards(
+    const slip39_pool *pool,
+    const pool_bucket *bucket,
+    slip39_shard *selected,
+    uint32_t *selected_count
+) {
+    pool_group groups[16];
+    memset(groups, 0, sizeof(groups));
+    const slip39_shard *first = &pool->shards[bucket->first];
+
+    for(uint32_t s=bucket->first; s!=POOL_NONE; s=pool->next[s]) {
+        const slip39_shard *shard = &pool->shards[s];
+        if(shard->group_threshold != first->group_threshold ||
+           shard->value_length != first->value_length ||
+           shard->group_index >= shard->group_count) {
+            return ERROR_INVALID_SHARD_SET;
+        }
+
+        pool_group *group = &groups[shard->group_index];
+        if(group->count == 0) {
+            group->member_threshold = shard->member_threshold;
+        } else if(group->member_threshold != shard->member_threshold) {
+            return ERROR_INVALID_MEMBER_THRESHOLD;
+        }
+
+        uint16_t bit = (uint16_t) 1 << shard->member_index;
+        if(group->members & bit) {
+            // the same share twice is fine, two different ones are not
+            for(uint32_t i=0; i<group->count; ++i) {
+                const slip39_shard *other = &pool->shards[group->shares[i]];
+                if(other->member_index == shard->member_index &&
+                   memcmp(other->value, shard->value, shard->value_length) != 0) {
+                    return ERROR_DUPLICATE_MEMBER_INDEX;
+                }
+            }
+            continue;
+        }
+        group->members |= bit;
+        group->shares[group->count++] = s;
+    }
+
+    uint32_t present = 0;
+    uint32_t complete = 0;
+    for(uint32_t g=0; g<16; ++g) {
+        present += groups[g].count > 0;
+        complete += groups[g].count > 0 && groups[g].count >= groups[g].member_threshold;
+    }
+    if(present < first->group_threshold) {
+        return ERROR_NOT_ENOUGH_GROUPS;
+    }
+    if(complete < first->group_threshold) {
+        return ERROR_NOT_ENOUGH_MEMBER_SHARDS;
+    }
+
+    uint32_t n = 0;
+    uint32_t taken = 0;
+    for(uint32_t g=0; g<16 && taken<first->group_threshold; ++g) {
+        if(groups[g].count > 0 && groups[g].count >= groups[g].member_threshold) {
+            for(uint32_t i=0; i<groups[g].member_threshold; ++i) {
+                selected[n++] = pool->shards[groups[g].shares[i]];
+            }
+            taken++;
+        }
+    }
+    *selected_count = n;
+    return 0;
+}
+
+typedef struct pool_combine_struct {
+    const slip39_pool *pool;
+    const char *passphrase;
+    slip39_pool_result *results;
+} pool_combine;
+
+static void combine_buckets(
+    uint64_t begin,
+    uint64_t end,
+    uint32_t worker,
+    void *context
+) {
+    (void) worker;
+    pool_combine *c = context;
+    slip39_shard selected[POOL_MAX_SELECTED];
+
+    for(uint64_t b=begin; b<end; ++b) {
+        const pool_bucket *bucket = &c->pool->buckets[b];
+        slip39_pool_result *result = &c->results[b];
+        uint32_t count = 0;
+        memset(result, 0, sizeof(slip39_pool_result));
+        result->identifier = bucket->key & 0x7FFF;
+        result->iteration_exponent = (bucket->key >> 15) & 31;
+        result->group_count = (bucket->key >> 20) + 1;
+        result->shares = bucket->count;
+        result->status = select_shards(c->pool, bucket, selected, &count);
+        if(result->status == 0) {
+            result->status = combine_shards(selected, count, c->passphrase, NULL,
+                result->secret, sizeof(result->secret));
+        }
+        memset(selected, 0, sizeof(slip39_shard) * count);
+    }
+}
+
+uint32_t slip39_pool_combine(
+    const slip39_pool *pool,
+    const char *passphrase,
+    uint32_t threads,
+    slip39_pool_result *results,
+    uint32_t max
+) {
+    uint32_t count = pool->bucket_count < max ? pool->bucket_count : max;
+    pool_combine context = { pool, passphrase, results };
+
+    // a recovery is two key derivations, so one bucket at a time is
+    // plenty of work to hand a thread
+    slip39_parallel_for(count, threads, 1, combine_buckets, &context, NULL);
+    return pool->bucket_count;
+}
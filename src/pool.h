@@ -0,0 +1,122 @@
+//
+//  pool.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdint.h>
+
+/**
+ * a pool of shares from any number of splits, in any order. Each share is
+ * decoded once as it is added and filed in a bucket by identifier,
+ * iteration exponent and group count, found through a hash index. The
+ * shares are wiped when the pool is freed.
+ */
+typedef struct slip39_pool_struct slip39_pool;
+
+/**
+ * what became of one bucket of a pool
+ */
+typedef struct slip39_pool_result_struct {
+    uint16_t identifier;
+    uint8_t iteration_exponent;
+    uint8_t group_count;
+    uint32_t shares;        // shares added to the bucket, duplicates included
+    int status;             // the length of the secret, or a negative error code
+    uint8_t secret[32];     // the master secret when status is positive
+} slip39_pool_result;
+
+/**
+ * create an empty pool
+ *
+ * returns: 0, or ERROR_INSUFFICIENT_SPACE if memory could not be allocated
+ *
+ * inputs: expected_shares: a hint at how many shares will be added, 0 if
+ *                          not known
+ *         pool: location to store the handle, which must be released with
+ *               slip39_pool_free. Set to NULL when unsuccessful.
+ */
+int slip39_pool_new(
+    uint32_t expected_shares,
+    slip39_pool **pool
+);
+
+/**
+ * wipe and release a pool
+ */
+void slip39_pool_free(
+    slip39_pool *pool
+);
+
+/**
+ * decode a share and add it to its bucket
+ *
+ * returns: the index of the bucket, numbered in the order buckets were
+ *          first seen, or any error decoding the share gives, in which case
+ *          the share is not added
+ *
+ * inputs: pool: the pool
+ *         mnemonic: the words of the share
+ *         mnemonic_length: number of words
+ */
+int slip39_pool_add(
+    slip39_pool *pool,
+    const uint16_t *mnemonic,
+    uint32_t mnemonic_length
+);
+
+/**
+ * slip39_pool_add for a share packed by slip39_pack_words
+ */
+int slip39_pool_add_packed(
+    slip39_pool *pool,
+    const uint8_t *packed,
+    uint32_t mnemonic_length
+);
+
+/**
+ * returns: the number of buckets in the pool
+ */
+uint32_t slip39_pool_bucket_count(
+    const slip39_pool *pool
+);
+
+/**
+ * recover the secret of every bucket that has enough shares, with the
+ * recoveries spread over a pool of threads. Each bucket uses the first
+ * member threshold shares added for each of the first group threshold
+ * groups (by group index) to have enough. A share added twice is counted
+ * once.
+ *
+ * A bucket that cannot be recovered gets the reason as its status:
+ * ERROR_INVALID_SHARD_SET if its shares disagree on the group threshold,
+ * secret length or a group index, ERROR_INVALID_MEMBER_THRESHOLD if the
+ * shares of a group disagree on the member threshold,
+ * ERROR_DUPLICATE_MEMBER_INDEX for two different shares with the same
+ * member index, ERROR_NOT_ENOUGH_GROUPS if too few groups have any
+ * shares, ERROR_NOT_ENOUGH_MEMBER_SHARDS if enough groups have shares but
+ * too few have enough, or whatever recovering the secret returns.
+ *
+ * returns: the number of buckets, which may be more than max (only max
+ *          results are stored)
+ *
+ * inputs: pool: the pool
+ *         passphrase: the passphrase to decrypt every master secret with
+ *         threads: number of threads to use, 0 for one per processor
+ *         results: location to store a result for each bucket, in bucket
+ *                  order
+ *         max: maximum number of results to store
+ */
+uint32_t slip39_pool_combine(
+    const slip39_pool *pool,
+    const char *passphrase,
+    uint32_t threads,
+    slip39_pool_result *results,
+    uint32_t max
+);
+
+#endif /* POOL_H */
@@ -6,6 +6,14 @@
 //
 
 #include "rs1024.h"
+#include "cpu.h"
+#include "slip39-errors.h"
+
+#if !defined(ARDUINO) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RS1024_X86 1
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
 
 //////////////////////////////////////////////////
 // rs1024 checksum functions
@@ -27,11 +35,62 @@ static const uint8_t customization[] = {
     's', 'h', 'a', 'm', 'i', 'r',
 };
 
+// the xor of the generator entries selected by the low and high five bits
+// of the word shifted out of the checksum at each step. The polymod is
+// linear, so the two halves can be looked up separately.
+static const uint32_t generator_low[32] = {
+    0x00000000, 0x00E0E040, 0x01C1C080, 0x012120C0,
+    0x03838100, 0x03636140, 0x02424180, 0x02A2A1C0,
+    0x07070200, 0x07E7E240, 0x06C6C280, 0x062622C0,
+    0x04848300, 0x04646340, 0x05454380, 0x05A5A3C0,
+    0x0E0E0009, 0x0EEEE049, 0x0FCFC089, 0x0F2F20C9,
+    0x0D8D8109, 0x0D6D6149, 0x0C4C4189, 0x0CACA1C9,
+    0x09090209, 0x09E9E249, 0x08C8C289, 0x082822C9,
+    0x0A8A8309, 0x0A6A6349, 0x0B4B4389, 0x0BABA3C9,
+};
+
+static const uint32_t generator_high[32] = {
+    0x00000000, 0x1C0C2412, 0x38086C24, 0x24044836,
+    0x3090FC48, 0x2C9CD85A, 0x0898906C, 0x1494B47E,
+    0x21B1F890, 0x3DBDDC82, 0x19B994B4, 0x05B5B0A6,
+    0x112104D8, 0x0D2D20CA, 0x292968FC, 0x35254CEE,
+    0x03F3F120, 0x1FFFD532, 0x3BFB9D04, 0x27F7B916,
+    0x33630D68, 0x2F6F297A, 0x0B6B614C, 0x1767455E,
+    0x224209B0, 0x3E4E2DA2, 0x1A4A6594, 0x06464186,
+    0x12D2F5F8, 0x0EDED1EA, 0x2ADA99DC, 0x36D6BDCE,
+};
+
+// the inverse of the map from the word shifted out of the checksum to the
+// low ten bits of the generator combination it selects, by bit
+static const uint16_t generator_inverse[10] = {
+    0x091, 0x122, 0x244, 0x081, 0x102, 0x204, 0x001, 0x002, 0x004, 0x008,
+};
+
+// the checksum state after the customization string, which every
+// polymod starts with
+#define CUSTOMIZED_STATE 0x244A8EE3
+
+// one step of the polymod: shift a word in and reduce
+static inline uint32_t polymod_step(uint32_t chk, uint16_t value) {
+    uint32_t b = chk >> 20;
+    return (((chk & 0xFFFFF) << 10) ^ value) ^ generator_low[b & 31] ^ generator_high[(b >> 5) & 31];
+}
 
-// We need 30 bits of checksum to get 3 words worth (CHECKSUM_LENGTH_WORDS)
 uint32_t rs1024_polymod(
     const uint16_t *values,    // values - 10 bit words
     uint32_t values_length // number of entries in the values array
+) {
+    uint32_t chk = CUSTOMIZED_STATE;
+    for(uint32_t i=0; i<values_length; ++i) {
+        chk = polymod_step(chk, values[i]);
+    }
+    return chk;
+}
+
+// We need 30 bits of checksum to get 3 words worth (CHECKSUM_LENGTH_WORDS)
+uint32_t rs1024_polymod_reference(
+    const uint16_t *values,    // values - 10 bit words
+    uint32_t values_length // number of entries in the values array
 ) {
     // there are a bunch of hard coded magic numbers in this
     // that would have to be changed if the value of CHECKSUM_LENGTH_WORDS
@@ -91,3 +150,359 @@ uint8_t rs1024_verify_checksum(
 ) {
     return rs1024_polymod(values, n) == 1;
 }
+
+
+uint32_t rs1024_polymod_packed(
+    const uint8_t *packed,
+    uint32_t values_length
+) {
+    // the words are pulled out of each five byte group as they are needed
+    uint32_t chk = CUSTOMIZED_STATE;
+    uint32_t groups = values_length / 4;
+    for(uint32_t g=0; g<groups; ++g, packed+=5) {
+        uint64_t v = (uint64_t) packed[0] << 32 | (uint64_t) packed[1] << 24 |
+            (uint64_t) packed[2] << 16 | (uint64_t) packed[3] << 8 | packed[4];
+        chk = polymod_step(chk, v >> 30);
+        chk = polymod_step(chk, (v >> 20) & 1023);
+        chk = polymod_step(chk, (v >> 10) & 1023);
+        chk = polymod_step(chk, v & 1023);
+    }
+    uint32_t tail = values_length % 4;
+    if(tail > 0) {
+        uint64_t v = 0;
+        for(uint32_t i=0; i<(10 * tail + 7) / 8; ++i) {
+            v |= (uint64_t) packed[i] << (32 - 8 * i);
+        }
+        for(uint32_t i=0; i<tail; ++i) {
+            chk = polymod_step(chk, (v >> (30 - 10 * i)) & 1023);
+        }
+    }
+    return chk;
+}
+
+uint8_t rs1024_verify_checksum_packed(
+    const uint8_t *packed,
+    uint32_t n
+) {
+    return rs1024_polymod_packed(packed, n) == 1;
+}
+
+// undo a polymod step that shifted in a zero word
+static uint32_t polymod_unstep(uint32_t chk) {
+    uint32_t b = 0;
+    for(uint32_t j=0; j<10; ++j) {
+        b ^= generator_inverse[j] * ((chk >> j) & 1);
+    }
+    uint32_t reduced = generator_low[b & 31] ^ generator_high[b >> 5];
+    return (b << 20) | ((chk ^ reduced) >> 10);
+}
+
+//////////////////////////////////////////////////
+// incremental checksum
+//
+
+void rs1024_state_init(
+    rs1024_state *state
+) {
+    state->chk = CUSTOMIZED_STATE;
+    state->count = 0;
+}
+
+void rs1024_state_feed_word(
+    rs1024_state *state,
+    uint16_t word
+) {
+    state->chk = polymod_step(state->chk, word);
+    state->count++;
+}
+
+uint32_t rs1024_state_peek(
+    const rs1024_state *state
+) {
+    return state->chk;
+}
+
+uint8_t rs1024_state_finalize(
+    const rs1024_state *state
+) {
+    return state->chk == 1;
+}
+
+void rs1024_state_expected_checksum(
+    const rs1024_state *state,
+    uint16_t checksum[3]
+) {
+    // as rs1024_create_checksum: the polymod with three zero words
+    uint32_t polymod = polymod_step(polymod_step(polymod_step(state->chk, 0), 0), 0) ^ 1;
+    checksum[0] = (polymod >> 20) & 1023;
+    checksum[1] = (polymod >> 10) & 1023;
+    checksum[2] = (polymod) & 1023;
+}
+
+//////////////////////////////////////////////////
+// erasure recovery
+//
+
+// the most erasures the checksum can make up for
+#define MAX_ERASURES 3
+
+// the effect on the final polymod of a word at a given distance from the
+// end of the share, the polymod being linear in each word
+static uint32_t word_contribution(uint16_t word, uint32_t distance) {
+    uint32_t chk = word;
+    for(uint32_t i=0; i<distance; ++i) {
+        chk = polymod_step(chk, 0);
+    }
+    return chk;
+}
+
+int rs1024_fill_erasures(
+    uint16_t *words,
+    uint32_t n,
+    const uint32_t *positions,
+    uint32_t k
+) {
+    // one row per bit of the checksum, one column per bit of the missing
+    // words, and the right hand side in bit 31
+    uint32_t rows[30];
+    uint32_t unknowns = k * 10;
+
+    for(uint32_t i=0; i<k; ++i) {
+        if(positions[i] >= n) {
+            return ERROR_INVALID_ERASURE;
+        }
+        for(uint32_t j=0; j<i; ++j) {
+            if(positions[j] == positions[i]) {
+                return ERROR_INVALID_ERASURE;
+            }
+        }
+    }
+    if(k > MAX_ERASURES) {
+        return ERROR_AMBIGUOUS_ERASURES;
+    }
+
+    for(uint32_t i=0; i<k; ++i) {
+        words[positions[i]] = 0;
+    }
+
+    // what the missing words have to add to the polymod to make it 1
+    uint32_t target = rs1024_polymod(words, n) ^ 1;
+    for(uint32_t r=0; r<30; ++r) {
+        rows[r] = ((target >> r) & 1) << 31;
+    }
+    for(uint32_t i=0; i<k; ++i) {
+        for(uint32_t b=0; b<10; ++b) {
+            uint32_t column = word_contribution(1 << b, n - 1 - positions[i]);
+            for(uint32_t r=0; r<30; ++r) {
+                rows[r] |= ((column >> r) & 1) << (i * 10 + b);
+            }
+        }
+    }
+
+    // Gaussian elimination over GF(2)
+    uint32_t rank = 0;
+    uint8_t pivot_row[MAX_ERASURES * 10];
+    for(uint32_t c=0; c<unknowns; ++c) {
+        uint32_t r = rank;
+        while(r < 30 && !((rows[r] >> c) & 1)) {
+            ++r;
+        }
+        if(r == 30) {
+            // the columns of a Reed-Solomon code this short are always
+            // independent, but don't rely on it
+            return ERROR_AMBIGUOUS_ERASURES;
+        }
+        uint32_t swap = rows[r];
+        rows[r] = rows[rank];
+        rows[rank] = swap;
+        for(uint32_t i=0; i<30; ++i) {
+            if(i != rank && ((rows[i] >> c) & 1)) {
+                rows[i] ^= rows[rank];
+            }
+        }
+        pivot_row[c] = rank++;
+    }
+
+    // any equation left over has to be satisfied already
+    for(uint32_t r=rank; r<30; ++r) {
+        if(rows[r] >> 31) {
+            return 0;
+        }
+    }
+
+    for(uint32_t i=0; i<k; ++i) {
+        uint16_t word = 0;
+        for(uint32_t b=0; b<10; ++b) {
+            word |= (rows[pivot_row[i * 10 + b]] >> 31) << b;
+        }
+        words[positions[i]] = word;
+    }
+    return 1;
+}
+
+//////////////////////////////////////////////////
+// error location
+//
+
+uint32_t rs1024_locate_errors(
+    const uint16_t *words,
+    uint32_t n,
+    rs1024_correction *corrections,
+    uint32_t max
+) {
+    uint32_t found = 0;
+
+    // the difference the errors make to the polymod, the same whatever
+    // the rest of the share is since the polymod is linear
+    uint32_t error = rs1024_polymod(words, n) ^ 1;
+    if(error == 0) {
+        return 0;
+    }
+
+    // at each step, error is what a change to words[i] alone would have
+    // to contribute to the polymod if it were the last word
+    for(uint32_t i=n; i-- > 0; error = polymod_unstep(error)) {
+        // a substitution adds the difference of the words directly
+        if(error < 1024) {
+            if(found < max) {
+                corrections[found].kind = RS1024_SUBSTITUTION;
+                corrections[found].position = i;
+                corrections[found].word = words[i] ^ error;
+                corrections[found].distance = 0;
+            }
+            ++found;
+        }
+
+        // a swap of words[i-1] and words[i] changes both by their difference d,
+        // which contributes d shifted in once and d again
+        if(i > 0 && words[i-1] != words[i]) {
+            uint16_t d = words[i-1] ^ words[i];
+            if((polymod_step(d, 0) ^ d) == error) {
+                if(found < max) {
+                    corrections[found].kind = RS1024_TRANSPOSITION;
+                    corrections[found].position = i - 1;
+                    corrections[found].word = 0;
+                    corrections[found].distance = 0;
+                }
+                ++found;
+            }
+        }
+    }
+
+    return found;
+}
+
+//////////////////////////////////////////////////
+// batches of checksums
+//
+
+// the polymod of a batch of equal length arrays, one after the other
+static void polymod_many_scalar(
+    const uint16_t *const *values,
+    uint32_t count,
+    uint32_t values_length,
+    uint32_t *results
+) {
+    for(uint32_t i=0; i<count; ++i) {
+        results[i] = rs1024_polymod(values[i], values_length);
+    }
+}
+
+#ifdef RS1024_X86
+// the polymod of eight arrays at once, one in each 32 bit lane, looking
+// up both halves of the reduction with gathers
+AVX2_TARGET
+static void polymod_many_avx2(
+    const uint16_t *const *values,
+    uint32_t count,
+    uint32_t values_length,
+    uint32_t *results
+) {
+    const __m256i low_mask = _mm256_set1_epi32(31);
+    const __m256i keep_mask = _mm256_set1_epi32(0xFFFFF);
+
+    for(; count >= 8; count -= 8, values += 8, results += 8) {
+        __m256i chk = _mm256_set1_epi32(CUSTOMIZED_STATE);
+        for(uint32_t i=0; i<values_length; ++i) {
+            __m256i word = _mm256_setr_epi32(
+                values[0][i], values[1][i], values[2][i], values[3][i],
+                values[4][i], values[5][i], values[6][i], values[7][i]);
+            __m256i b = _mm256_srli_epi32(chk, 20);
+            __m256i low = _mm256_i32gather_epi32((const int *) generator_low, _mm256_and_si256(b, low_mask), 4);
+            __m256i high = _mm256_i32gather_epi32((const int *) generator_high,
+                _mm256_and_si256(_mm256_srli_epi32(b, 5), low_mask), 4);
+            chk = _mm256_slli_epi32(_mm256_and_si256(chk, keep_mask), 10);
+            chk = _mm256_xor_si256(_mm256_xor_si256(chk, word), _mm256_xor_si256(low, high));
+        }
+        _mm256_storeu_si256((__m256i *) results, chk);
+    }
+
+    polymod_many_scalar(values, count, values_length, results);
+}
+#endif
+
+// the polymod of every array in a batch
+static void polymod_many(
+    const uint16_t *const *values,
+    uint32_t count,
+    uint32_t values_length,
+    uint32_t *results
+) {
+#ifdef RS1024_X86
+    if(count >= 8 && (slip39_cpu_features() & SLIP39_CPU_AVX2)) {
+        polymod_many_avx2(values, count, values_length, results);
+        return;
+    }
+#endif
+    polymod_many_scalar(values, count, values_length, results);
+}
+
+// checksums are worked out this many arrays at a time, to keep the
+// results on the stack
+#define BATCH_LENGTH 64
+
+void rs1024_verify_checksum_many(
+    const uint16_t *const *shares,
+    uint32_t n,
+    uint32_t words,
+    uint8_t *ok
+) {
+    uint32_t results[BATCH_LENGTH];
+
+    while(n > 0) {
+        uint32_t count = n < BATCH_LENGTH ? n : BATCH_LENGTH;
+        polymod_many(shares, count, words, results);
+        for(uint32_t i=0; i<count; ++i) {
+            ok[i] = results[i] == 1;
+        }
+        shares += count;
+        ok += count;
+        n -= count;
+    }
+}
+
+void rs1024_create_checksum_many(
+    uint16_t *const *shares,
+    uint32_t n,
+    uint32_t words
+) {
+    uint32_t results[BATCH_LENGTH];
+
+    while(n > 0) {
+        uint32_t count = n < BATCH_LENGTH ? n : BATCH_LENGTH;
+        for(uint32_t i=0; i<count; ++i) {
+            shares[i][words-3] = 0;
+            shares[i][words-2] = 0;
+            shares[i][words-1] = 0;
+        }
+        polymod_many((const uint16_t *const *) shares, count, words, results);
+        for(uint32_t i=0; i<count; ++i) {
+            uint32_t polymod = results[i] ^ 1;
+            shares[i][words-3] = (polymod >> 20) & 1023;
+            shares[i][words-2] = (polymod >> 10) & 1023;
+            shares[i][words-1] = (polymod) & 1023;
+        }
+        shares += count;
+        n -= count;
+    }
+}
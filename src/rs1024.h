@@ -15,6 +15,15 @@ uint32_t rs1024_polymod(
     uint32_t values_length // number of entries in the values array
 );
 
+/**
+ * the straightforward bit at a time polymod, which rs1024_polymod
+ * replaces with table lookups. Kept to check the faster version against.
+ */
+uint32_t rs1024_polymod_reference(
+    const uint16_t *values,    // values - 10 bit words
+    uint32_t values_length // number of entries in the values array
+);
+
 void rs1024_create_checksum(
     uint16_t *values, // data words (10 bit)
     uint32_t n          // length of the data array, including three checksum word
@@ -25,4 +34,168 @@ uint8_t rs1024_verify_checksum(
     uint32_t n         // length of the data array
 );
 
+/**
+ * rs1024_polymod and rs1024_verify_checksum for words packed by
+ * slip39_pack_words, read straight from the packed bytes
+ *
+ * inputs: packed: the packed words
+ *         values_length, n: number of words
+ */
+uint32_t rs1024_polymod_packed(
+    const uint8_t *packed,
+    uint32_t values_length
+);
+
+uint8_t rs1024_verify_checksum_packed(
+    const uint8_t *packed,
+    uint32_t n
+);
+
+/**
+ * verify the checksums of many shares of the same length at once. Shares
+ * are checked side by side in vector lanes where the processor supports
+ * it (AVX2: 8 at a time).
+ *
+ * inputs: shares: array of pointers to the shares' words
+ *         n: number of shares
+ *         words: number of words in each share, including the checksum
+ *         ok: location to store n results, 1 for a valid checksum, 0 otherwise
+ */
+void rs1024_verify_checksum_many(
+    const uint16_t *const *shares,
+    uint32_t n,
+    uint32_t words,
+    uint8_t *ok
+);
+
+/**
+ * fill in the last three words of many shares of the same length with
+ * their checksums, as rs1024_create_checksum does for one
+ *
+ * inputs: shares: array of pointers to the shares' words
+ *         n: number of shares
+ *         words: number of words in each share, including the checksum
+ */
+void rs1024_create_checksum_many(
+    uint16_t *const *shares,
+    uint32_t n,
+    uint32_t words
+);
+
+/**
+ * the checksum of a share being built up a word at a time, for instance
+ * as it is typed in. Each word costs the same, however long the share.
+ */
+typedef struct rs1024_state_struct {
+    uint32_t chk;       // the polymod of the words so far
+    uint32_t count;     // number of words so far
+} rs1024_state;
+
+/**
+ * start a checksum with no words
+ */
+void rs1024_state_init(
+    rs1024_state *state
+);
+
+/**
+ * add the next word of the share
+ */
+void rs1024_state_feed_word(
+    rs1024_state *state,
+    uint16_t word       // 10 bit word
+);
+
+/**
+ * returns: the polymod of the words so far, the value rs1024_polymod would
+ *          give for them
+ */
+uint32_t rs1024_state_peek(
+    const rs1024_state *state
+);
+
+/**
+ * returns: 1 if the words so far, the last three being the checksum, make
+ *          a valid share, 0 otherwise
+ */
+uint8_t rs1024_state_finalize(
+    const rs1024_state *state
+);
+
+/**
+ * work out the checksum that should follow the words so far, so that once
+ * all of the data words of a share have been fed in, the last three words
+ * can be checked as they are entered, or suggested
+ *
+ * inputs: state: the checksum of the data words
+ *         checksum: location to store the three checksum words
+ */
+void rs1024_state_expected_checksum(
+    const rs1024_state *state,
+    uint16_t checksum[3]
+);
+
+/**
+ * work out the words missing from a share at known positions, using the
+ * checksum. The checksum can make up for any three missing words, so up
+ * to three have exactly one solution, found directly rather than by
+ * search. Note that with three missing words the checksum has nothing
+ * left to spare, so the result is only right if every other word is.
+ *
+ * returns: 1 if the missing words were filled in, 0 if no words at those
+ *          positions give a valid checksum (some other word is wrong),
+ *          ERROR_INVALID_ERASURE if a position is out of range or given
+ *          twice, or ERROR_AMBIGUOUS_ERASURES if more than three words
+ *          are missing
+ *
+ * inputs: words: the share, including the checksum. Missing words are
+ *                replaced with the values found; their contents on entry
+ *                do not matter
+ *         n: number of words in the share
+ *         positions: indices of the missing words
+ *         k: number of missing words
+ */
+int rs1024_fill_erasures(
+    uint16_t *words,
+    uint32_t n,
+    const uint32_t *positions,
+    uint32_t k
+);
+
+// kinds of correction rs1024_locate_errors can suggest
+#define RS1024_SUBSTITUTION     0   // replace one word
+#define RS1024_TRANSPOSITION    1   // swap two neighbouring words
+
+/**
+ * a change that would make a share's checksum come out right
+ */
+typedef struct rs1024_correction_struct {
+    uint8_t kind;           // RS1024_SUBSTITUTION or RS1024_TRANSPOSITION
+    uint32_t position;      // the word to replace, or the first of the two to swap
+    uint16_t word;          // for a substitution, the word to put there
+    uint8_t distance;       // how far the change is from what was written, see slip39_rank_corrections
+} rs1024_correction;
+
+/**
+ * find every single word substitution, and every swap of two neighbouring
+ * words, that would make a share's checksum valid. The work is linear in
+ * the length of the share: the checksum error is walked back from the end
+ * of the share one position at a time, and at each position there is at
+ * most one substitution and one swap that can account for it.
+ *
+ * returns: the number of corrections found, which may be more than max
+ *          (only max are stored), or 0 if the checksum is already valid
+ *
+ * inputs: words: the share, including the checksum
+ *         n: number of words in the share
+ *         corrections: location to store the corrections
+ *         max: maximum number of corrections to store
+ */
+uint32_t rs1024_locate_errors(
+    const uint16_t *words,
+    uint32_t n,
+    rs1024_correction *corrections,
+    uint32_t max
+);
+
 #endif /* RS1024_H */
@@ -0,0 +1,504 @@
+//
+//  search.c
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#include "search.h"
+#include "encrypt.h"
+#include "mnemonics.h"
+#include "parallel.h"
+#include "sha256.h"
+#include "slip39-errors.h"
+
+#include <string.h>
+
+#ifndef ARDUINO
+#include <time.h>
+#endif
+
+#define MASK_LOWER   "abcdefghijklmnopqrstuvwxyz"
+#define MASK_UPPER   "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+#define MASK_DIGIT   "0123456789"
+#define MASK_SYMBOL  " !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~"
+
+static const char mask_lower[] = MASK_LOWER;
+static const char mask_upper[] = MASK_UPPER;
+static const char mask_digit[] = MASK_DIGIT;
+static const char mask_symbol[] = MASK_SYMBOL;
+static const char mask_all[] = MASK_LOWER MASK_UPPER MASK_DIGIT MASK_SYMBOL;
+
+// a mask broken down into the characters each position can take
+typedef struct mask_position_struct {
+    const char *characters;
+    uint32_t count;
+} mask_position;
+
+typedef struct compiled_mask_struct {
+    mask_position positions[SEARCH_MAX_PASSPHRASE_LENGTH];
+    char literals[SEARCH_MAX_PASSPHRASE_LENGTH];
+    uint32_t length;
+    uint64_t count;
+} compiled_mask;
+
+// state shared by all the threads of a search
+typedef struct search_state_struct {
+    const uint8_t *ems;
+    uint32_t ems_length;
+    uint16_t identifier;
+    uint8_t iteration_exponent;
+    const slip39_passphrase_source *source;
+    const compiled_mask *mask;
+    uint32_t rule_count;
+    uint64_t offset;        // number of the first candidate of the range
+    uint64_t total;
+    slip39_verify_fn verify;
+    void *verify_context;
+    const slip39_search_options *options;
+    uint32_t batch;
+    double started;
+    double last_report;
+    uint64_t tried;         // updated atomically
+    uint8_t stop;           // updated atomically
+    uint8_t found;          // updated atomically
+    uint8_t cancelled;
+    slip39_search_result *result;
+} search_state;
+
+static double now(void) {
+#ifdef ARDUINO
+    return 0;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+static int compile_mask(const char *mask, compiled_mask *compiled) {
+    uint32_t length = 0;
+    uint64_t count = 1;
+
+    if(mask == NULL) {
+        return ERROR_INVALID_MASK;
+    }
+
+    for(const char *p = mask; *p; ++p) {
+        mask_position position;
+
+        if(length == SEARCH_MAX_PASSPHRASE_LENGTH) {
+            return ERROR_INVALID_MASK;
+        }
+
+        if(*p != '?') {
+            compiled->literals[length] = *p;
+            position.characters = &compiled->literals[length];
+            position.count = 1;
+        } else {
+            ++p;
+            switch(*p) {
+                case 'l': position.characters = mask_lower; break;
+                case 'u': position.characters = mask_upper; break;
+                case 'd': position.characters = mask_digit; break;
+                case 's': position.characters = mask_symbol; break;
+                case 'a': position.characters = mask_all; break;
+                case '?':
+                    compiled->literals[length] = '?';
+                    position.characters = &compiled->literals[length];
+                    break;
+                default:
+                    return ERROR_INVALID_MASK;
+            }
+            position.count = *p == '?' ? 1 : (uint32_t) strlen(position.characters);
+        }
+
+        if(count > (UINT64_MAX >> 1) / position.count) {
+            return ERROR_INVALID_MASK;
+        }
+        count *= position.count;
+        compiled->positions[length++] = position;
+    }
+
+    compiled->length = length;
+    compiled->count = count;
+    return 0;
+}
+
+// the number of candidates before rules, or an error
+static int64_t base_count(const slip39_passphrase_source *source) {
+    compiled_mask mask;
+    int error;
+
+    switch(source->kind) {
+        case SLIP39_SOURCE_DICTIONARY:
+            return source->word_count;
+        case SLIP39_SOURCE_MASK:
+            error = compile_mask(source->mask, &mask);
+            return error ? error : (int64_t) mask.count;
+        case SLIP39_SOURCE_CALLBACK:
+            return source->count > (UINT64_MAX >> 1) ? ERROR_INVALID_MASK : (int64_t) source->count;
+        default:
+            return ERROR_INVALID_MASK;
+    }
+}
+
+static uint8_t is_lower(char c) {
+    return c >= 'a' && c <= 'z';
+}
+
+static uint8_t is_upper(char c) {
+    return c >= 'A' && c <= 'Z';
+}
+
+static char to_lower(char c) {
+    return is_upper(c) ? c - 'A' + 'a' : c;
+}
+
+static char to_upper(char c) {
+    return is_lower(c) ? c - 'a' + 'A' : c;
+}
+
+static uint8_t valid_rule(const char *rule) {
+    if(rule == NULL) {
+        return 0;
+    }
+    for(const char *p = rule; *p; ++p) {
+        switch(*p) {
+            case ' ': case ':': case 'l': case 'u': case 'c': case 't': case 'r': case 'd':
+                break;
+            case '$': case '^':
+                if(*++p == 0) {
+                    return 0;
+                }
+                break;
+            default:
+                return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * apply a rule to the nul terminated candidate in passphrase, which has
+ * room for SEARCH_MAX_PASSPHRASE_LENGTH characters
+ *
+ * returns: 1 on success, 0 if the result would not fit
+ */
+static uint8_t apply_rule(const char *rule, char *passphrase) {
+    uint32_t length = (uint32_t) strlen(passphrase);
+
+    for(const char *p = rule; *p; ++p) {
+        switch(*p) {
+            case 'l':
+                for(uint32_t i = 0; i < length; ++i) {
+                    passphrase[i] = to_lower(passphrase[i]);
+                }
+                break;
+            case 'u':
+                for(uint32_t i = 0; i < length; ++i) {
+                    passphrase[i] = to_upper(passphrase[i]);
+                }
+                break;
+            case 'c':
+                for(uint32_t i = 0; i < length; ++i) {
+                    passphrase[i] = i == 0 ? to_upper(passphrase[i]) : to_lower(passphrase[i]);
+                }
+                break;
+            case 't':
+                for(uint32_t i = 0; i < length; ++i) {
+                    passphrase[i] = is_lower(passphrase[i]) ? to_upper(passphrase[i]) : to_lower(passphrase[i]);
+                }
+                break;
+            case 'r':
+                for(uint32_t i = 0; i < length / 2; ++i) {
+                    char c = passphrase[i];
+                    passphrase[i] = passphrase[length - 1 - i];
+                    passphrase[length - 1 - i] = c;
+                }
+                break;
+            case 'd':
+                if(length * 2 > SEARCH_MAX_PASSPHRASE_LENGTH) {
+                    return 0;
+                }
+                memcpy(passphrase + length, passphrase, length);
+                length *= 2;
+                break;
+            case '$':
+                if(length == SEARCH_MAX_PASSPHRASE_LENGTH) {
+                    return 0;
+                }
+                passphrase[length++] = *++p;
+                break;
+            case '^':
+                if(length == SEARCH_MAX_PASSPHRASE_LENGTH) {
+                    return 0;
+                }
+                memmove(passphrase + 1, passphrase, length++);
+                passphrase[0] = *++p;
+                break;
+        }
+        passphrase[length] = 0;
+    }
+    return 1;
+}
+
+int64_t slip39_source_count(
+    const slip39_passphrase_source *source
+) {
+    int64_t count = base_count(source);
+    if(count < 0 || source->rules == NULL) {
+        return count;
+    }
+
+    for(uint32_t i = 0; i < source->rule_count; ++i) {
+        if(!valid_rule(source->rules[i])) {
+            return ERROR_INVALID_RULE;
+        }
+    }
+    if(source->rule_count > 0 && count > INT64_MAX / source->rule_count) {
+        return ERROR_INVALID_MASK;
+    }
+    return count * source->rule_count;
+}
+
+// write the candidate with the given index, ignoring rules
+static uint8_t base_candidate(const search_state *state, uint64_t index, char *passphrase) {
+    const slip39_passphrase_source *source = state->source;
+    const compiled_mask *mask = state->mask;
+
+    switch(source->kind) {
+        case SLIP39_SOURCE_DICTIONARY:
+            if(source->words[index] == NULL || strlen(source->words[index]) > SEARCH_MAX_PASSPHRASE_LENGTH) {
+                return 0;
+            }
+            strcpy(passphrase, source->words[index]);
+            return 1;
+
+        case SLIP39_SOURCE_MASK:
+            // the rightmost position varies fastest
+            for(uint32_t i = mask->length; i > 0; --i) {
+                const mask_position *position = &mask->positions[i - 1];
+                passphrase[i - 1] = position->characters[index % position->count];
+                index /= position->count;
+            }
+            passphrase[mask->length] = 0;
+            return 1;
+
+        case SLIP39_SOURCE_CALLBACK:
+            if(!source->generate(index, passphrase, SEARCH_MAX_PASSPHRASE_LENGTH + 1, source->context)) {
+                return 0;
+            }
+            passphrase[SEARCH_MAX_PASSPHRASE_LENGTH] = 0;
+            return 1;
+    }
+    return 0;
+}
+
+// write the candidate with the given index, returns 0 if there is none
+static uint8_t candidate(const search_state *state, uint64_t index, char *passphrase) {
+    const char *rule = NULL;
+
+    if(state->source->rules != NULL) {
+        rule = state->source->rules[index % state->rule_count];
+        index /= state->rule_count;
+    }
+
+    if(!base_candidate(state, index, passphrase)) {
+        return 0;
+    }
+    return rule == NULL || apply_rule(rule, passphrase);
+}
+
+static void report(search_state *state, uint8_t force) {
+    const slip39_search_options *options = state->options;
+    if(options == NULL || options->progress == NULL) {
+        return;
+    }
+
+    double t = now();
+    if(!force && (t - state->last_report) * 1000 < options->progress_interval_ms) {
+        return;
+    }
+    state->last_report = t;
+
+    uint64_t tried = __atomic_load_n(&state->tried, __ATOMIC_RELAXED);
+    double elapsed = t - state->started;
+    options->progress(tried, state->total, elapsed > 0 ? tried / elapsed : 0, options->progress_context);
+}
+
+// the body of the parallel loop: decrypt candidates a vector's width at a
+// time and check each one
+static void search_range(uint64_t begin, uint64_t end, uint32_t worker, void *context) {
+    search_state *state = (search_state *) context;
+    const slip39_search_options *options = state->options;
+    char passphrases[SHA256_MAX_LANES][SEARCH_MAX_PASSPHRASE_LENGTH + 1];
+    uint8_t secrets[SHA256_MAX_LANES][32];
+    slip39_crypt_request requests[SHA256_MAX_LANES];
+
+    uint64_t index = begin;
+    while(index < end && !__atomic_load_n(&state->stop, __ATOMIC_ACQUIRE)) {
+        uint32_t count = 0;
+        uint64_t first = index;
+
+        while(count < state->batch && index < end) {
+            if(candidate(state, state->offset + index, passphrases[count])) {
+                requests[count].input = state->ems;
+                requests[count].input_length = state->ems_length;
+                requests[count].passphrase = passphrases[count];
+                requests[count].iteration_exponent = state->iteration_exponent;
+                requests[count].identifier = state->identifier;
+                requests[count].output = secrets[count];
+                ++count;
+            }
+            ++index;
+        }
+
+        slip39_decrypt_many(requests, count);
+
+        for(uint32_t i = 0; i < count; ++i) {
+            if(state->verify(secrets[i], state->ems_length, passphrases[i], state->verify_context)) {
+                // only the first thread to get here gets to fill in the result
+                uint8_t expected = 0;
+                if(__atomic_compare_exchange_n(&state->found, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                    strcpy(state->result->passphrase, passphrases[i]);
+                    memcpy(state->result->secret, secrets[i], state->ems_length);
+                    state->result->secret_length = state->ems_length;
+                }
+                __atomic_store_n(&state->stop, 1, __ATOMIC_RELEASE);
+                break;
+            }
+        }
+
+        __atomic_add_fetch(&state->tried, index - first, __ATOMIC_RELAXED);
+
+        if(options != NULL && options->cancel != NULL && __atomic_load_n(options->cancel, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&state->stop, 1, __ATOMIC_RELEASE);
+        }
+
+        if(worker == 0) {
+            report(state, 0);
+        }
+    }
+
+    memset(secrets, 0, sizeof(secrets));
+    memset(passphrases, 0, sizeof(passphrases));
+}
+
+int slip39_search_ems_range(
+    const slip39_ems *ems,
+    const slip39_passphrase_source *source,
+    uint64_t begin,
+    uint64_t end,
+    slip39_verify_fn verify,
+    void *verify_context,
+    const slip39_search_options *options,
+    slip39_search_result *result
+) {
+    compiled_mask mask;
+    search_state state;
+
+    memset(result, 0, sizeof(slip39_search_result));
+
+    uint32_t ems_length = slip39_ems_length(ems);
+    if(ems_length == 0 || ems_length > sizeof(result->secret)) {
+        return ERROR_INVALID_SECRET_LENGTH;
+    }
+
+    int64_t total = slip39_source_count(source);
+    if(total < 0) {
+        return (int) total;
+    }
+    if(end > (uint64_t) total) {
+        end = total;
+    }
+    if(begin > end) {
+        begin = end;
+    }
+    if(source->kind == SLIP39_SOURCE_MASK) {
+        compile_mask(source->mask, &mask);
+    }
+
+    memset(&state, 0, sizeof(state));
+    state.ems = slip39_ems_value(ems);
+    state.ems_length = ems_length;
+    state.identifier = slip39_ems_identifier(ems);
+    state.iteration_exponent = slip39_ems_iteration_exponent(ems);
+    state.source = source;
+    state.mask = &mask;
+    state.rule_count = source->rule_count;
+    state.offset = begin;
+    state.total = end - begin;
+    state.verify = verify;
+    state.verify_context = verify_context;
+    state.options = options;
+    state.result = result;
+
+    // a batch fills the vector lanes once; a chunk is a few batches, so
+    // threads don't contend for work too often
+    state.batch = slip39_sha256_lane_width();
+    uint64_t chunk = options != NULL && options->chunk > 0 ? options->chunk : state.batch * 4;
+    uint32_t threads = options != NULL ? options->threads : 0;
+
+    state.started = state.last_report = now();
+
+    if(options != NULL && options->cancel != NULL && __atomic_load_n(options->cancel, __ATOMIC_ACQUIRE)) {
+        state.stop = 1;
+    }
+
+    slip39_parallel_for(state.total, threads, chunk, search_range, &state, &state.stop);
+
+    result->tried = state.tried;
+    result->seconds = now() - state.started;
+    result->rate = result->seconds > 0 ? result->tried / result->seconds : 0;
+
+    report(&state, 1);
+
+    memset(&mask, 0, sizeof(mask));
+
+    if(state.found) {
+        return 1;
+    }
+    if(state.stop) {
+        return ERROR_CANCELLED;
+    }
+    return 0;
+}
+
+int slip39_search_ems(
+    const slip39_ems *ems,
+    const slip39_passphrase_source *source,
+    slip39_verify_fn verify,
+    void *verify_context,
+    const slip39_search_options *options,
+    slip39_search_result *result
+) {
+    return slip39_search_ems_range(ems, source, 0, UINT64_MAX, verify, verify_context, options, result);
+}
+
+int slip39_search_passphrase(
+    const uint16_t **mnemonics, // array of pointers to 10-bit words
+    uint32_t mnemonics_words,   // number of words in each shard
+    uint32_t mnemonics_shards,  // total number of shards
+    const char **passwords,     // passwords protecting shards
+    const slip39_passphrase_source *source,
+    slip39_verify_fn verify,
+    void *verify_context,
+    const slip39_search_options *options,
+    slip39_search_result *result
+) {
+    slip39_ems *ems = NULL;
+
+    int length = slip39_recover_ems(mnemonics, mnemonics_words, mnemonics_shards, passwords, &ems);
+
+    if(length < 0) {
+        memset(result, 0, sizeof(slip39_search_result));
+        return length;
+    }
+
+    int found = slip39_search_ems(ems, source, verify, verify_context, options, result);
+
+    slip39_ems_free(ems);
+
+    return found;
+}
@@ -0,0 +1,184 @@
+//
+//  search.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdint.h>
+#include "mnemonics.h"
+
+// longest candidate passphrase the search will try, not counting the nul
+#define SEARCH_MAX_PASSPHRASE_LENGTH 128
+
+// kinds of passphrase source
+#define SLIP39_SOURCE_DICTIONARY    0   // every entry of a word list
+#define SLIP39_SOURCE_MASK          1   // every string matching a mask
+#define SLIP39_SOURCE_CALLBACK      2   // whatever a callback produces
+
+/**
+ * produce the candidate with the given index for a callback source.
+ * Called from several threads at once.
+ *
+ * inputs: index: which candidate, from 0 up to the count of the source
+ *         passphrase: location to write the nul terminated candidate
+ *         passphrase_length: space available in passphrase
+ *         context: the context of the source
+ *
+ * returns: 1 if a candidate was written, 0 to skip this index
+ */
+typedef uint8_t (*slip39_candidate_fn)(
+    uint64_t index,
+    char *passphrase,
+    uint32_t passphrase_length,
+    void *context
+);
+
+/**
+ * where candidate passphrases come from. A mask is a string of literal
+ * characters and placeholders: ?l lowercase letters, ?u uppercase letters,
+ * ?d digits, ?s printable symbols and space, ?a all of these, and ?? for
+ * a literal question mark. Candidates are tried with the rightmost
+ * placeholder changing fastest.
+ *
+ * Every candidate can also be put through a list of rules, each rule
+ * giving one variant to try. A rule is a sequence of operations applied
+ * left to right: : leaves the candidate alone, l lowercases it, u
+ * uppercases it, c capitalizes it, t toggles the case of every letter, r
+ * reverses it, d duplicates it, $X appends the character X and ^X
+ * prepends it. Spaces between operations are ignored. All the variants
+ * of one candidate are numbered together, in the order of the rules.
+ */
+typedef struct slip39_passphrase_source_struct {
+    uint8_t kind;               // one of SLIP39_SOURCE_*
+    const char **words;         // dictionary: the candidates
+    uint32_t word_count;        // dictionary: number of candidates
+    const char *mask;           // mask: the pattern
+    slip39_candidate_fn generate;   // callback: produces candidates
+    uint64_t count;             // callback: number of indices to ask for
+    void *context;              // callback: passed through to generate
+    const char **rules;         // may be NULL to try candidates as they are
+    uint32_t rule_count;        // number of rules
+} slip39_passphrase_source;
+
+/**
+ * decide whether a decrypted master secret is the right one, for instance
+ * by deriving a wallet address from it and comparing that with a known
+ * one. Called from several threads at once.
+ *
+ * returns: 1 if this is the secret being looked for, 0 otherwise
+ */
+typedef uint8_t (*slip39_verify_fn)(
+    const uint8_t *secret,
+    uint32_t secret_length,
+    const char *passphrase,
+    void *context
+);
+
+/**
+ * reports on a search while it runs, from the calling thread
+ *
+ * inputs: tried: candidates tried so far
+ *         total: candidates in the source
+ *         rate: candidates per second so far
+ *         context: the progress_context of the options
+ */
+typedef void (*slip39_progress_fn)(
+    uint64_t tried,
+    uint64_t total,
+    double rate,
+    void *context
+);
+
+typedef struct slip39_search_options_struct {
+    uint32_t threads;               // 0 for one per processor
+    uint32_t chunk;                 // candidates a thread takes at a time, 0 for a default
+    slip39_progress_fn progress;    // may be NULL
+    void *progress_context;
+    uint32_t progress_interval_ms;  // least time between progress reports
+    const uint8_t *cancel;          // may be NULL; set non-zero to stop the search
+} slip39_search_options;
+
+typedef struct slip39_search_result_struct {
+    char passphrase[SEARCH_MAX_PASSPHRASE_LENGTH + 1];  // the passphrase found
+    uint8_t secret[32];             // the master secret it decrypts to
+    uint32_t secret_length;
+    uint64_t tried;                 // number of candidates tried
+    double seconds;                 // time spent
+    double rate;                    // candidates per second
+} slip39_search_result;
+
+/**
+ * returns: the number of candidates a source produces, counting every
+ *          rule variant, or a negative error code (ERROR_INVALID_MASK,
+ *          ERROR_INVALID_RULE) if it is malformed. Counts that do not fit
+ *          in 63 bits are reported as ERROR_INVALID_MASK too.
+ */
+int64_t slip39_source_count(
+    const slip39_passphrase_source *source
+);
+
+/**
+ * search for the passphrase protecting an encrypted master secret
+ * recovered by slip39_recover_ems. Every candidate is decrypted and
+ * handed to verify; the search stops at the first one verify accepts.
+ *
+ * inputs: ems: the encrypted master secret
+ *         source: the candidates to try
+ *         verify: recognizes the right master secret
+ *         verify_context: passed through to verify
+ *         options: may be NULL for the defaults
+ *         result: filled in with the passphrase found and statistics
+ *
+ * returns: 1 if the passphrase was found, 0 if no candidate matched,
+ *          or a negative error code: ERROR_CANCELLED if *options->cancel
+ *          was set, ERROR_INVALID_MASK for a bad source
+ */
+int slip39_search_ems(
+    const slip39_ems *ems,
+    const slip39_passphrase_source *source,
+    slip39_verify_fn verify,
+    void *verify_context,
+    const slip39_search_options *options,
+    slip39_search_result *result
+);
+
+/**
+ * as slip39_search_ems, but only try the candidates numbered begin up to
+ * (not including) end, the numbering slip39_source_count counts. The
+ * tried count and progress reports only cover the range.
+ */
+int slip39_search_ems_range(
+    const slip39_ems *ems,
+    const slip39_passphrase_source *source,
+    uint64_t begin,
+    uint64_t end,
+    slip39_verify_fn verify,
+    void *verify_context,
+    const slip39_search_options *options,
+    slip39_search_result *result
+);
+
+/**
+ * combine a set of mnemonic encoded shards once, then search for the
+ * passphrase as slip39_search_ems does. Takes the shards as
+ * slip39_combine does.
+ *
+ * returns: as slip39_search_ems, or any error slip39_combine can return
+ */
+int slip39_search_passphrase(
+    const uint16_t **mnemonics, // array of pointers to 10-bit words
+    uint32_t mnemonics_words,   // number of words in each shard
+    uint32_t mnemonics_shards,  // total number of shards
+    const char **passwords,     // passwords protecting shards
+    const slip39_passphrase_source *source,
+    slip39_verify_fn verify,
+    void *verify_context,
+    const slip39_search_options *options,
+    slip39_search_result *result
+);
+
+#endif /* SEARCH_H */
@@ -0,0 +1,971 @@
+//
+//  sha256.c
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#include "sha256.h"
+#include "cpu.h"
+
+#include <string.h>
+
+#if !defined(ARDUINO) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA256_X86 1
+#include <immintrin.h>
+#define SHA_NI_TARGET __attribute__((target("sha,sse4.1")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+#define AVX512_TARGET __attribute__((target("avx512f")))
+#endif
+
+// the ARMv8 instructions are only available when the compiler is told
+// to target them (-march=armv8-a+crypto, or the default on Apple arm64)
+#if !defined(ARDUINO) && defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#define SHA256_ARMV8 1
+#include <arm_neon.h>
+#endif
+
+//////////////////////////////////////////////////
+// sha256 compression
+//
+
+static const uint32_t initial_state[SHA256_STATE_WORDS] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SIGMA0(x) (ROTR((x), 2) ^ ROTR((x), 13) ^ ROTR((x), 22))
+#define SIGMA1(x) (ROTR((x), 6) ^ ROTR((x), 11) ^ ROTR((x), 25))
+#define sigma0(x) (ROTR((x), 7) ^ ROTR((x), 18) ^ ((x) >> 3))
+#define sigma1(x) (ROTR((x), 17) ^ ROTR((x), 19) ^ ((x) >> 10))
+
+static void compress_scalar(
+    uint32_t state[SHA256_STATE_WORDS],
+    const uint32_t block[SHA256_BLOCK_WORDS]
+) {
+    uint32_t w[64];
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for(unsigned int i=0; i<16; ++i) {
+        w[i] = block[i];
+    }
+    for(unsigned int i=16; i<64; ++i) {
+        w[i] = sigma1(w[i-2]) + w[i-7] + sigma0(w[i-15]) + w[i-16];
+    }
+
+    for(unsigned int i=0; i<64; ++i) {
+        uint32_t t1 = h + SIGMA1(e) + CH(e, f, g) + K[i] + w[i];
+        uint32_t t2 = SIGMA0(a) + MAJ(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+//////////////////////////////////////////////////
+// pbkdf2 inner loop
+//
+// Each PBKDF2 iteration hashes a 32 byte digest under a fixed HMAC key, so
+// the message block is always the digest followed by the same padding for
+// a 96 byte (block + digest) message. Starting from the midstates that
+// leaves exactly one compression for the inner hash and one for the outer.
+// The padding words are constant, so K[i] + W[i] for rounds 8..15 and the
+// first steps of the schedule fold away at compile time.
+
+#define DIGEST_MESSAGE_BITS ((SHA256_BLOCK_LENGTH + SHA256_DIGEST_LENGTH) * 8)
+
+#define W(i) w[(i) & 15]
+#define EXPAND(i) (W(i) = sigma1(W((i)-2)) + W((i)-7) + sigma0(W((i)-15)) + W(i))
+#define STEP(i, a, b, c, d, e, f, g, h, x) \
+    t1 = h + SIGMA1(e) + CH(e, f, g) + K[i] + (x); \
+    d += t1; \
+    h = t1 + SIGMA0(a) + MAJ(a, b, c)
+#define STEP8(i, X) \
+    STEP((i)+0, a, b, c, d, e, f, g, h, X((i)+0)); \
+    STEP((i)+1, h, a, b, c, d, e, f, g, X((i)+1)); \
+    STEP((i)+2, g, h, a, b, c, d, e, f, X((i)+2)); \
+    STEP((i)+3, f, g, h, a, b, c, d, e, X((i)+3)); \
+    STEP((i)+4, e, f, g, h, a, b, c, d, X((i)+4)); \
+    STEP((i)+5, d, e, f, g, h, a, b, c, X((i)+5)); \
+    STEP((i)+6, c, d, e, f, g, h, a, b, X((i)+6)); \
+    STEP((i)+7, b, c, d, e, f, g, h, a, X((i)+7))
+
+// v = SHA256 compression of (v || padding) starting from state
+static inline void compress_digest(
+    const uint32_t state[SHA256_STATE_WORDS],
+    uint32_t v[SHA256_STATE_WORDS]
+) {
+    uint32_t w[16] = {
+        v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7],
+        0x80000000, 0, 0, 0, 0, 0, 0, DIGEST_MESSAGE_BITS
+    };
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    uint32_t t1;
+
+    STEP8(0, W);
+    STEP8(8, W);
+    STEP8(16, EXPAND);
+    STEP8(24, EXPAND);
+    STEP8(32, EXPAND);
+    STEP8(40, EXPAND);
+    STEP8(48, EXPAND);
+    STEP8(56, EXPAND);
+
+    v[0] = state[0] + a;
+    v[1] = state[1] + b;
+    v[2] = state[2] + c;
+    v[3] = state[3] + d;
+    v[4] = state[4] + e;
+    v[5] = state[5] + f;
+    v[6] = state[6] + g;
+    v[7] = state[7] + h;
+}
+
+static void iterate_scalar(
+    const uint32_t inner[SHA256_STATE_WORDS],
+    const uint32_t outer[SHA256_STATE_WORDS],
+    uint32_t u[SHA256_STATE_WORDS],
+    uint32_t t[SHA256_STATE_WORDS],
+    uint32_t count
+) {
+    // work on locals so the compiler can keep u and t in registers
+    // for the whole loop rather than going back to memory
+    uint32_t v[SHA256_STATE_WORDS];
+    uint32_t x[SHA256_STATE_WORDS];
+    for(unsigned int i=0; i<SHA256_STATE_WORDS; ++i) {
+        v[i] = u[i];
+        x[i] = t[i];
+    }
+
+    for(uint32_t k=0; k<count; ++k) {
+        compress_digest(inner, v);
+        compress_digest(outer, v);
+        for(unsigned int i=0; i<SHA256_STATE_WORDS; ++i) {
+            x[i] ^= v[i];
+        }
+    }
+
+    for(unsigned int i=0; i<SHA256_STATE_WORDS; ++i) {
+        u[i] = v[i];
+        t[i] = x[i];
+    }
+    memset(v, 0, sizeof(v));
+    memset(x, 0, sizeof(x));
+}
+
+//////////////////////////////////////////////////
+// x86 SHA extensions
+//
+// The sha256rnds2 instruction keeps the working variables split across
+// two registers as ABEF and CDGH, so we convert to and from that layout
+// at the edges.
+
+#ifdef SHA256_X86
+
+#define SHA_NI_ROUNDS(q, m) \
+    msg = _mm_add_epi32((m), _mm_loadu_si128((const __m128i *) &K[4*(q)])); \
+    s1 = _mm_sha256rnds2_epu32(s1, s0, msg); \
+    msg = _mm_shuffle_epi32(msg, 0x0e); \
+    s0 = _mm_sha256rnds2_epu32(s0, s1, msg)
+
+// W[i..i+3] from W[i-16..i-1], held in m0..m3, result replaces m0
+#define SHA_NI_SCHEDULE(m0, m1, m2, m3) \
+    m0 = _mm_sha256msg2_epu32( \
+        _mm_add_epi32(_mm_sha256msg1_epu32(m0, m1), _mm_alignr_epi8(m3, m2, 4)), m3)
+
+#define SHA_NI_SCHEDULE_ROUNDS(q) \
+    SHA_NI_SCHEDULE(m0, m1, m2, m3); SHA_NI_ROUNDS((q)+0, m0); \
+    SHA_NI_SCHEDULE(m1, m2, m3, m0); SHA_NI_ROUNDS((q)+1, m1); \
+    SHA_NI_SCHEDULE(m2, m3, m0, m1); SHA_NI_ROUNDS((q)+2, m2); \
+    SHA_NI_SCHEDULE(m3, m0, m1, m2); SHA_NI_ROUNDS((q)+3, m3)
+
+SHA_NI_TARGET
+static inline void shani_load(
+    const uint32_t state[SHA256_STATE_WORDS],
+    __m128i *abef,
+    __m128i *cdgh
+) {
+    __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[0]), 0xb1);
+    __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[4]), 0x1b);
+    *abef = _mm_alignr_epi8(dcba, efgh, 8);
+    *cdgh = _mm_blend_epi16(efgh, dcba, 0xf0);
+}
+
+// back to linear word order: a b c d and e f g h
+SHA_NI_TARGET
+static inline void shani_unpack(
+    __m128i abef,
+    __m128i cdgh,
+    __m128i *abcd,
+    __m128i *efgh
+) {
+    __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+    __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    *abcd = _mm_blend_epi16(feba, dchg, 0xf0);
+    *efgh = _mm_alignr_epi8(dchg, feba, 8);
+}
+
+SHA_NI_TARGET
+static inline void shani_rounds(
+    __m128i *abef,
+    __m128i *cdgh,
+    __m128i m0,
+    __m128i m1,
+    __m128i m2,
+    __m128i m3
+) {
+    __m128i s0 = *abef;
+    __m128i s1 = *cdgh;
+    __m128i msg;
+
+    SHA_NI_ROUNDS(0, m0);
+    SHA_NI_ROUNDS(1, m1);
+    SHA_NI_ROUNDS(2, m2);
+    SHA_NI_ROUNDS(3, m3);
+    SHA_NI_SCHEDULE_ROUNDS(4);
+    SHA_NI_SCHEDULE_ROUNDS(8);
+    SHA_NI_SCHEDULE_ROUNDS(12);
+
+    *abef = _mm_add_epi32(s0, *abef);
+    *cdgh = _mm_add_epi32(s1, *cdgh);
+}
+
+SHA_NI_TARGET
+static void compress_sha_ni(
+    uint32_t state[SHA256_STATE_WORDS],
+    const uint32_t block[SHA256_BLOCK_WORDS]
+) {
+    __m128i abef, cdgh, abcd, efgh;
+
+    shani_load(state, &abef, &cdgh);
+    shani_rounds(&abef, &cdgh,
+        _mm_loadu_si128((const __m128i *) &block[0]),
+        _mm_loadu_si128((const __m128i *) &block[4]),
+        _mm_loadu_si128((const __m128i *) &block[8]),
+        _mm_loadu_si128((const __m128i *) &block[12]));
+    shani_unpack(abef, cdgh, &abcd, &efgh);
+    _mm_storeu_si128((__m128i *) &state[0], abcd);
+    _mm_storeu_si128((__m128i *) &state[4], efgh);
+}
+
+SHA_NI_TARGET
+static void iterate_sha_ni(
+    const uint32_t inner[SHA256_STATE_WORDS],
+    const uint32_t outer[SHA256_STATE_WORDS],
+    uint32_t u[SHA256_STATE_WORDS],
+    uint32_t t[SHA256_STATE_WORDS],
+    uint32_t count
+) {
+    __m128i inner_abef, inner_cdgh, outer_abef, outer_cdgh;
+    const __m128i pad0 = _mm_set_epi32(0, 0, 0, 0x80000000);
+    const __m128i pad1 = _mm_set_epi32(DIGEST_MESSAGE_BITS, 0, 0, 0);
+    __m128i v0 = _mm_loadu_si128((const __m128i *) &u[0]);
+    __m128i v1 = _mm_loadu_si128((const __m128i *) &u[4]);
+    __m128i x0 = _mm_loadu_si128((const __m128i *) &t[0]);
+    __m128i x1 = _mm_loadu_si128((const __m128i *) &t[4]);
+
+    shani_load(inner, &inner_abef, &inner_cdgh);
+    shani_load(outer, &outer_abef, &outer_cdgh);
+
+    for(uint32_t k=0; k<count; ++k) {
+        __m128i abef = inner_abef;
+        __m128i cdgh = inner_cdgh;
+        shani_rounds(&abef, &cdgh, v0, v1, pad0, pad1);
+        shani_unpack(abef, cdgh, &v0, &v1);
+
+        abef = outer_abef;
+        cdgh = outer_cdgh;
+        shani_rounds(&abef, &cdgh, v0, v1, pad0, pad1);
+        shani_unpack(abef, cdgh, &v0, &v1);
+
+        x0 = _mm_xor_si128(x0, v0);
+        x1 = _mm_xor_si128(x1, v1);
+    }
+
+    _mm_storeu_si128((__m128i *) &u[0], v0);
+    _mm_storeu_si128((__m128i *) &u[4], v1);
+    _mm_storeu_si128((__m128i *) &t[0], x0);
+    _mm_storeu_si128((__m128i *) &t[4], x1);
+}
+
+#endif /* SHA256_X86 */
+
+//////////////////////////////////////////////////
+// ARMv8 cryptography extensions
+//
+
+#ifdef SHA256_ARMV8
+
+#define ARMV8_ROUNDS(q, m) \
+    wk = vaddq_u32((m), vld1q_u32(&K[4*(q)])); \
+    tmp = s0; \
+    s0 = vsha256hq_u32(s0, s1, wk); \
+    s1 = vsha256h2q_u32(s1, tmp, wk)
+
+#define ARMV8_SCHEDULE(m0, m1, m2, m3) \
+    m0 = vsha256su1q_u32(vsha256su0q_u32(m0, m1), m2, m3)
+
+#define ARMV8_SCHEDULE_ROUNDS(q) \
+    ARMV8_SCHEDULE(m0, m1, m2, m3); ARMV8_ROUNDS((q)+0, m0); \
+    ARMV8_SCHEDULE(m1, m2, m3, m0); ARMV8_ROUNDS((q)+1, m1); \
+    ARMV8_SCHEDULE(m2, m3, m0, m1); ARMV8_ROUNDS((q)+2, m2); \
+    ARMV8_SCHEDULE(m3, m0, m1, m2); ARMV8_ROUNDS((q)+3, m3)
+
+static inline void armv8_rounds(
+    uint32x4_t *abcd,
+    uint32x4_t *efgh,
+    uint32x4_t m0,
+    uint32x4_t m1,
+    uint32x4_t m2,
+    uint32x4_t m3
+) {
+    uint32x4_t s0 = *abcd;
+    uint32x4_t s1 = *efgh;
+    uint32x4_t wk, tmp;
+
+    ARMV8_ROUNDS(0, m0);
+    ARMV8_ROUNDS(1, m1);
+    ARMV8_ROUNDS(2, m2);
+    ARMV8_ROUNDS(3, m3);
+    ARMV8_SCHEDULE_ROUNDS(4);
+    ARMV8_SCHEDULE_ROUNDS(8);
+    ARMV8_SCHEDULE_ROUNDS(12);
+
+    *abcd = vaddq_u32(s0, *abcd);
+    *efgh = vaddq_u32(s1, *efgh);
+}
+
+static void compress_armv8(
+    uint32_t state[SHA256_STATE_WORDS],
+    const uint32_t block[SHA256_BLOCK_WORDS]
+) {
+    uint32x4_t abcd = vld1q_u32(&state[0]);
+    uint32x4_t efgh = vld1q_u32(&state[4]);
+
+    armv8_rounds(&abcd, &efgh,
+        vld1q_u32(&block[0]), vld1q_u32(&block[4]),
+        vld1q_u32(&block[8]), vld1q_u32(&block[12]));
+
+    vst1q_u32(&state[0], abcd);
+    vst1q_u32(&state[4], efgh);
+}
+
+static void iterate_armv8(
+    const uint32_t inner[SHA256_STATE_WORDS],
+    const uint32_t outer[SHA256_STATE_WORDS],
+    uint32_t u[SHA256_STATE_WORDS],
+    uint32_t t[SHA256_STATE_WORDS],
+    uint32_t count
+) {
+    static const uint32_t padding[8] = {
+        0x80000000, 0, 0, 0, 0, 0, 0, DIGEST_MESSAGE_BITS
+    };
+    const uint32x4_t pad0 = vld1q_u32(&padding[0]);
+    const uint32x4_t pad1 = vld1q_u32(&padding[4]);
+    const uint32x4_t inner0 = vld1q_u32(&inner[0]);
+    const uint32x4_t inner1 = vld1q_u32(&inner[4]);
+    const uint32x4_t outer0 = vld1q_u32(&outer[0]);
+    const uint32x4_t outer1 = vld1q_u32(&outer[4]);
+    uint32x4_t v0 = vld1q_u32(&u[0]);
+    uint32x4_t v1 = vld1q_u32(&u[4]);
+    uint32x4_t x0 = vld1q_u32(&t[0]);
+    uint32x4_t x1 = vld1q_u32(&t[4]);
+
+    for(uint32_t k=0; k<count; ++k) {
+        uint32x4_t s0 = inner0;
+        uint32x4_t s1 = inner1;
+        armv8_rounds(&s0, &s1, v0, v1, pad0, pad1);
+        v0 = outer0;
+        v1 = outer1;
+        armv8_rounds(&v0, &v1, s0, s1, pad0, pad1);
+        x0 = veorq_u32(x0, v0);
+        x1 = veorq_u32(x1, v1);
+    }
+
+    vst1q_u32(&u[0], v0);
+    vst1q_u32(&u[4], v1);
+    vst1q_u32(&t[0], x0);
+    vst1q_u32(&t[4], x1);
+}
+
+#endif /* SHA256_ARMV8 */
+
+//////////////////////////////////////////////////
+// multi-buffer kernels
+//
+// Independent PBKDF2 chains, one per vector lane. The lanes are held
+// transposed, so vector j holds word j of every lane, and each round is
+// the scalar round done with vector operations. Lanes that have run all
+// of their iterations keep computing but stop accumulating into t.
+
+#ifdef SHA256_X86
+
+#define MB_STEP(i, a, b, c, d, e, f, g, h, x) \
+    t1 = V_ADD(V_ADD(V_ADD(h, V_SIGMA1(e)), V_ADD(V_CH(e, f, g), V_SET1(K[i]))), (x)); \
+    d = V_ADD(d, t1); \
+    h = V_ADD(t1, V_ADD(V_SIGMA0(a), V_MAJ(a, b, c)))
+#define MB_W(i) w[(i) & 15]
+#define MB_EXPAND(i) (MB_W(i) = V_ADD(V_ADD(V_sigma1(MB_W((i)-2)), MB_W((i)-7)), \
+                                      V_ADD(V_sigma0(MB_W((i)-15)), MB_W(i))))
+#define MB_STEP8(i, X) \
+    MB_STEP((i)+0, a, b, c, d, e, f, g, h, X((i)+0)); \
+    MB_STEP((i)+1, h, a, b, c, d, e, f, g, X((i)+1)); \
+    MB_STEP((i)+2, g, h, a, b, c, d, e, f, X((i)+2)); \
+    MB_STEP((i)+3, f, g, h, a, b, c, d, e, X((i)+3)); \
+    MB_STEP((i)+4, e, f, g, h, a, b, c, d, X((i)+4)); \
+    MB_STEP((i)+5, d, e, f, g, h, a, b, c, X((i)+5)); \
+    MB_STEP((i)+6, c, d, e, f, g, h, a, b, X((i)+6)); \
+    MB_STEP((i)+7, b, c, d, e, f, g, h, a, X((i)+7))
+
+// v = compression of (v || padding) from state, in every lane at once
+#define MB_COMPRESS_DIGEST(VEC, state, v) do { \
+    VEC w[16] = { \
+        v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], \
+        V_SET1(0x80000000), V_SET1(0), V_SET1(0), V_SET1(0), \
+        V_SET1(0), V_SET1(0), V_SET1(0), V_SET1(DIGEST_MESSAGE_BITS) \
+    }; \
+    VEC a = state[0], b = state[1], c = state[2], d = state[3]; \
+    VEC e = state[4], f = state[5], g = state[6], h = state[7]; \
+    VEC t1; \
+    MB_STEP8(0, MB_W); \
+    MB_STEP8(8, MB_W); \
+    MB_STEP8(16, MB_EXPAND); \
+    MB_STEP8(24, MB_EXPAND); \
+    MB_STEP8(32, MB_EXPAND); \
+    MB_STEP8(40, MB_EXPAND); \
+    MB_STEP8(48, MB_EXPAND); \
+    MB_STEP8(56, MB_EXPAND); \
+    v[0] = V_ADD(state[0], a); \
+    v[1] = V_ADD(state[1], b); \
+    v[2] = V_ADD(state[2], c); \
+    v[3] = V_ADD(state[3], d); \
+    v[4] = V_ADD(state[4], e); \
+    v[5] = V_ADD(state[5], f); \
+    v[6] = V_ADD(state[6], g); \
+    v[7] = V_ADD(state[7], h); \
+} while(0)
+
+// gather word j of each lane into one vector, unused lanes get zeros
+static void mb_transpose_in(
+    const slip39_hmac_sha256_lane *lanes,
+    uint32_t lane_count,
+    uint32_t width,
+    uint32_t words[SHA256_STATE_WORDS][SHA256_MAX_LANES],
+    uint8_t which
+) {
+    memset(words, 0, sizeof(uint32_t) * SHA256_STATE_WORDS * SHA256_MAX_LANES);
+    for(uint32_t l=0; l<lane_count && l<width; ++l) {
+        const uint32_t *src =
+            which == 0 ? lanes[l].inner :
+            which == 1 ? lanes[l].outer :
+            which == 2 ? lanes[l].u : lanes[l].t;
+        for(unsigned int j=0; j<SHA256_STATE_WORDS; ++j) {
+            words[j][l] = src[j];
+        }
+    }
+}
+
+static void mb_transpose_out(
+    slip39_hmac_sha256_lane *lanes,
+    uint32_t lane_count,
+    uint32_t width,
+    uint32_t u[SHA256_STATE_WORDS][SHA256_MAX_LANES],
+    uint32_t t[SHA256_STATE_WORDS][SHA256_MAX_LANES]
+) {
+    for(uint32_t l=0; l<lane_count && l<width; ++l) {
+        for(unsigned int j=0; j<SHA256_STATE_WORDS; ++j) {
+            lanes[l].u[j] = u[j][l];
+            lanes[l].t[j] = t[j][l];
+        }
+    }
+}
+
+// AVX2, 8 lanes
+
+#define V_ADD(x, y) _mm256_add_epi32((x), (y))
+#define V_SET1(x) _mm256_set1_epi32((int)(x))
+#define V_ROR(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define V_CH(x, y, z) _mm256_xor_si256(_mm256_and_si256((x), (y)), _mm256_andnot_si256((x), (z)))
+#define V_MAJ(x, y, z) _mm256_or_si256(_mm256_and_si256((x), (y)), _mm256_and_si256((z), _mm256_or_si256((x), (y))))
+#define V_XOR3(x, y, z) _mm256_xor_si256(_mm256_xor_si256((x), (y)), (z))
+#define V_SIGMA0(x) V_XOR3(V_ROR((x), 2), V_ROR((x), 13), V_ROR((x), 22))
+#define V_SIGMA1(x) V_XOR3(V_ROR((x), 6), V_ROR((x), 11), V_ROR((x), 25))
+#define V_sigma0(x) V_XOR3(V_ROR((x), 7), V_ROR((x), 18), _mm256_srli_epi32((x), 3))
+#define V_sigma1(x) V_XOR3(V_ROR((x), 17), V_ROR((x), 19), _mm256_srli_epi32((x), 10))
+
+AVX2_TARGET
+static inline void avx2_compress_digest(const __m256i state[SHA256_STATE_WORDS], __m256i v[SHA256_STATE_WORDS]) {
+    MB_COMPRESS_DIGEST(__m256i, state, v);
+}
+
+AVX2_TARGET
+static void iterate_many_avx2(
+    slip39_hmac_sha256_lane *lanes,
+    uint32_t lane_count
+) {
+    uint32_t words[SHA256_STATE_WORDS][SHA256_MAX_LANES];
+    uint32_t counts[SHA256_MAX_LANES] = {0};
+    __m256i inner[8], outer[8], v[8], x[8];
+    uint32_t max_count = 0;
+
+    mb_transpose_in(lanes, lane_count, 8, words, 0);
+    for(unsigned int j=0; j<8; ++j) inner[j] = _mm256_loadu_si256((const __m256i *) words[j]);
+    mb_transpose_in(lanes, lane_count, 8, words, 1);
+    for(unsigned int j=0; j<8; ++j) outer[j] = _mm256_loadu_si256((const __m256i *) words[j]);
+    mb_transpose_in(lanes, lane_count, 8, words, 2);
+    for(unsigned int j=0; j<8; ++j) v[j] = _mm256_loadu_si256((const __m256i *) words[j]);
+    mb_transpose_in(lanes, lane_count, 8, words, 3);
+    for(unsigned int j=0; j<8; ++j) x[j] = _mm256_loadu_si256((const __m256i *) words[j]);
+
+    for(uint32_t l=0; l<lane_count && l<8; ++l) {
+        counts[l] = lanes[l].count;
+        if(counts[l] > max_count) {
+            max_count = counts[l];
+        }
+    }
+
+    // avx2 only has signed compares, so bias both sides
+    const __m256i bias = _mm256_set1_epi32((int)0x80000000);
+    const __m256i biased_counts = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) counts), bias);
+
+    for(uint32_t k=0; k<max_count; ++k) {
+        __m256i active = _mm256_cmpgt_epi32(biased_counts, _mm256_xor_si256(_mm256_set1_epi32((int)k), bias));
+        __m256i next[8];
+        for(unsigned int j=0; j<8; ++j) next[j] = v[j];
+        avx2_compress_digest(inner, next);
+        avx2_compress_digest(outer, next);
+        // lanes that have run their count keep both u and t as they were
+        for(unsigned int j=0; j<8; ++j) {
+            v[j] = _mm256_blendv_epi8(v[j], next[j], active);
+            x[j] = _mm256_xor_si256(x[j], _mm256_and_si256(v[j], active));
+        }
+    }
+
+    uint32_t t[SHA256_STATE_WORDS][SHA256_MAX_LANES];
+    for(unsigned int j=0; j<8; ++j) {
+        _mm256_storeu_si256((__m256i *) words[j], v[j]);
+        _mm256_storeu_si256((__m256i *) t[j], x[j]);
+    }
+    mb_transpose_out(lanes, lane_count, 8, words, t);
+
+    memset(words, 0, sizeof(words));
+    memset(t, 0, sizeof(t));
+}
+
+#undef V_ADD
+#undef V_SET1
+#undef V_ROR
+#undef V_CH
+#undef V_MAJ
+#undef V_XOR3
+#undef V_SIGMA0
+#undef V_SIGMA1
+#undef V_sigma0
+#undef V_sigma1
+
+// AVX-512, 16 lanes, with native rotates and three-input logic
+
+#define V_ADD(x, y) _mm512_add_epi32((x), (y))
+#define V_SET1(x) _mm512_set1_epi32((int)(x))
+#define V_ROR(x, n) _mm512_ror_epi32((x), (n))
+#define V_CH(x, y, z) _mm512_ternarylogic_epi32((x), (y), (z), 0xca)
+#define V_MAJ(x, y, z) _mm512_ternarylogic_epi32((x), (y), (z), 0xe8)
+#define V_XOR3(x, y, z) _mm512_ternarylogic_epi32((x), (y), (z), 0x96)
+#define V_SIGMA0(x) V_XOR3(V_ROR((x), 2), V_ROR((x), 13), V_ROR((x), 22))
+#define V_SIGMA1(x) V_XOR3(V_ROR((x), 6), V_ROR((x), 11), V_ROR((x), 25))
+#define V_sigma0(x) V_XOR3(V_ROR((x), 7), V_ROR((x), 18), _mm512_srli_epi32((x), 3))
+#define V_sigma1(x) V_XOR3(V_ROR((x), 17), V_ROR((x), 19), _mm512_srli_epi32((x), 10))
+
+AVX512_TARGET
+static inline void avx512_compress_digest(const __m512i state[SHA256_STATE_WORDS], __m512i v[SHA256_STATE_WORDS]) {
+    MB_COMPRESS_DIGEST(__m512i, state, v);
+}
+
+AVX512_TARGET
+static void iterate_many_avx512(
+    slip39_hmac_sha256_lane *lanes,
+    uint32_t lane_count
+) {
+    uint32_t words[SHA256_STATE_WORDS][SHA256_MAX_LANES];
+    uint32_t counts[SHA256_MAX_LANES] = {0};
+    __m512i inner[8], outer[8], v[8], x[8];
+    uint32_t max_count = 0;
+
+    mb_transpose_in(lanes, lane_count, 16, words, 0);
+    for(unsigned int j=0; j<8; ++j) inner[j] = _mm512_loadu_si512(words[j]);
+    mb_transpose_in(lanes, lane_count, 16, words, 1);
+    for(unsigned int j=0; j<8; ++j) outer[j] = _mm512_loadu_si512(words[j]);
+    mb_transpose_in(lanes, lane_count, 16, words, 2);
+    for(unsigned int j=0; j<8; ++j) v[j] = _mm512_loadu_si512(words[j]);
+    mb_transpose_in(lanes, lane_count, 16, words, 3);
+    for(unsigned int j=0; j<8; ++j) x[j] = _mm512_loadu_si512(words[j]);
+
+    for(uint32_t l=0; l<lane_count && l<16; ++l) {
+        counts[l] = lanes[l].count;
+        if(counts[l] > max_count) {
+            max_count = counts[l];
+        }
+    }
+    const __m512i lane_counts = _mm512_loadu_si512(counts);
+
+    for(uint32_t k=0; k<max_count; ++k) {
+        __mmask16 active = _mm512_cmpgt_epu32_mask(lane_counts, _mm512_set1_epi32((int)k));
+        __m512i next[8];
+        for(unsigned int j=0; j<8; ++j) next[j] = v[j];
+        avx512_compress_digest(inner, next);
+        avx512_compress_digest(outer, next);
+        // lanes that have run their count keep both u and t as they were
+        for(unsigned int j=0; j<8; ++j) {
+            v[j] = _mm512_mask_mov_epi32(v[j], active, next[j]);
+            x[j] = _mm512_mask_xor_epi32(x[j], active, x[j], v[j]);
+        }
+    }
+
+    uint32_t t[SHA256_STATE_WORDS][SHA256_MAX_LANES];
+    for(unsigned int j=0; j<8; ++j) {
+        _mm512_storeu_si512(words[j], v[j]);
+        _mm512_storeu_si512(t[j], x[j]);
+    }
+    mb_transpose_out(lanes, lane_count, 16, words, t);
+
+    memset(words, 0, sizeof(words));
+    memset(t, 0, sizeof(t));
+}
+
+#undef V_ADD
+#undef V_SET1
+#undef V_ROR
+#undef V_CH
+#undef V_MAJ
+#undef V_XOR3
+#undef V_SIGMA0
+#undef V_SIGMA1
+#undef V_sigma0
+#undef V_sigma1
+
+#endif /* SHA256_X86 */
+
+//////////////////////////////////////////////////
+// backend dispatch
+//
+
+// in increasing order of preference
+static const slip39_sha256_backend backends[] = {
+    { "scalar", 0, compress_scalar, iterate_scalar },
+#ifdef SHA256_X86
+    { "sha-ni", SLIP39_CPU_SHA_NI, compress_sha_ni, iterate_sha_ni },
+#endif
+#ifdef SHA256_ARMV8
+    { "armv8", SLIP39_CPU_ARMV8_SHA2, compress_armv8, iterate_armv8 },
+#endif
+};
+
+#define BACKEND_COUNT (sizeof(backends) / sizeof(backends[0]))
+
+// read by search workers while another thread may select a backend, so
+// every access is atomic
+static const slip39_sha256_backend *selected_backend = NULL;
+
+static const slip39_sha256_backend *best_backend(void) {
+    const slip39_sha256_backend *best = &backends[0];
+    for(uint32_t i=1; i<BACKEND_COUNT; ++i) {
+        if(slip39_sha256_backend_supported(&backends[i])) {
+            best = &backends[i];
+        }
+    }
+    return best;
+}
+
+uint32_t slip39_sha256_backend_count(void) {
+    return BACKEND_COUNT;
+}
+
+const slip39_sha256_backend *slip39_sha256_backend_at(uint32_t index) {
+    if(index >= BACKEND_COUNT) {
+        return NULL;
+    }
+    return &backends[index];
+}
+
+uint8_t slip39_sha256_backend_supported(const slip39_sha256_backend *backend) {
+    uint32_t features = slip39_cpu_features();
+    return (backend->required_features & features) == backend->required_features;
+}
+
+const slip39_sha256_backend *slip39_sha256_backend_current(void) {
+    const slip39_sha256_backend *backend = __atomic_load_n(&selected_backend, __ATOMIC_ACQUIRE);
+    if(!backend) {
+        backend = best_backend();
+        __atomic_store_n(&selected_backend, backend, __ATOMIC_RELEASE);
+    }
+    return backend;
+}
+
+uint8_t slip39_sha256_backend_select(const slip39_sha256_backend *backend) {
+    if(!backend) {
+        __atomic_store_n(&selected_backend, best_backend(), __ATOMIC_RELEASE);
+        return 1;
+    }
+    if(!slip39_sha256_backend_supported(backend)) {
+        return 0;
+    }
+    __atomic_store_n(&selected_backend, backend, __ATOMIC_RELEASE);
+    return 1;
+}
+
+void slip39_sha256_compress(
+    uint32_t state[SHA256_STATE_WORDS],
+    const uint32_t block[SHA256_BLOCK_WORDS]
+) {
+    slip39_sha256_backend_current()->compress(state, block);
+}
+
+void slip39_hmac_sha256_iterate(
+    const uint32_t inner[SHA256_STATE_WORDS],
+    const uint32_t outer[SHA256_STATE_WORDS],
+    uint32_t u[SHA256_STATE_WORDS],
+    uint32_t t[SHA256_STATE_WORDS],
+    uint32_t count
+) {
+    slip39_sha256_backend_current()->iterate(inner, outer, u, t, count);
+}
+
+//////////////////////////////////////////////////
+// multi-buffer dispatch
+//
+
+// 0 means not chosen yet; atomic for the same reason as selected_backend
+static uint32_t selected_lane_width = 0;
+
+static uint8_t lane_width_supported(uint32_t width) {
+    uint32_t features = slip39_cpu_features();
+    switch(width) {
+        case 1:
+            return 1;
+#ifdef SHA256_X86
+        case 8:
+            return (features & SLIP39_CPU_AVX2) != 0;
+        case 16:
+            return (features & SLIP39_CPU_AVX512) != 0;
+#endif
+        default:
+            return 0;
+    }
+}
+
+static uint32_t best_lane_width(void) {
+    if(lane_width_supported(16)) {
+        return 16;
+    }
+    // a single SHA-NI chain runs faster than an eighth of the AVX2 kernel
+    if(lane_width_supported(8) && !(slip39_cpu_features() & SLIP39_CPU_SHA_NI)) {
+        return 8;
+    }
+    return 1;
+}
+
+uint32_t slip39_sha256_lane_width(void) {
+    uint32_t width = __atomic_load_n(&selected_lane_width, __ATOMIC_ACQUIRE);
+    if(!width) {
+        width = best_lane_width();
+        __atomic_store_n(&selected_lane_width, width, __ATOMIC_RELEASE);
+    }
+    return width;
+}
+
+uint8_t slip39_sha256_select_lane_width(uint32_t width) {
+    if(!width) {
+        __atomic_store_n(&selected_lane_width, best_lane_width(), __ATOMIC_RELEASE);
+        return 1;
+    }
+    if(!lane_width_supported(width)) {
+        return 0;
+    }
+    __atomic_store_n(&selected_lane_width, width, __ATOMIC_RELEASE);
+    return 1;
+}
+
+void slip39_hmac_sha256_iterate_many(
+    slip39_hmac_sha256_lane *lanes,
+    uint32_t lane_count
+) {
+    uint32_t width = slip39_sha256_lane_width();
+
+    // a lone chain gains nothing from the vector kernels
+    while(lane_count > 1 && width > 1) {
+        uint32_t n = lane_count < width ? lane_count : width;
+#ifdef SHA256_X86
+        if(width == 16) {
+            iterate_many_avx512(lanes, n);
+        } else {
+            iterate_many_avx2(lanes, n);
+        }
+#endif
+        lanes += n;
+        lane_count -= n;
+    }
+
+    const slip39_sha256_backend *backend = slip39_sha256_backend_current();
+    for(uint32_t l=0; l<lane_count; ++l) {
+        backend->iterate(lanes[l].inner, lanes[l].outer, lanes[l].u, lanes[l].t, lanes[l].count);
+    }
+}
+
+//////////////////////////////////////////////////
+// streaming interface
+//
+
+static void compress_bytes(
+    uint32_t state[SHA256_STATE_WORDS],
+    const uint8_t *bytes
+) {
+    uint32_t block[SHA256_BLOCK_WORDS];
+    for(unsigned int i=0; i<SHA256_BLOCK_WORDS; ++i) {
+        block[i] = (uint32_t)bytes[4*i] << 24 | (uint32_t)bytes[4*i+1] << 16 |
+                   (uint32_t)bytes[4*i+2] << 8 | (uint32_t)bytes[4*i+3];
+    }
+    slip39_sha256_compress(state, block);
+    memset(block, 0, sizeof(block));
+}
+
+void slip39_sha256_init(slip39_sha256_ctx *ctx) {
+    slip39_sha256_resume(ctx, initial_state, 0);
+}
+
+void slip39_sha256_resume(
+    slip39_sha256_ctx *ctx,
+    const uint32_t state[SHA256_STATE_WORDS],
+    uint64_t length
+) {
+    memcpy(ctx->state, state, sizeof(ctx->state));
+    memset(ctx->buffer, 0, sizeof(ctx->buffer));
+    ctx->length = length;
+}
+
+void slip39_sha256_update(
+    slip39_sha256_ctx *ctx,
+    const uint8_t *data,
+    uint32_t data_length
+) {
+    uint32_t used = ctx->length % SHA256_BLOCK_LENGTH;
+    ctx->length += data_length;
+
+    while(data_length > 0) {
+        uint32_t n = SHA256_BLOCK_LENGTH - used;
+        if(n > data_length) {
+            n = data_length;
+        }
+        memcpy(ctx->buffer + used, data, n);
+        used += n;
+        data += n;
+        data_length -= n;
+
+        if(used == SHA256_BLOCK_LENGTH) {
+            compress_bytes(ctx->state, ctx->buffer);
+            used = 0;
+        }
+    }
+}
+
+void slip39_sha256_final(
+    slip39_sha256_ctx *ctx,
+    uint32_t digest[SHA256_STATE_WORDS]
+) {
+    uint32_t used = ctx->length % SHA256_BLOCK_LENGTH;
+    uint64_t bit_length = ctx->length * 8;
+
+    ctx->buffer[used++] = 0x80;
+    if(used > SHA256_BLOCK_LENGTH - 8) {
+        memset(ctx->buffer + used, 0, SHA256_BLOCK_LENGTH - used);
+        compress_bytes(ctx->state, ctx->buffer);
+        used = 0;
+    }
+    memset(ctx->buffer + used, 0, SHA256_BLOCK_LENGTH - 8 - used);
+    for(unsigned int i=0; i<8; ++i) {
+        ctx->buffer[SHA256_BLOCK_LENGTH - 1 - i] = (uint8_t)(bit_length >> (8*i));
+    }
+    compress_bytes(ctx->state, ctx->buffer);
+
+    memcpy(digest, ctx->state, sizeof(ctx->state));
+    memset(ctx, 0, sizeof(slip39_sha256_ctx));
+}
+
+void slip39_sha256_store(
+    const uint32_t *words,
+    uint8_t *bytes,
+    uint32_t length
+) {
+    for(uint32_t i=0; i<length; ++i) {
+        bytes[i] = (uint8_t)(words[i/4] >> (24 - 8*(i%4)));
+    }
+}
+
+//////////////////////////////////////////////////
+// hmac key schedule
+//
+void slip39_hmac_sha256_prepare(
+    const uint8_t *key,
+    uint32_t key_length,
+    uint32_t inner[SHA256_STATE_WORDS],
+    uint32_t outer[SHA256_STATE_WORDS]
+) {
+    uint8_t pad[SHA256_BLOCK_LENGTH];
+    memset(pad, 0, sizeof(pad));
+
+    // keys longer than a block are replaced by their digest
+    if(key_length > SHA256_BLOCK_LENGTH) {
+        slip39_sha256_ctx ctx;
+        uint32_t digest[SHA256_STATE_WORDS];
+        slip39_sha256_init(&ctx);
+        slip39_sha256_update(&ctx, key, key_length);
+        slip39_sha256_final(&ctx, digest);
+        slip39_sha256_store(digest, pad, SHA256_DIGEST_LENGTH);
+        memset(digest, 0, sizeof(digest));
+    } else {
+        memcpy(pad, key, key_length);
+    }
+
+    for(unsigned int i=0; i<SHA256_BLOCK_LENGTH; ++i) {
+        pad[i] ^= 0x36;
+    }
+    memcpy(inner, initial_state, sizeof(initial_state));
+    compress_bytes(inner, pad);
+
+    for(unsigned int i=0; i<SHA256_BLOCK_LENGTH; ++i) {
+        pad[i] ^= 0x36 ^ 0x5c;
+    }
+    memcpy(outer, initial_state, sizeof(initial_state));
+    compress_bytes(outer, pad);
+
+    memset(pad, 0, sizeof(pad));
+}
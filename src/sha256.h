@@ -0,0 +1,201 @@
+//
+//  sha256.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stdint.h>
+
+#define SHA256_BLOCK_LENGTH 64
+#define SHA256_DIGEST_LENGTH 32
+#define SHA256_STATE_WORDS 8
+#define SHA256_BLOCK_WORDS 16
+
+/**
+ * a minimal streaming SHA-256, used by the key derivation in encrypt.c
+ * where we need access to intermediate (midstate) values that the
+ * bc-crypto-base interface does not expose.
+ *
+ * state and digests are kept as big-endian 32 bit words, which is the
+ * form the compression function works with.
+ */
+typedef struct slip39_sha256_ctx_struct {
+    uint32_t state[SHA256_STATE_WORDS];
+    uint8_t buffer[SHA256_BLOCK_LENGTH];
+    uint64_t length;    // total number of bytes absorbed so far
+} slip39_sha256_ctx;
+
+/**
+ * an implementation of the SHA-256 compression function and of the PBKDF2
+ * inner loop built on it. The library picks the fastest one the processor
+ * supports on first use, see slip39_sha256_backend_current.
+ */
+typedef struct slip39_sha256_backend_struct {
+    const char *name;
+    uint32_t required_features;     // SLIP39_CPU_* flags, see cpu.h
+    void (*compress)(uint32_t state[SHA256_STATE_WORDS], const uint32_t block[SHA256_BLOCK_WORDS]);
+    void (*iterate)(const uint32_t inner[SHA256_STATE_WORDS], const uint32_t outer[SHA256_STATE_WORDS],
+        uint32_t u[SHA256_STATE_WORDS], uint32_t t[SHA256_STATE_WORDS], uint32_t count);
+} slip39_sha256_backend;
+
+/**
+ * returns: the number of backends compiled into the library, whether or
+ *          not this processor supports them
+ */
+uint32_t slip39_sha256_backend_count(void);
+
+/**
+ * returns: the backend at index, or NULL if index is out of range
+ */
+const slip39_sha256_backend *slip39_sha256_backend_at(uint32_t index);
+
+/**
+ * returns: 1 if the processor can run the backend, 0 otherwise
+ */
+uint8_t slip39_sha256_backend_supported(const slip39_sha256_backend *backend);
+
+/**
+ * returns: the backend used by slip39_sha256_compress and
+ *          slip39_hmac_sha256_iterate, choosing one if none has been yet
+ */
+const slip39_sha256_backend *slip39_sha256_backend_current(void);
+
+/**
+ * force the use of a particular backend, mostly useful for testing and
+ * benchmarking. Passing NULL goes back to automatic selection.
+ *
+ * returns: 1 if the backend is now in use, 0 if this processor does not
+ *          support it
+ */
+uint8_t slip39_sha256_backend_select(const slip39_sha256_backend *backend);
+
+/**
+ * run the SHA-256 compression function over one 64 byte block
+ *
+ * inputs: state: the 8 word chaining value, updated in place
+ *         block: the 16 message words of the block
+ */
+void slip39_sha256_compress(
+    uint32_t state[SHA256_STATE_WORDS],
+    const uint32_t block[SHA256_BLOCK_WORDS]
+);
+
+void slip39_sha256_init(slip39_sha256_ctx *ctx);
+
+/**
+ * start a hash from a previously captured midstate
+ *
+ * inputs: state: chaining value after absorbing length bytes
+ *         length: number of bytes already absorbed (a multiple of 64)
+ */
+void slip39_sha256_resume(
+    slip39_sha256_ctx *ctx,
+    const uint32_t state[SHA256_STATE_WORDS],
+    uint64_t length
+);
+
+void slip39_sha256_update(
+    slip39_sha256_ctx *ctx,
+    const uint8_t *data,
+    uint32_t data_length
+);
+
+void slip39_sha256_final(
+    slip39_sha256_ctx *ctx,
+    uint32_t digest[SHA256_STATE_WORDS]
+);
+
+/**
+ * serialize big-endian words to bytes
+ *
+ * inputs: words: the words to serialize
+ *         bytes: destination
+ *         length: number of bytes to write, may stop in the middle of a word
+ */
+void slip39_sha256_store(
+    const uint32_t *words,
+    uint8_t *bytes,
+    uint32_t length
+);
+
+/**
+ * compute the HMAC-SHA256 inner and outer midstates for a key, that is
+ * the chaining values after compressing (key ^ ipad) and (key ^ opad).
+ * every HMAC with this key can start from these instead of redoing the
+ * key schedule.
+ *
+ * inputs: key: the HMAC key
+ *         key_length: length of the key in bytes
+ *         inner: location to store the inner midstate
+ *         outer: location to store the outer midstate
+ */
+void slip39_hmac_sha256_prepare(
+    const uint8_t *key,
+    uint32_t key_length,
+    uint32_t inner[SHA256_STATE_WORDS],
+    uint32_t outer[SHA256_STATE_WORDS]
+);
+
+/**
+ * the PBKDF2-HMAC-SHA256 inner loop: count times replace u with
+ * HMAC(key, u) and xor the result into t, where the key is given by its
+ * inner and outer midstates. u and t are big-endian words.
+ */
+void slip39_hmac_sha256_iterate(
+    const uint32_t inner[SHA256_STATE_WORDS],
+    const uint32_t outer[SHA256_STATE_WORDS],
+    uint32_t u[SHA256_STATE_WORDS],
+    uint32_t t[SHA256_STATE_WORDS],
+    uint32_t count
+);
+
+/**
+ * one independent PBKDF2 chain for slip39_hmac_sha256_iterate_many.
+ * the chain runs count iterations of the same step as
+ * slip39_hmac_sha256_iterate, updating u and t.
+ */
+typedef struct slip39_hmac_sha256_lane_struct {
+    const uint32_t *inner;
+    const uint32_t *outer;
+    uint32_t u[SHA256_STATE_WORDS];
+    uint32_t t[SHA256_STATE_WORDS];
+    uint32_t count;
+} slip39_hmac_sha256_lane;
+
+// the widest multi-buffer kernel, in lanes
+#define SHA256_MAX_LANES 16
+
+/**
+ * run many independent PBKDF2 chains, several at a time in the lanes of
+ * the widest vector unit available (AVX2: 8, AVX-512: 16). Each group of
+ * lanes runs for as long as its longest chain, so chains of equal count
+ * make the best use of it.
+ *
+ * inputs: lanes: the chains, updated in place
+ *         lane_count: number of entries in lanes
+ */
+void slip39_hmac_sha256_iterate_many(
+    slip39_hmac_sha256_lane *lanes,
+    uint32_t lane_count
+);
+
+/**
+ * returns: the number of chains slip39_hmac_sha256_iterate_many runs side
+ *          by side, choosing it if that has not happened yet. 1 means
+ *          chains run one after the other on the current backend.
+ */
+uint32_t slip39_sha256_lane_width(void);
+
+/**
+ * force the multi-buffer width (1, 8 or 16), mostly useful for testing
+ * and benchmarking. Passing 0 goes back to automatic selection.
+ *
+ * returns: 1 if the width is now in use, 0 if this processor cannot run it
+ */
+uint8_t slip39_sha256_select_lane_width(uint32_t width);
+
+#endif /* SHA256_H */
@@ -24,5 +24,20 @@
 #define ERROR_INVALID_PADDING                 (-14)
 #define ERROR_NOT_ENOUGH_GROUPS               (-15)
 #define ERROR_INVALID_SHARD_BUFFER            (-16)
+#define ERROR_CANCELLED                       (-17)
+#define ERROR_INVALID_MASK                    (-18)
+#define ERROR_INVALID_RULE                    (-19)
+#define ERROR_JOB_MISMATCH                    (-20)
+#define ERROR_JOB_IO                          (-21)
+#define ERROR_INVALID_ITERATION_EXPONENT      (-22)
+#define ERROR_TARGET_TOO_LOW                  (-23)
+#define ERROR_INVALID_ERASURE                 (-24)
+#define ERROR_AMBIGUOUS_ERASURES              (-25)
+#define ERROR_INVALID_WORD                    (-26)
+#define ERROR_TOO_MANY_WORDS                  (-27)
+#define ERROR_INVALID_CONTAINER               (-28)
+#define ERROR_CONTAINER_IO                    (-29)
+#define ERROR_INVALID_WORKER                  (-30)
+#define ERROR_INCONSISTENT_GROUP              (-31)
 
 #endif /* SLIP39_ERRORS_H */
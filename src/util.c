@@ -9,3 +9,7 @@ size_t slip39_word_count_for_bytes(size_t bytes) {
 size_t slip39_byte_count_for_words(size_t words) {
   return (words * RADIX_BITS) / 8;
 }
+
+size_t slip39_packed_size_for_words(size_t words) {
+  return (words * RADIX_BITS + 7) / 8;
+}
@@ -13,4 +13,7 @@
 size_t slip39_word_count_for_bytes(size_t bytes);
 size_t slip39_byte_count_for_words(size_t words);
 
+// bytes taken by words in the packed form, four words to five bytes
+size_t slip39_packed_size_for_words(size_t words);
+
 #endif /* UTIL_H */
@@ -0,0 +1,664 @@
+//
+//  wordlist-english-hash.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+//  Generated by tools/gen-word-hash.py, do not edit.
+//
+
+#ifndef WORDLIST_ENGLISH_HASH_H
+#define WORDLIST_ENGLISH_HASH_H
+
+#include <stdint.h>
+
+#define WORDLIST_HASH_BUCKET_MULTIPLIER 0x510C4619u
+#define WORDLIST_HASH_SLOT_MULTIPLIER 0xE02E553Fu
+#define WORDLIST_HASH_BUCKET_BITS 9
+#define WORDLIST_HASH_SLOT_BITS 10
+
+// xored with the starting slot of every word in the bucket
+static const uint16_t wordlist_hash_displacement[512] = {
+       3,    2,    0,    0,    0,    9,    2,    2,    1,    0,    6,    1,
+       2,    7,    0,   11,    1,    6,    0,    1,    1,    0,    8,    0,
+       1,    2,    1,    1,    1,    4,   74,    2,    0,    2,    8,   20,
+       0,    0,    0,    3,    1,    0,    0,    4,    1,    0,    0,    7,
+       0,    1,    1,    0,   16,    0,    2,    1,    0,   10,    1,   37,
+      12,    3,   10,    0,    0,    4,   15,   13,   11,    1,    3,    0,
+       1,   20,    3,    0,    9,   12,  123,   33,    2,    1,    4,   14,
+       3,   91,    6,    0,    0,   51,    4,    0,    0,    6,    0,    7,
+       0,    0,    0,    0,   10,    1,   33,    2,    7,   10,    6,   14,
+       6,    0,  130,    0,    5,    3,    4,   12,   16,    2,    1,    1,
+       3,   13,    0,   10,   20,   71,    4,   12,    0,    8,   30,    0,
+      38,    0,    3,   10,    1,    0,    0,    5,    7,    0,    9,  130,
+       5,    8,    8,    4,    0,  131,    1,    0,    3,    2,    4,    0,
+       1,    0,   11,   17,    0,    0,    9,    1,  135,   64,    0,    4,
+       6,    0,    1,    8,  104,  140,  100,   22,    0,   17,    0,   64,
+       1,    0,    2,    1,    1,   11,    0,    0,   40,   14,    4,   16,
+       0,    3,   23,    0,    0,    0,    1,    1,    2,   14,    0,    0,
+      12,    9,    0,    7,    2,   92,    0,    0,   22,    6,    2,    0,
+       8,    0,    0,    0,    4,   18,   73,    2,   17,    0,   90,    7,
+     129,    2,    9,    0,   16,    0,    2,  128,    1,   21,    5,    2,
+      24,    0,    0,   19,    1,  145,  150,    0,  156,    2,   49,    4,
+      15,    0,    3,    9,   12,    0,    1,    1,    0,    4,  132,   19,
+       2,   11,    9,  142,  148,   68,   52,   18,  100,  168,   22,    0,
+       1,    5,    1,   68,    1,   10,  101,   12,   50,   14,   10,    6,
+       3,    0,    7,   36,    0,   46,    4,  282,    0,    8,    7,    0,
+       1,    2,   31,   38,   21,   34,    2,    2,   13,    9,    1,    4,
+       9,  162,  258,   28,    0,    4,    1,    3,    1,    1,   36,   21,
+      33,    0,    2,    0,   66,    3,    0,    0,   10,  257,    0,   10,
+       7,   17,    0,    1,   91,    7,   43,    9,    0,    3,    5,    1,
+       0,   14,    1,   85,    4,    5,    6,    0,    0,  113,  138,   30,
+       3,  117,    0,   65,    4,    9,   27,    7,   38,    0,  208,    7,
+       0,    2,    1,    0,    2,   76,    0,  196,    3,   38,    2,   12,
+      20,   36,    1,    1,    0,   77,    4,   32,   15,    0,  164,    0,
+      61,   34,    6,    0,   23,  139,  260,   11,    2,   71,   22,  102,
+       0,  134,    1,    0,    0,  280,  227,    6,    0,    7,    8,    0,
+       8,    3,   80,   13,    3,   18,    0,    0,   26,    4,   53,    4,
+      18,    2,    5,    7,    0,    1,  260,   85,   38,    7,   45,  257,
+       0,    8,  164,   28,    1,  118,  145,    2,    0,   10,   28,    0,
+     304,   37,   79,    0,    0,    0,  390,   22,  219,  147,   98,    0,
+      60,    3,   28,    0,    2,    0,  329,    1,  113,    8,   35,  307,
+      46,   27,    6,   91,    0,   16,    0,    0,    7,   49,   10,  120,
+     312,   40,  403,  872,  162,    0,    2,    0,    0,   19,    2,  272,
+      40,    0,   23,   80,   16,    0,   45,  877,
+};
+
+// the word index stored in each slot
+static const uint16_t wordlist_hash_slots[1024] = {
+     205,  209,  522,  797,   42,  348,  329,  471,  564,  503,  518,  852,
+      83,  631,  700,  495,  392,  279,  886,  588,  476, 1007,  702,  442,
+     580,  470,  201,  458,  867,  147,  940,  581,  878,  883,  594,  653,
+     222,  935,  289,  531,  824,  772,  284,  553,   54,  536,  411,  672,
+     613,  959,  542,  353,  875,  333,  278,   11,  862,  732,  576,  511,
+     261,  111, 1003,  146,  533,  463,  527,  256,  523,  124,  957,  277,
+     121,  675,  529,  106,  861,  497,  535,  413,   95,  960,  117,  204,
+     912,  771,  218,  670,  112,  767,  877,  517,  620,  619,  526, 1008,
+     520,  819,  777,  322,  468,  776,  903, 1016,  570,  507,   62,  964,
+     818,  860,  799,  976,  305,  171,  820,  437,  709,  395,  345,  298,
+     187,  501,  649,  396,  318,  248,  379,   19,    9,  198,  242,   73,
+     113,   93,  467,  623,  255,  399,    4,  682,  449,  601, 1010,  487,
+     428,   35,  648,  272,  573,   61,  344,  661,  537,  756,  461,  265,
+      86,  505,  410,  943,  719,  804,  469,  447,  681,  312,  390,  510,
+     689,   30,  258,  925,  404,  983,  232,  358,  443,  627,  556, 1021,
+     530,  550,  989,  328,  403,   88,  141,  131,  973,  847,  434,   10,
+     599,  288,  269,  915,  515,  721,  703,   58,  951,  363,  432,  656,
+     715,  738,  402,  753,  865,  245,  781,   43,  639,  504,  216,   13,
+     514,  351,  347,  807,  720,  686,  374,  766,  914, 1022,  667,  217,
+      67,   49,  109,  421,  678,  249,  225,  567,  430,  673,  281,  361,
+     758,  540,  566,  244,  426,  635,   15,  854,  166,  868,  742,  834,
+     558,  634,  729,  751,  127,   75,  750,  909,  664,  739,  633,  582,
+     757,  243,  987,  307,  543,  429,  746,  741,  304,  223,  524,  185,
+      99,  663,  203,   20,  148,  335,  548,  745,  884, 1023,  586,  194,
+     509,   59,    3,  809,  602,  502,   17,  585,  475,  213,  385,  787,
+     103,  186,  292,  980,  845,   27,   85,   51,  343,  184,  480,  563,
+     107,  416,  513,  838,  628,   32,  257,   79,  273,  384,  153,  317,
+     650,  625,  393,  144,  440,  240,  482,  375,  276,  455,  488,  138,
+       5,  214,  406,  844,  562,  227,  841,  122,  874, 1002,   81,  316,
+     907,  474,  179,   46, 1018,  574,    2,  911,  247,  744, 1011,  658,
+     607,  975,  998,  929, 1017,  238,  968,  176,  679,  839,   23,  902,
+     327,  727,  386,   80,  955,  408,  516,  997,  810,  632,  554,  352,
+      29,  334,  116,  974,  668,  180,  790,  324,  303,  606,  446,  156,
+     916,  795,   70,  496,  736,  444,  762,  876,  354,  484,  197,  369,
+     692,  481,  525,  460,   18,  220,  765,  880,  119,   90,  913,  579,
+     325,  782,   50,  532,  528,  712,  182,  445,  724,  230,  660,  188,
+     793,  922,  985,  291,  977,   36,  890,  120,   31,   45,  229,  190,
+     139, 1009,  233,    1,   69,  621,  792,  637,  830,  600,  789,  275,
+     896,  397,  366,  887,  942,  560,  889,   71,  519,  800,  330,  636,
+     114,  718,   68,  791,  900,  477,  737, 1005,  268, 1012,  251,  707,
+     926,  350,   22,  984,  941,  491,  508,  801,  211,  835,  786,   87,
+      66,  555,    8,  947,  280,  999,  717,   21,  336,  979,  924,  436,
+     761,  359,  822,  684,  605,   28,   55,  665,  546,  694,  825,  538,
+     302,  271,  616,  151,  547,  154,  254,  290,  129,  136,  246,  826,
+     871,  130,  817,  851,  728,  611,  161,  420,  722,  208,  372,  708,
+     165,  319,  175,  950,  693,  775,  936,  612,  748,  733,  870,  398,
+     158,  577,  778,  253,  557,    6,  105,  808,  932,  552,  850,  993,
+    1001,  840,  150,  452,  981,  133,  377,  189,  125,  457,  759,  193,
+     596,  593,  872,  149,  169,  961,   48,  342,  565,  788,  815,  725,
+     337,  549,  115,  174,  427,  713,  823,   12,  716,   76,  551,  821,
+     930,  796,  177,  381,  172,  485, 1013,  110,  873,  250,  479,  669,
+     863, 1019,  937,   72,   39,  754,  368,  812,  610,  423,  921,  837,
+     798,  859,  412,  928,  414,  945,  971,  691,  774,  367,  569,   64,
+     183,  301,  622,  898,  954,  726,  642,  944,  424,  958,   57,   44,
+     380,  829,  615,  415,  285,  196,  170,  843,  159,   14,  104,  952,
+     966,  320,  905,  394,  297,  200,   47,  949,  891,  407,  168,  803,
+     640,  901,   41,  499,  451,  711,  355,  155,  365,  270,  314,   52,
+     918,   82,  263,  181,  195,  448,  315,  848,  500,   40,  683,  836,
+     483,  296,  967,  659,  590,  323,  816,  710,  626,  221,  598,  969,
+     965,  212,  688,  592,  228,  589,  473,  295, 1006,  102,  698,  906,
+     118,  260,  680, 1015,  431,  493,  310,  806,  534,  813,  466,  241,
+     869,  697,  933,   91,  743,   78,  666,   53,  231,  226,  654,   16,
+     832,  300,  780,  128,   38,  167,  192,  705,  145,  920,  360,   84,
+     100,  833,  309,  882,  544,  545,  378,  706,  401,  362,  207,  224,
+     595,  988,    0,  603,  995,  885,  219,  191,  425,  459,  769,  651,
+     864,  609,  894,  299, 1020,  512,  749,  701,  152,  760,  730,   26,
+     856,  676,  126,  908,  768,  373,  714,  202,  970,  274,  972,  827,
+     645, 1004,  132,  575,  755,  904,  994,  371,  685,  604,   97,  236,
+     643,  992,  163,  539,  597,  283,  699,  641,  644,  855,  235, 1014,
+     591,  382,  842,  568,  338,  931,  160, 1000,  662,  162,  173,  963,
+     340,  453,  657,  123,  923,  234,  143,  773,  286,  341,  140,  383,
+     521,  142,  986,  996,  956,   63,  306,  456,   96,  541,  561,  339,
+     888,  332,  321,  313,  239,  978,  478,  814,  108,   24,  262,  783,
+     294,  763,  779,  489,  400,  811,  409,  953,  946,  494,  624,  454,
+     308,  422,  331,  572,  135,  948,  618,  199,  450,  927,  462,  982,
+     617,  802,  881,  583,  805,  917,  418,  647,  465,  433,  370,  991,
+     388,  571,  849,  608,  492,  794,  866,   77,  134,  389,  671,   74,
+       7,  439,  990,  259,   56,  405,  690,  498,  326,  910,   34,  356,
+      33,  934,   25,  417,  735,  614,  178,  364,  584,  311,   65,  157,
+     391,   89,  723,  210,   37,  674,  357,  828,  638,  897,  435,  164,
+     376,  137,   92,  962,  559,   94,  646,  879,  264,  490,  441,  938,
+     919,  770,  831,  578,  687,  472,  677,   60,  740,  893,   98,  655,
+     101,  734,  587,  486,  237,  438,  287,  752,  252,  419,  282,  858,
+     267,  387,  747,  704,  939,  293,  895,  695,  764,  215,  346,  785,
+     464,  899,  630,  846,  731,  266,  629,  506,  784,  206,  349,  853,
+     857,  652,  696,  892,
+};
+
+// every word zero padded to 8 bytes, by word index
+static const char wordlist_packed[1024][8] = {
+    "academic", "acid",     "acne",     "acquire",  "acrobat",  "activity", "actress",  "adapt",
+    "adequate", "adjust",   "admit",    "adorn",    "adult",    "advance",  "advocate", "afraid",
+    "again",    "agency",   "agree",    "aide",     "aircraft", "airline",  "airport",  "ajar",
+    "alarm",    "album",    "alcohol",  "alien",    "alive",    "alpha",    "already",  "alto",
+    "aluminum", "always",   "amazing",  "ambition", "amount",   "amuse",    "analysis", "anatomy",
+    "ancestor", "ancient",  "angel",    "angry",    "animal",   "answer",   "antenna",  "anxiety",
+    "apart",    "aquatic",  "arcade",   "arena",    "argue",    "armed",    "artist",   "artwork",
+    "aspect",   "auction",  "august",   "aunt",     "average",  "aviation", "avoid",    "award",
+    "away",     "axis",     "axle",     "beam",     "beard",    "beaver",   "become",   "bedroom",
+    "behavior", "being",    "believe",  "belong",   "benefit",  "best",     "beyond",   "bike",
+    "biology",  "birthday", "bishop",   "black",    "blanket",  "blessing", "blimp",    "blind",
+    "blue",     "body",     "bolt",     "boring",   "born",     "both",     "boundary", "bracelet",
+    "branch",   "brave",    "breathe",  "briefing", "broken",   "brother",  "browser",  "bucket",
+    "budget",   "building", "bulb",     "bulge",    "bumpy",    "bundle",   "burden",   "burning",
+    "busy",     "buyer",    "cage",     "calcium",  "camera",   "campus",   "canyon",   "capacity",
+    "capital",  "capture",  "carbon",   "cards",    "careful",  "cargo",    "carpet",   "carve",
+    "category", "cause",    "ceiling",  "center",   "ceramic",  "champion", "change",   "charity",
+    "check",    "chemical", "chest",    "chew",     "chubby",   "cinema",   "civil",    "class",
+    "clay",     "cleanup",  "client",   "climate",  "clinic",   "clock",    "clogs",    "closet",
+    "clothes",  "club",     "cluster",  "coal",     "coastal",  "coding",   "column",   "company",
+    "corner",   "costume",  "counter",  "course",   "cover",    "cowboy",   "cradle",   "craft",
+    "crazy",    "credit",   "cricket",  "criminal", "crisis",   "critical", "crowd",    "crucial",
+    "crunch",   "crush",    "crystal",  "cubic",    "cultural", "curious",  "curly",    "custody",
+    "cylinder", "daisy",    "damage",   "dance",    "darkness", "database", "daughter", "deadline",
+    "deal",     "debris",   "debut",    "decent",   "decision", "declare",  "decorate", "decrease",
+    "deliver",  "demand",   "density",  "deny",     "depart",   "depend",   "depict",   "deploy",
+    "describe", "desert",   "desire",   "desktop",  "destroy",  "detailed", "detect",   "device",
+    "devote",   "diagnose", "dictate",  "diet",     "dilemma",  "diminish", "dining",   "diploma",
+    "disaster", "discuss",  "disease",  "dish",     "dismiss",  "display",  "distance", "dive",
+    "divorce",  "document", "domain",   "domestic", "dominant", "dough",    "downtown", "dragon",
+    "dramatic", "dream",    "dress",    "drift",    "drink",    "drove",    "drug",     "dryer",
+    "duckling", "duke",     "duration", "dwarf",    "dynamic",  "early",    "earth",    "easel",
+    "easy",     "echo",     "eclipse",  "ecology",  "edge",     "editor",   "educate",  "either",
+    "elbow",    "elder",    "election", "elegant",  "element",  "elephant", "elevator", "elite",
+    "else",     "email",    "emerald",  "emission", "emperor",  "emphasis", "employer", "empty",
+    "ending",   "endless",  "endorse",  "enemy",    "energy",   "enforce",  "engage",   "enjoy",
+    "enlarge",  "entrance", "envelope", "envy",     "epidemic", "episode",  "equation", "equip",
+    "eraser",   "erode",    "escape",   "estate",   "estimate", "evaluate", "evening",  "evidence",
+    "evil",     "evoke",    "exact",    "example",  "exceed",   "exchange", "exclude",  "excuse",
+    "execute",  "exercise", "exhaust",  "exotic",   "expand",   "expect",   "explain",  "express",
+    "extend",   "extra",    "eyebrow",  "facility", "fact",     "failure",  "faint",    "fake",
+    "false",    "family",   "famous",   "fancy",    "fangs",    "fantasy",  "fatal",    "fatigue",
+    "favorite", "fawn",     "fiber",    "fiction",  "filter",   "finance",  "findings", "finger",
+    "firefly",  "firm",     "fiscal",   "fishing",  "fitness",  "flame",    "flash",    "flavor",
+    "flea",     "flexible", "flip",     "float",    "floral",   "fluff",    "focus",    "forbid",
+    "force",    "forecast", "forget",   "formal",   "fortune",  "forward",  "founder",  "fraction",
+    "fragment", "frequent", "freshman", "friar",    "fridge",   "friendly", "frost",    "froth",
+    "frozen",   "fumes",    "funding",  "furl",     "fused",    "galaxy",   "game",     "garbage",
+    "garden",   "garlic",   "gasoline", "gather",   "general",  "genius",   "genre",    "genuine",
+    "geology",  "gesture",  "glad",     "glance",   "glasses",  "glen",     "glimpse",  "goat",
+    "golden",   "graduate", "grant",    "grasp",    "gravity",  "gray",     "greatest", "grief",
+    "grill",    "grin",     "grocery",  "gross",    "group",    "grownup",  "grumpy",   "guard",
+    "guest",    "guilt",    "guitar",   "gums",     "hairy",    "hamster",  "hand",     "hanger",
+    "harvest",  "have",     "havoc",    "hawk",     "hazard",   "headset",  "health",   "hearing",
+    "heat",     "helpful",  "herald",   "herd",     "hesitate", "hobo",     "holiday",  "holy",
+    "home",     "hormone",  "hospital", "hour",     "huge",     "human",    "humidity", "hunting",
+    "husband",  "hush",     "husky",    "hybrid",   "idea",     "identify", "idle",     "image",
+    "impact",   "imply",    "improve",  "impulse",  "include",  "income",   "increase", "index",
+    "indicate", "industry", "infant",   "inform",   "inherit",  "injury",   "inmate",   "insect",
+    "inside",   "install",  "intend",   "intimate", "invasion", "involve",  "iris",     "island",
+    "isolate",  "item",     "ivory",    "jacket",   "jerky",    "jewelry",  "join",     "judicial",
+    "juice",    "jump",     "junction", "junior",   "junk",     "jury",     "justice",  "kernel",
+    "keyboard", "kidney",   "kind",     "kitchen",  "knife",    "knit",     "laden",    "ladle",
+    "ladybug",  "lair",     "lamp",     "language", "large",    "laser",    "laundry",  "lawsuit",
+    "leader",   "leaf",     "learn",    "leaves",   "lecture",  "legal",    "legend",   "legs",
+    "lend",     "length",   "level",    "liberty",  "library",  "license",  "lift",     "likely",
+    "lilac",    "lily",     "lips",     "liquid",   "listen",   "literary", "living",   "lizard",
+    "loan",     "lobe",     "location", "losing",   "loud",     "loyalty",  "luck",     "lunar",
+    "lunch",    "lungs",    "luxury",   "lying",    "lyrics",   "machine",  "magazine", "maiden",
+    "mailman",  "main",     "makeup",   "making",   "mama",     "manager",  "mandate",  "mansion",
+    "manual",   "marathon", "march",    "market",   "marvel",   "mason",    "material", "math",
+    "maximum",  "mayor",    "meaning",  "medal",    "medical",  "member",   "memory",   "mental",
+    "merchant", "merit",    "method",   "metric",   "midst",    "mild",     "military", "mineral",
+    "minister", "miracle",  "mixed",    "mixture",  "mobile",   "modern",   "modify",   "moisture",
+    "moment",   "morning",  "mortgage", "mother",   "mountain", "mouse",    "move",     "much",
+    "mule",     "multiple", "muscle",   "museum",   "music",    "mustang",  "nail",     "national",
+    "necklace", "negative", "nervous",  "network",  "news",     "nuclear",  "numb",     "numerous",
+    "nylon",    "oasis",    "obesity",  "object",   "observe",  "obtain",   "ocean",    "often",
+    "olympic",  "omit",     "oral",     "orange",   "orbit",    "order",    "ordinary", "organize",
+    "ounce",    "oven",     "overall",  "owner",    "paces",    "pacific",  "package",  "paid",
+    "painting", "pajamas",  "pancake",  "pants",    "papa",     "paper",    "parcel",   "parking",
+    "party",    "patent",   "patrol",   "payment",  "payroll",  "peaceful", "peanut",   "peasant",
+    "pecan",    "penalty",  "pencil",   "percent",  "perfect",  "permit",   "petition", "phantom",
+    "pharmacy", "photo",    "phrase",   "physics",  "pickup",   "picture",  "piece",    "pile",
+    "pink",     "pipeline", "pistol",   "pitch",    "plains",   "plan",     "plastic",  "platform",
+    "playoff",  "pleasure", "plot",     "plunge",   "practice", "prayer",   "preach",   "predator",
+    "pregnant", "premium",  "prepare",  "presence", "prevent",  "priest",   "primary",  "priority",
+    "prisoner", "privacy",  "prize",    "problem",  "process",  "profile",  "program",  "promise",
+    "prospect", "provide",  "prune",    "public",   "pulse",    "pumps",    "punish",   "puny",
+    "pupal",    "purchase", "purple",   "python",   "quantity", "quarter",  "quick",    "quiet",
+    "race",     "racism",   "radar",    "railroad", "rainbow",  "raisin",   "random",   "ranked",
+    "rapids",   "raspy",    "reaction", "realize",  "rebound",  "rebuild",  "recall",   "receiver",
+    "recover",  "regret",   "regular",  "reject",   "relate",   "remember", "remind",   "remove",
+    "render",   "repair",   "repeat",   "replace",  "require",  "rescue",   "research", "resident",
+    "response", "result",   "retailer", "retreat",  "reunion",  "revenue",  "review",   "reward",
+    "rhyme",    "rhythm",   "rich",     "rival",    "river",    "robin",    "rocky",    "romantic",
+    "romp",     "roster",   "round",    "royal",    "ruin",     "ruler",    "rumor",    "sack",
+    "safari",   "salary",   "salon",    "salt",     "satisfy",  "satoshi",  "saver",    "says",
+    "scandal",  "scared",   "scatter",  "scene",    "scholar",  "science",  "scout",    "scramble",
+    "screw",    "script",   "scroll",   "seafood",  "season",   "secret",   "security", "segment",
+    "senior",   "shadow",   "shaft",    "shame",    "shaped",   "sharp",    "shelter",  "sheriff",
+    "short",    "should",   "shrimp",   "sidewalk", "silent",   "silver",   "similar",  "simple",
+    "single",   "sister",   "skin",     "skunk",    "slap",     "slavery",  "sled",     "slice",
+    "slim",     "slow",     "slush",    "smart",    "smear",    "smell",    "smirk",    "smith",
+    "smoking",  "smug",     "snake",    "snapshot", "sniff",    "society",  "software", "soldier",
+    "solution", "soul",     "source",   "space",    "spark",    "speak",    "species",  "spelling",
+    "spend",    "spew",     "spider",   "spill",    "spine",    "spirit",   "spit",     "spray",
+    "sprinkle", "square",   "squeeze",  "stadium",  "staff",    "standard", "starting", "station",
+    "stay",     "steady",   "step",     "stick",    "stilt",    "story",    "strategy", "strike",
+    "style",    "subject",  "submit",   "sugar",    "suitable", "sunlight", "superior", "surface",
+    "surprise", "survive",  "sweater",  "swimming", "swing",    "switch",   "symbolic", "sympathy",
+    "syndrome", "system",   "tackle",   "tactics",  "tadpole",  "talent",   "task",     "taste",
+    "taught",   "taxi",     "teacher",  "teammate", "teaspoon", "temple",   "tenant",   "tendency",
+    "tension",  "terminal", "testify",  "texture",  "thank",    "that",     "theater",  "theory",
+    "therapy",  "thorn",    "threaten", "thumb",    "thunder",  "ticket",   "tidy",     "timber",
+    "timely",   "ting",     "tofu",     "together", "tolerate", "total",    "toxic",    "tracks",
+    "traffic",  "training", "transfer", "trash",    "traveler", "treat",    "trend",    "trial",
+    "tricycle", "trip",     "triumph",  "trouble",  "true",     "trust",    "twice",    "twin",
+    "type",     "typical",  "ugly",     "ultimate", "umbrella", "uncover",  "undergo",  "unfair",
+    "unfold",   "unhappy",  "union",    "universe", "unkind",   "unknown",  "unusual",  "unwrap",
+    "upgrade",  "upstairs", "username", "usher",    "usual",    "valid",    "valuable", "vampire",
+    "vanish",   "various",  "vegan",    "velvet",   "venture",  "verdict",  "verify",   "very",
+    "veteran",  "vexed",    "victim",   "video",    "view",     "vintage",  "violence", "viral",
+    "visitor",  "visual",   "vitamins", "vocal",    "voice",    "volume",   "voter",    "voting",
+    "walnut",   "warmth",   "warn",     "watch",    "wavy",     "wealthy",  "weapon",   "webcam",
+    "welcome",  "welfare",  "western",  "width",    "wildlife", "window",   "wine",     "wireless",
+    "wisdom",   "withdraw", "wits",     "wolf",     "woman",    "work",     "worthy",   "wrap",
+    "wrist",    "writing",  "wrote",    "year",     "yelp",     "yield",    "yoga",     "zero",
+};
+
+// the length of every word, by word index
+static const uint8_t wordlist_length[1024] = {
+    8, 4, 4, 7, 7, 8, 7, 5, 8, 6, 5, 5, 5, 7, 8, 6,
+    5, 6, 5, 4, 8, 7, 7, 4, 5, 5, 7, 5, 5, 5, 7, 4,
+    8, 6, 7, 8, 6, 5, 8, 7, 8, 7, 5, 5, 6, 6, 7, 7,
+    5, 7, 6, 5, 5, 5, 6, 7, 6, 7, 6, 4, 7, 8, 5, 5,
+    4, 4, 4, 4, 5, 6, 6, 7, 8, 5, 7, 6, 7, 4, 6, 4,
+    7, 8, 6, 5, 7, 8, 5, 5, 4, 4, 4, 6, 4, 4, 8, 8,
+    6, 5, 7, 8, 6, 7, 7, 6, 6, 8, 4, 5, 5, 6, 6, 7,
+    4, 5, 4, 7, 6, 6, 6, 8, 7, 7, 6, 5, 7, 5, 6, 5,
+    8, 5, 7, 6, 7, 8, 6, 7, 5, 8, 5, 4, 6, 6, 5, 5,
+    4, 7, 6, 7, 6, 5, 5, 6, 7, 4, 7, 4, 7, 6, 6, 7,
+    6, 7, 7, 6, 5, 6, 6, 5, 5, 6, 7, 8, 6, 8, 5, 7,
+    6, 5, 7, 5, 8, 7, 5, 7, 8, 5, 6, 5, 8, 8, 8, 8,
+    4, 6, 5, 6, 8, 7, 8, 8, 7, 6, 7, 4, 6, 6, 6, 6,
+    8, 6, 6, 7, 7, 8, 6, 6, 6, 8, 7, 4, 7, 8, 6, 7,
+    8, 7, 7, 4, 7, 7, 8, 4, 7, 8, 6, 8, 8, 5, 8, 6,
+    8, 5, 5, 5, 5, 5, 4, 5, 8, 4, 8, 5, 7, 5, 5, 5,
+    4, 4, 7, 7, 4, 6, 7, 6, 5, 5, 8, 7, 7, 8, 8, 5,
+    4, 5, 7, 8, 7, 8, 8, 5, 6, 7, 7, 5, 6, 7, 6, 5,
+    7, 8, 8, 4, 8, 7, 8, 5, 6, 5, 6, 6, 8, 8, 7, 8,
+    4, 5, 5, 7, 6, 8, 7, 6, 7, 8, 7, 6, 6, 6, 7, 7,
+    6, 5, 7, 8, 4, 7, 5, 4, 5, 6, 6, 5, 5, 7, 5, 7,
+    8, 4, 5, 7, 6, 7, 8, 6, 7, 4, 6, 7, 7, 5, 5, 6,
+    4, 8, 4, 5, 6, 5, 5, 6, 5, 8, 6, 6, 7, 7, 7, 8,
+    8, 8, 8, 5, 6, 8, 5, 5, 6, 5, 7, 4, 5, 6, 4, 7,
+    6, 6, 8, 6, 7, 6, 5, 7, 7, 7, 4, 6, 7, 4, 7, 4,
+    6, 8, 5, 5, 7, 4, 8, 5, 5, 4, 7, 5, 5, 7, 6, 5,
+    5, 5, 6, 4, 5, 7, 4, 6, 7, 4, 5, 4, 6, 7, 6, 7,
+    4, 7, 6, 4, 8, 4, 7, 4, 4, 7, 8, 4, 4, 5, 8, 7,
+    7, 4, 5, 6, 4, 8, 4, 5, 6, 5, 7, 7, 7, 6, 8, 5,
+    8, 8, 6, 6, 7, 6, 6, 6, 6, 7, 6, 8, 8, 7, 4, 6,
+    7, 4, 5, 6, 5, 7, 4, 8, 5, 4, 8, 6, 4, 4, 7, 6,
+    8, 6, 4, 7, 5, 4, 5, 5, 7, 4, 4, 8, 5, 5, 7, 7,
+    6, 4, 5, 6, 7, 5, 6, 4, 4, 6, 5, 7, 7, 7, 4, 6,
+    5, 4, 4, 6, 6, 8, 6, 6, 4, 4, 8, 6, 4, 7, 4, 5,
+    5, 5, 6, 5, 6, 7, 8, 6, 7, 4, 6, 6, 4, 7, 7, 7,
+    6, 8, 5, 6, 6, 5, 8, 4, 7, 5, 7, 5, 7, 6, 6, 6,
+    8, 5, 6, 6, 5, 4, 8, 7, 8, 7, 5, 7, 6, 6, 6, 8,
+    6, 7, 8, 6, 8, 5, 4, 4, 4, 8, 6, 6, 5, 7, 4, 8,
+    8, 8, 7, 7, 4, 7, 4, 8, 5, 5, 7, 6, 7, 6, 5, 5,
+    7, 4, 4, 6, 5, 5, 8, 8, 5, 4, 7, 5, 5, 7, 7, 4,
+    8, 7, 7, 5, 4, 5, 6, 7, 5, 6, 6, 7, 7, 8, 6, 7,
+    5, 7, 6, 7, 7, 6, 8, 7, 8, 5, 6, 7, 6, 7, 5, 4,
+    4, 8, 6, 5, 6, 4, 7, 8, 7, 8, 4, 6, 8, 6, 6, 8,
+    8, 7, 7, 8, 7, 6, 7, 8, 8, 7, 5, 7, 7, 7, 7, 7,
+    8, 7, 5, 6, 5, 5, 6, 4, 5, 8, 6, 6, 8, 7, 5, 5,
+    4, 6, 5, 8, 7, 6, 6, 6, 6, 5, 8, 7, 7, 7, 6, 8,
+    7, 6, 7, 6, 6, 8, 6, 6, 6, 6, 6, 7, 7, 6, 8, 8,
+    8, 6, 8, 7, 7, 7, 6, 6, 5, 6, 4, 5, 5, 5, 5, 8,
+    4, 6, 5, 5, 4, 5, 5, 4, 6, 6, 5, 4, 7, 7, 5, 4,
+    7, 6, 7, 5, 7, 7, 5, 8, 5, 6, 6, 7, 6, 6, 8, 7,
+    6, 6, 5, 5, 6, 5, 7, 7, 5, 6, 6, 8, 6, 6, 7, 6,
+    6, 6, 4, 5, 4, 7, 4, 5, 4, 4, 5, 5, 5, 5, 5, 5,
+    7, 4, 5, 8, 5, 7, 8, 7, 8, 4, 6, 5, 5, 5, 7, 8,
+    5, 4, 6, 5, 5, 6, 4, 5, 8, 6, 7, 7, 5, 8, 8, 7,
+    4, 6, 4, 5, 5, 5, 8, 6, 5, 7, 6, 5, 8, 8, 8, 7,
+    8, 7, 7, 8, 5, 6, 8, 8, 8, 6, 6, 7, 7, 6, 4, 5,
+    6, 4, 7, 8, 8, 6, 6, 8, 7, 8, 7, 7, 5, 4, 7, 6,
+    7, 5, 8, 5, 7, 6, 4, 6, 6, 4, 4, 8, 8, 5, 5, 6,
+    7, 8, 8, 5, 8, 5, 5, 5, 8, 4, 7, 7, 4, 5, 5, 4,
+    4, 7, 4, 8, 8, 7, 7, 6, 6, 7, 5, 8, 6, 7, 7, 6,
+    7, 8, 8, 5, 5, 5, 8, 7, 6, 7, 5, 6, 7, 7, 6, 4,
+    7, 5, 6, 5, 4, 7, 8, 5, 7, 6, 8, 5, 5, 6, 5, 6,
+    6, 6, 4, 5, 4, 7, 6, 6, 7, 7, 7, 5, 8, 6, 4, 8,
+    6, 8, 4, 4, 5, 4, 6, 4, 5, 7, 5, 4, 4, 5, 4, 4,
+};
+
+// the words starting with the two letters xy are those from
+// wordlist_prefix_start[(x-'a')*26 + (y-'a')] up to the next entry
+static const uint16_t wordlist_prefix_start[677] = {
+       0,    0,    0,    7,   15,   15,   16,   19,   19,   23,   24,   24,   34,
+      38,   48,   48,   49,   50,   56,   57,   57,   60,   63,   65,   67,   67,
+      67,   67,   67,   67,   67,   79,   79,   79,   79,   83,   83,   83,   89,
+      89,   89,   95,   95,   95,  103,  103,  103,  114,  114,  114,  114,  114,
+     114,  130,  130,  130,  130,  133,  133,  133,  141,  143,  143,  143,  155,
+     155,  155,  166,  166,  166,  179,  179,  179,  184,  184,  184,  184,  185,
+     185,  191,  191,  191,  191,  217,  217,  217,  217,  233,  233,  233,  233,
+     233,  233,  239,  239,  239,  248,  248,  248,  251,  251,  252,  252,  253,
+     253,  257,  257,  260,  263,  263,  263,  263,  263,  264,  264,  264,  273,
+     280,  292,  292,  294,  296,  298,  301,  301,  301,  306,  306,  322,  323,
+     323,  338,  338,  338,  338,  338,  338,  338,  338,  349,  349,  349,  358,
+     358,  358,  367,  367,  367,  377,  377,  377,  381,  381,  381,  381,  381,
+     381,  388,  388,  388,  388,  394,  394,  394,  394,  394,  394,  394,  399,
+     399,  399,  401,  401,  401,  415,  415,  415,  420,  420,  420,  420,  420,
+     420,  429,  429,  429,  429,  437,  437,  437,  437,  437,  437,  437,  437,
+     437,  437,  444,  444,  444,  444,  444,  444,  451,  451,  451,  451,  452,
+     452,  452,  452,  452,  455,  455,  455,  455,  455,  455,  455,  455,  455,
+     460,  478,  478,  478,  478,  479,  481,  482,  482,  483,  483,  483,  483,
+     483,  484,  484,  484,  484,  486,  486,  486,  486,  486,  486,  486,  486,
+     486,  486,  487,  487,  487,  487,  487,  487,  495,  495,  495,  495,  495,
+     495,  495,  495,  495,  495,  497,  497,  497,  497,  500,  500,  500,  500,
+     500,  502,  502,  502,  502,  502,  502,  502,  502,  502,  502,  502,  502,
+     502,  512,  512,  512,  512,  523,  523,  523,  523,  536,  536,  536,  536,
+     536,  536,  542,  542,  542,  542,  542,  542,  547,  547,  547,  547,  549,
+     549,  570,  570,  570,  570,  580,  580,  580,  580,  588,  588,  588,  588,
+     588,  588,  599,  599,  599,  599,  599,  599,  606,  606,  606,  606,  606,
+     606,  608,  608,  608,  608,  613,  613,  613,  613,  613,  613,  613,  613,
+     613,  613,  613,  613,  613,  613,  613,  613,  616,  616,  616,  616,  617,
+     617,  618,  622,  623,  623,  623,  624,  624,  624,  624,  624,  624,  625,
+     626,  626,  626,  626,  626,  632,  632,  632,  633,  635,  636,  636,  636,
+     636,  653,  653,  653,  653,  663,  663,  663,  668,  676,  676,  676,  684,
+     684,  684,  684,  684,  684,  707,  707,  707,  715,  715,  715,  715,  716,
+     716,  716,  716,  716,  716,  716,  716,  716,  716,  716,  716,  716,  716,
+     716,  716,  716,  716,  716,  716,  716,  716,  720,  720,  720,  720,  720,
+     720,  730,  730,  730,  730,  760,  760,  760,  762,  765,  765,  765,  765,
+     765,  765,  772,  772,  772,  772,  772,  772,  775,  775,  775,  775,  775,
+     775,  784,  784,  795,  795,  801,  801,  801,  811,  818,  818,  820,  827,
+     834,  837,  843,  857,  859,  859,  859,  873,  882,  882,  886,  886,  890,
+     890,  898,  898,  898,  898,  908,  908,  908,  917,  922,  922,  922,  922,
+     922,  922,  927,  927,  927,  942,  942,  942,  942,  942,  944,  944,  946,
+     946,  946,  946,  946,  946,  946,  946,  947,  947,  947,  947,  947,  948,
+     949,  960,  960,  962,  962,  962,  965,  965,  965,  965,  965,  965,  965,
+     965,  970,  970,  970,  970,  978,  978,  978,  978,  987,  987,  987,  987,
+     987,  987,  992,  992,  992,  992,  992,  992,  992,  992,  992,  992,  992,
+     992,  997,  997,  997,  997, 1003, 1003, 1003, 1003, 1011, 1011, 1011, 1011,
+    1011, 1011, 1015, 1015, 1015, 1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019,
+    1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019,
+    1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019, 1019,
+    1019, 1019, 1019, 1019, 1019, 1021, 1021, 1021, 1021, 1022, 1022, 1022, 1022,
+    1022, 1022, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1024, 1024, 1024, 1024, 1024, 1024, 1024, 1024,
+    1024, 1024, 1024, 1024, 1024, 1024, 1024, 1024, 1024, 1024, 1024, 1024, 1024,
+    1024,
+};
+
+// a BK-tree over the words by Damerau-Levenshtein distance, laid out
+// breadth first: node i holds word wordlist_bktree_word[i], is at
+// wordlist_bktree_distance[i] from its parent, and its children are the
+// nodes from wordlist_bktree_first_child[i] up to the next entry
+static const uint16_t wordlist_bktree_word[1024] = {
+       0,  292,   10,    1,    3,    8,   72,   50,    2,   16,   24,    6,
+      38,  137,   28,    4,    7,   67,  235,   14,   60,   36,   20,   26,
+      86,  196,   75,   80,  180,  132,   19,  114,  502,  179,  637,  116,
+      49,  206,   39,  240,  124,   37,  129,  121,   48,    5,   13,  684,
+      64,   42,   17,   46,  128,  192,  203,  201,   76,   95,  303,  767,
+     886,  368,  664,  740,  197,   59,   58,  195,  204,  147,   98,  199,
+      22,   21,   29,   31,   74,   57,   40,   32,   73,  596,  354,  768,
+      89,   96,   99,  173,  277,  662,  250,  294,  491,  270,   78,   87,
+      85,   82,  101,  208,  224,  392,   90,   81,   94,  198,  184,  356,
+     379,  346,  225,  236,  785,  385,  141,  169,  148,  512,  215,  252,
+     678,   52,  210,    9,   11,  720,   27,   34,  115,  839,  722,  219,
+      53,   51,   97,  298,   30,   41,   69,  401,  468,  110,  172,  566,
+     689,  241,  394,  255,  214,  429,  220,  384,  653,  651,  400,  624,
+     504,  903,  218,  216,  301,  209,  432,  933,  249,  558,  271,  899,
+     286,  202,  882,  226,  189,   54,  243,  462,  797,   33,  251,  383,
+     692,  254,   77,   68,  104,  406,  233,  200,   88,  131,  154,  162,
+     257,  155,  151,  350,  536,  145,  153,   35,  156,   79,  108,  109,
+     135,  188,  791,  716,  673,  741,  824,  810,  918,  486,  149,  407,
+     676,  331,  100,  174,  338,  883,  171,  343,  133,  152,  183,  342,
+     276,  561,  930,  904,  476,  756,  735,  609,  754,   91,  105,   92,
+     264,  578,  287,  434,  391,  102,  212,  211,  213,  490,  275,  953,
+     439,  529,   93,  112,  106,  616,  288,  417,  232,  608,  274,  248,
+     221,  447,  190,  436,  269,  546,  587,  601,  947,  473,  357,  364,
+     838,  229,  230,  398,  300,  289,  688,  361,  238,  373,  411,  928,
+      12,   15,  127,   23,   18,  166,  789,   66,  787,  638,  157,   65,
+      45,  721,  511,  187,  606,  452,   56,  186,  349,  553,  138,  136,
+      47,   44,  139,  304,  265,  557,  123,  117,  119,  859,  744,  158,
+     579,  193,  315,  191,  506,  556,  515,  283,  649,  463,  993,  426,
+     641,  552,  950,  568,  932,  262,  857,  746,  719,  295,  470,  910,
+     717,  513,  909,  306,  656,  325,  960,  460,  739,  811,  430,  895,
+     352,  256,  231,  992,  415,  390,   70,  245,  560,  163,  310,  336,
+     453,  572,  107,  731,  260,  205,  618,  335,  597,  161,  279,  207,
+     237,  461,  537,  522,  540,  626,  397,  520,  175,  518,   61,  261,
+      55,   43,   84,  178,  334,  167,  168,  360,  263, 1006,  852,  244,
+     222,  130,  113,  185,  337,  134,  380,  176,  242,  523,  404,  140,
+     159,  170,  318,  424,  217,  333,  223,  370,  888,  861,  870,  750,
+     751,  955,  937,  150,  762,  345,  830,  562,  729,  332,  765,  548,
+     351,  919,  586,  527,  451,  555,  378,  376,  559,  181,  160,  497,
+     595,  396,  165,  259,  348,  929,  986,  344,  700,  410,  878,  319,
+     663,  510,  835,  111,  534,  902,  954,  808,  437,  443,  759,  543,
+     611,  806,  906,  339,  738,  266,  881,  798,  631,  984,  314,  438,
+     869,  674,  695,  682,  355,  825,  466,  541,  450,  547,  456,  747,
+     441,  293,  290,  278,  321,  312,  285,  516,  309,  267,  393,  446,
+     593,  418,  433,  956,  710,  449,  696,  923,  905,  681,  576,  313,
+     880,  961,  985,  669,  958,  959,  841,  945,  542,  544,  524,  442,
+     591,  683,  469,  533, 1009,  924,  358,  675,  459,  668,  412,  480,
+     448,  465,  694,  507,  365,  369,  475,  594,  353,  877,  816,  464,
+     457,  374,  704, 1007,  477,  936,   62,  164,   63,   25,  792,  505,
+     786,  142,  126,  645,  327,  455,  273,  483,  803,  843,  639,  897,
+     194,  776,  395,  146,  622,  551,  329,  509,  554,  296,  685,  629,
+     125,  617,  297,  589,  118,  234,  642,  973,  120,  892,  742,  707,
+     850,  821,  893,  726,  801,  804, 1008,  889,  299,  399,  670,  666,
+     790,  999,  734,  655,  567, 1019,  454,  246, 1018,  514,  828,  517,
+     845,  706,  488,  416, 1000,  842,  268,  311,  531,  687,  272,  757,
+     305,  708,  858,  444,  691,  736,  788,  599,  995,  987,  677,  528,
+     774,  831,  330,  525,  549,  969,  239,  796,  532,  574,   83,   71,
+     258,  508,  143,  381,  177,  931,  324,  990,  388,  775,  387,  795,
+     308,  282,  326,  280,  431,  302,  291,  833,  994,  612,  371,  500,
+     974,  627,  372,  389,  773,  872,  377,  253,  620,  247,  405,  284,
+     573,  659,  428,  563,  317,  414,  228,  550,  976,  340,  341,  421,
+     307,  487, 1004,  982,  409,  818,  867,  968,  728,  764,  565,  813,
+     920,  978,  699,  590,  647,  474,  467,  863,  667,  724,  359,  727,
+     761,  780,  281,  650,  423,  640,  367,  862,  538,  900,  949,  482,
+     665,  610,  748,  840,  322,  733,  657,  705,  921,  479,  535,  771,
+     925,  855,  814,  809,  697,  884,  672,  588,  763,  539,  458,  585,
+     530,  408,  347,  715, 1017, 1001,  316,  753,  732,  871,  907,  749,
+     575,  496,  634,  584, 1016,  607,  712,  964,  836,  847,  914,  605,
+     714,  941,  493,  545,  702,  876,  582,  966,  602,  819,  499,  981,
+     713,  492,  922,  879,  630,  375,  939,  946,  615,  962,  856,  766,
+     413,  815,  887,  890,  891,  382,  503,  577,  625,  636,  604,  481,
+     965,  979,  661,  122,  725,  784,  874,  686,  745,  737,  940,  571,
+     654,  743,  632,  971,  718,  865,  600,  989,  823, 1012,  800,  998,
+     896,  779,  227,  583,  103,  837,  144,  328,  422,  495,  777,  519,
+     963,  182,  363,  613,  997,  898,  427,  917,  911, 1023,  772,  570,
+     484, 1020,  402,  435,  698,  977,  758,  812,  419,  445,  643,  580,
+     472,  403, 1015,  783,  628,  648,  320,  592,  853,  799,  807,  471,
+     362,  703,  916,  494,  951,  485, 1002,  386,  366,  660,  603,  323,
+     478,  498,  420,  943,  569,  635,  564,  927,  794,  680,  730,  679,
+     652,  948,  913,  875, 1022,  912,  983,  991,  526, 1010,  868,  832,
+     521,  972,  690,  752,  826,  885,  711,  770,  957,  723, 1011,  425,
+     834,  926,  782,  755,  970,  901,  988, 1003,  440,  829,  658,  793,
+     820,  822,  975,  934,  501,  671,  848,  908,  621,  942, 1021,  709,
+     489,  760,  944,  693,  849,  864,  805,  619,  802,  644,  846,  967,
+     873,  817,  769,  938,  581,  778,  646, 1005,  781, 1013,  701,  851,
+     952, 1014,  598,  633,  935,  854,  980,  614,  866,  894,  827,  996,
+     623,  860,  915,  844,
+};
+
+static const uint8_t wordlist_bktree_distance[1024] = {
+    0, 3, 4, 5, 6, 7, 8, 5, 2, 3, 4, 5, 6, 7, 4, 5,
+    6, 7, 8, 3, 4, 5, 6, 7, 8, 5, 6, 7, 8, 6, 2, 4,
+    4, 5, 6, 5, 6, 7, 5, 6, 7, 3, 4, 5, 4, 5, 6, 7,
+    3, 4, 5, 6, 7, 2, 3, 4, 5, 6, 7, 3, 5, 7, 8, 4,
+    5, 2, 3, 4, 5, 6, 7, 8, 4, 5, 6, 7, 8, 4, 5, 6,
+    7, 8, 2, 3, 4, 5, 6, 7, 8, 3, 4, 5, 6, 7, 2, 3,
+    4, 5, 6, 7, 8, 2, 4, 5, 6, 7, 8, 4, 5, 6, 7, 8,
+    4, 4, 3, 5, 5, 6, 2, 5, 6, 3, 5, 6, 7, 4, 5, 6,
+    7, 7, 3, 4, 3, 4, 5, 6, 4, 5, 6, 7, 5, 6, 7, 5,
+    7, 2, 4, 5, 4, 5, 6, 7, 5, 6, 7, 8, 7, 6, 3, 4,
+    5, 2, 3, 4, 5, 6, 3, 4, 5, 6, 4, 5, 6, 4, 5, 6,
+    7, 4, 5, 6, 7, 3, 4, 5, 6, 7, 8, 3, 4, 5, 6, 7,
+    5, 6, 6, 7, 8, 5, 6, 7, 8, 3, 4, 5, 6, 7, 8, 6,
+    7, 8, 2, 3, 2, 3, 4, 5, 6, 3, 4, 5, 6, 4, 5, 6,
+    7, 8, 6, 7, 8, 7, 8, 4, 4, 5, 6, 7, 6, 3, 4, 6,
+    7, 4, 5, 6, 7, 2, 6, 7, 5, 6, 7, 8, 2, 3, 5, 6,
+    7, 8, 6, 7, 8, 4, 5, 6, 7, 8, 6, 7, 8, 4, 5, 6,
+    8, 4, 5, 6, 7, 4, 5, 6, 7, 8, 4, 5, 6, 7, 8, 4,
+    2, 5, 6, 3, 4, 5, 5, 3, 4, 6, 4, 5, 6, 3, 5, 4,
+    5, 3, 4, 5, 3, 4, 5, 6, 3, 4, 5, 6, 3, 4, 5, 6,
+    7, 6, 4, 5, 6, 4, 5, 7, 3, 4, 3, 4, 5, 6, 4, 5,
+    6, 5, 6, 7, 7, 4, 5, 3, 3, 4, 4, 2, 7, 4, 5, 4,
+    5, 6, 5, 6, 7, 7, 2, 3, 5, 3, 4, 5, 2, 3, 4, 5,
+    6, 5, 6, 7, 6, 7, 2, 5, 4, 5, 6, 7, 4, 5, 6, 7,
+    5, 5, 4, 5, 2, 3, 3, 4, 5, 6, 3, 5, 6, 7, 8, 2,
+    3, 4, 5, 6, 7, 2, 3, 4, 5, 6, 3, 4, 5, 6, 4, 5,
+    6, 7, 3, 4, 5, 6, 7, 4, 5, 6, 7, 8, 6, 6, 8, 5,
+    6, 7, 3, 2, 4, 5, 4, 3, 5, 6, 4, 5, 6, 2, 3, 4,
+    5, 6, 6, 4, 4, 6, 7, 8, 3, 4, 5, 6, 7, 8, 5, 6,
+    7, 8, 3, 4, 6, 7, 6, 3, 4, 5, 4, 5, 4, 5, 3, 5,
+    6, 7, 3, 5, 6, 6, 6, 7, 7, 5, 7, 6, 4, 5, 7, 4,
+    5, 3, 5, 6, 7, 4, 5, 6, 7, 5, 6, 7, 4, 5, 6, 7,
+    6, 7, 8, 5, 6, 7, 8, 3, 4, 5, 7, 5, 6, 7, 4, 6,
+    7, 8, 5, 2, 6, 7, 5, 6, 3, 4, 7, 8, 4, 5, 6, 7,
+    8, 5, 7, 5, 6, 7, 5, 6, 7, 8, 5, 6, 7, 8, 5, 6,
+    7, 8, 7, 8, 5, 6, 7, 5, 6, 7, 3, 3, 2, 4, 5, 3,
+    5, 6, 3, 4, 5, 2, 4, 5, 2, 3, 2, 3, 4, 6, 5, 5,
+    4, 5, 4, 5, 6, 3, 4, 5, 2, 3, 4, 5, 4, 5, 6, 7,
+    4, 7, 5, 4, 6, 7, 2, 4, 3, 4, 5, 6, 3, 3, 3, 4,
+    5, 7, 6, 7, 3, 3, 2, 3, 4, 5, 4, 5, 6, 3, 4, 5,
+    7, 2, 7, 2, 6, 8, 3, 4, 5, 6, 7, 5, 7, 4, 6, 4,
+    5, 4, 2, 4, 5, 6, 7, 4, 6, 7, 5, 6, 7, 4, 5, 6,
+    7, 4, 5, 6, 7, 3, 4, 5, 6, 4, 5, 6, 4, 5, 3, 3,
+    3, 4, 4, 5, 2, 3, 4, 5, 6, 2, 4, 6, 3, 5, 5, 6,
+    7, 3, 4, 5, 6, 6, 6, 7, 5, 6, 7, 8, 5, 6, 7, 6,
+    7, 7, 8, 6, 3, 4, 2, 3, 4, 5, 6, 4, 2, 5, 6, 4,
+    4, 5, 6, 4, 6, 7, 4, 5, 6, 7, 5, 6, 7, 6, 7, 7,
+    7, 6, 7, 4, 3, 7, 4, 4, 5, 6, 7, 5, 4, 5, 5, 3,
+    4, 5, 6, 5, 6, 2, 3, 5, 5, 6, 5, 6, 6, 7, 8, 7,
+    8, 4, 4, 5, 6, 7, 2, 3, 5, 6, 7, 6, 5, 6, 5, 6,
+    5, 8, 6, 6, 4, 5, 2, 5, 6, 7, 4, 8, 4, 6, 7, 5,
+    6, 5, 7, 6, 7, 5, 6, 7, 8, 6, 6, 4, 5, 6, 8, 5,
+    6, 2, 4, 3, 4, 4, 5, 6, 5, 4, 6, 2, 4, 7, 7, 3,
+    5, 5, 2, 2, 5, 5, 2, 5, 4, 6, 4, 6, 4, 5, 5, 2,
+    6, 4, 5, 7, 6, 7, 2, 3, 4, 6, 2, 5, 6, 3, 5, 6,
+    6, 3, 5, 4, 6, 6, 3, 2, 3, 4, 4, 5, 3, 5, 4, 6,
+    2, 3, 4, 5, 6, 4, 2, 3, 4, 4, 5, 6, 6, 3, 6, 3,
+    5, 5, 6, 7, 6, 7, 4, 7, 5, 6, 7, 7, 2, 3, 4, 2,
+    2, 5, 5, 6, 7, 5, 3, 6, 7, 8, 3, 6, 4, 7, 2, 2,
+    4, 6, 5, 6, 6, 2, 6, 7, 4, 7, 2, 3, 6, 6, 7, 2,
+    4, 3, 5, 2, 3, 3, 5, 3, 4, 5, 6, 5, 4, 3, 2, 3,
+    4, 5, 3, 4, 6, 3, 4, 2, 3, 5, 5, 4, 5, 5, 6, 4,
+    5, 6, 7, 5, 4, 6, 5, 6, 4, 3, 2, 6, 6, 6, 6, 5,
+    6, 4, 2, 3, 5, 2, 3, 2, 2, 4, 2, 4, 4, 4, 5, 2,
+};
+
+static const uint16_t wordlist_bktree_first_child[1025] = {
+       1,    7,    7,    8,   14,   19,   25,   29,   30,   31,   32,   35,
+      38,   41,   41,   44,   48,   53,   59,   63,   63,   65,   72,   77,
+      82,   89,   94,  101,  107,  112,  112,  112,  112,  113,  114,  114,
+     116,  118,  121,  121,  121,  121,  122,  123,  123,  123,  125,  129,
+     130,  132,  136,  140,  143,  145,  146,  147,  148,  152,  156,  157,
+     157,  157,  157,  158,  158,  161,  161,  161,  161,  166,  170,  173,
+     173,  173,  177,  181,  187,  192,  194,  197,  201,  207,  210,  211,
+     212,  217,  221,  226,  229,  231,  232,  234,  234,  236,  237,  237,
+     238,  241,  245,  248,  252,  252,  252,  254,  258,  261,  266,  269,
+     269,  273,  277,  282,  287,  287,  287,  287,  287,  287,  287,  287,
+     287,  288,  288,  288,  291,  294,  295,  298,  301,  303,  303,  303,
+     303,  305,  308,  311,  311,  312,  316,  321,  322,  322,  325,  328,
+     328,  328,  328,  330,  332,  332,  333,  334,  337,  337,  337,  340,
+     340,  341,  341,  341,  343,  343,  343,  344,  344,  346,  346,  347,
+     347,  347,  347,  348,  348,  349,  349,  349,  349,  349,  351,  354,
+     357,  358,  361,  364,  369,  372,  374,  374,  374,  376,  380,  384,
+     385,  385,  385,  386,  388,  390,  390,  394,  399,  405,  410,  414,
+     418,  423,  428,  429,  430,  431,  434,  434,  435,  435,  435,  438,
+     439,  439,  440,  442,  445,  450,  450,  451,  452,  456,  460,  462,
+     466,  470,  471,  471,  471,  471,  471,  471,  471,  471,  471,  473,
+     474,  475,  476,  478,  481,  482,  482,  485,  486,  488,  489,  491,
+     491,  491,  491,  492,  495,  497,  498,  501,  505,  508,  508,  512,
+     515,  519,  523,  524,  526,  530,  531,  534,  534,  534,  536,  540,
+     545,  546,  547,  550,  554,  558,  562,  562,  562,  564,  567,  570,
+     570,  570,  571,  572,  573,  574,  575,  575,  575,  575,  575,  575,
+     576,  578,  578,  578,  578,  578,  578,  581,  584,  586,  588,  590,
+     591,  592,  592,  594,  597,  599,  600,  604,  608,  610,  610,  610,
+     610,  611,  611,  613,  614,  614,  614,  614,  614,  615,  616,  616,
+     620,  620,  620,  620,  620,  620,  621,  621,  621,  621,  621,  621,
+     621,  621,  621,  621,  622,  625,  626,  626,  628,  628,  628,  629,
+     629,  629,  630,  634,  634,  634,  635,  637,  640,  641,  643,  645,
+     646,  646,  646,  647,  647,  647,  650,  651,  651,  651,  652,  652,
+     653,  653,  655,  657,  658,  658,  658,  659,  660,  663,  666,  666,
+     666,  669,  673,  677,  677,  677,  677,  681,  684,  686,  686,  686,
+     687,  688,  690,  690,  692,  697,  700,  702,  705,  709,  710,  710,
+     710,  712,  716,  719,  719,  719,  720,  721,  723,  723,  723,  723,
+     723,  723,  724,  724,  724,  724,  726,  727,  727,  727,  728,  728,
+     731,  731,  731,  732,  733,  735,  736,  737,  739,  740,  742,  746,
+     746,  746,  746,  746,  749,  751,  751,  751,  752,  752,  753,  753,
+     753,  755,  755,  755,  755,  755,  755,  755,  755,  756,  757,  757,
+     758,  758,  758,  758,  758,  759,  763,  763,  763,  764,  764,  764,
+     764,  764,  764,  764,  765,  766,  766,  767,  771,  773,  776,  778,
+     778,  778,  780,  783,  785,  785,  785,  786,  786,  786,  790,  795,
+     796,  797,  798,  800,  800,  800,  802,  802,  802,  803,  803,  803,
+     803,  803,  803,  803,  803,  803,  803,  803,  803,  803,  803,  804,
+     804,  804,  806,  810,  812,  812,  812,  812,  812,  815,  815,  815,
+     817,  819,  819,  820,  821,  823,  825,  826,  826,  826,  826,  826,
+     827,  827,  830,  831,  831,  831,  831,  831,  831,  831,  831,  831,
+     831,  832,  833,  833,  833,  834,  834,  835,  835,  835,  835,  835,
+     835,  837,  837,  837,  837,  838,  838,  840,  840,  840,  840,  840,
+     840,  840,  840,  841,  843,  844,  846,  847,  847,  847,  847,  847,
+     847,  847,  847,  847,  847,  847,  847,  847,  847,  847,  847,  848,
+     849,  849,  849,  849,  850,  850,  850,  850,  851,  851,  851,  851,
+     853,  853,  854,  856,  857,  857,  857,  857,  857,  858,  858,  858,
+     858,  859,  859,  860,  860,  860,  860,  860,  860,  860,  860,  860,
+     861,  861,  862,  862,  862,  862,  862,  863,  864,  864,  865,  868,
+     870,  870,  870,  874,  877,  880,  880,  880,  881,  881,  881,  883,
+     883,  885,  886,  887,  887,  888,  888,  889,  890,  890,  890,  892,
+     894,  894,  894,  894,  896,  896,  896,  899,  901,  901,  902,  905,
+     908,  909,  911,  911,  911,  913,  916,  918,  918,  918,  920,  923,
+     923,  924,  924,  924,  924,  927,  928,  928,  928,  928,  928,  930,
+     930,  930,  930,  930,  930,  930,  930,  930,  930,  930,  930,  931,
+     931,  932,  932,  933,  934,  934,  934,  934,  934,  938,  938,  938,
+     938,  939,  939,  940,  940,  940,  940,  940,  940,  941,  941,  941,
+     941,  941,  941,  942,  942,  942,  942,  942,  942,  943,  944,  944,
+     944,  944,  945,  946,  948,  948,  948,  949,  949,  949,  949,  950,
+     950,  952,  952,  952,  952,  952,  952,  952,  952,  952,  952,  952,
+     952,  952,  952,  952,  953,  953,  953,  953,  953,  953,  953,  953,
+     953,  954,  956,  956,  956,  956,  956,  956,  957,  959,  959,  959,
+     959,  959,  959,  959,  959,  959,  960,  961,  961,  961,  961,  963,
+     963,  963,  963,  963,  963,  963,  963,  963,  963,  963,  964,  964,
+     965,  965,  965,  965,  965,  965,  965,  966,  966,  966,  966,  966,
+     966,  966,  967,  971,  971,  972,  972,  972,  973,  974,  974,  974,
+     974,  974,  974,  974,  974,  974,  974,  974,  974,  974,  974,  974,
+     974,  975,  975,  978,  981,  982,  983,  983,  983,  984,  985,  986,
+     987,  987,  988,  988,  988,  989,  989,  991,  995,  995,  995,  995,
+     995,  995,  995,  995,  995,  996,  996,  996,  996,  996,  998, 1000,
+    1000, 1000, 1000, 1001, 1001, 1002, 1002, 1003, 1004, 1004, 1004, 1004,
+    1004, 1005, 1005, 1005, 1005, 1005, 1006, 1006, 1006, 1007, 1007, 1007,
+    1008, 1008, 1008, 1008, 1008, 1008, 1008, 1008, 1008, 1008, 1009, 1010,
+    1010, 1010, 1010, 1010, 1010, 1010, 1010, 1010, 1010, 1013, 1013, 1013,
+    1013, 1013, 1013, 1013, 1013, 1014, 1015, 1015, 1015, 1015, 1015, 1015,
+    1015, 1016, 1016, 1016, 1016, 1018, 1018, 1020, 1021, 1021, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1024,
+    1024, 1024, 1024, 1024, 1024,
+};
+
+#endif /* WORDLIST_ENGLISH_HASH_H */
@@ -0,0 +1,427 @@
+//
+//  benchmark.c
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/bc-slip39.h"
+#include "test-utils.h"
+
+#define CORPUS_SHARES 100000
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t xorshift(uint32_t* state) {
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+// shares of the given length with random words and valid checksums
+static uint16_t* make_corpus(uint32_t words, uint32_t count) {
+  uint16_t* corpus = malloc(sizeof(uint16_t) * words * count);
+  uint32_t state = 2463534242u;
+  for(uint32_t i = 0; i < count; i++) {
+    uint16_t* share = corpus + i * words;
+    for(uint32_t j = 0; j < words; j++) {
+      share[j] = xorshift(&state) & 1023;
+    }
+    rs1024_create_checksum(share, words);
+  }
+  return corpus;
+}
+
+static void report(const char* name, double seconds, double items, const char* unit, double baseline) {
+  printf("%-40s %12.0f %s/s", name, items / seconds, unit);
+  if(baseline > 0) {
+    printf("  (%.1fx)", baseline / seconds);
+  }
+  printf("\n");
+}
+
+static void bench_rs1024_verify(uint32_t words) {
+  uint16_t* corpus = make_corpus(words, CORPUS_SHARES);
+  double total_words = (double)words * CORPUS_SHARES;
+  char name[64];
+  uint32_t valid = 0;
+
+  double start = now();
+  for(uint32_t i = 0; i < CORPUS_SHARES; i++) {
+    valid += rs1024_polymod_reference(corpus + i * words, words) == 1;
+  }
+  double reference = now() - start;
+
+  start = now();
+  for(uint32_t i = 0; i < CORPUS_SHARES; i++) {
+    valid += rs1024_verify_checksum(corpus + i * words, words);
+  }
+  double table = now() - start;
+
+  const uint16_t** pointers = malloc(sizeof(uint16_t*) * CORPUS_SHARES);
+  uint8_t* ok = malloc(CORPUS_SHARES);
+  for(uint32_t i = 0; i < CORPUS_SHARES; i++) {
+    pointers[i] = corpus + i * words;
+  }
+  start = now();
+  rs1024_verify_checksum_many(pointers, CORPUS_SHARES, words, ok);
+  double batch = now() - start;
+  for(uint32_t i = 0; i < CORPUS_SHARES; i++) {
+    valid += ok[i];
+  }
+  free(pointers);
+  free(ok);
+
+  if(valid != 3 * CORPUS_SHARES) {
+    printf("rs1024 verification failed\n");
+    exit(1);
+  }
+
+  snprintf(name, sizeof(name), "rs1024 verify, %d words, reference", words);
+  report(name, reference, total_words, "words", 0);
+  snprintf(name, sizeof(name), "rs1024 verify, %d words, table", words);
+  report(name, table, total_words, "words", reference);
+  snprintf(name, sizeof(name), "rs1024 verify, %d words, batch", words);
+  report(name, batch, total_words, "words", reference);
+
+  free(corpus);
+}
+
+#define LOOKUP_WORDS 4000000
+
+static void bench_word_for_string() {
+  const char** strings = malloc(sizeof(char*) * LOOKUP_WORDS);
+  uint32_t state = 2463534242u;
+  for(uint32_t i = 0; i < LOOKUP_WORDS; i++) {
+    strings[i] = slip39_string_for_word(xorshift(&state) & 1023);
+  }
+  uint32_t sum = 0;
+
+  double start = now();
+  for(uint32_t i = 0; i < LOOKUP_WORDS; i++) {
+    sum += slip39_word_for_string_reference(strings[i]);
+  }
+  double reference = now() - start;
+
+  start = now();
+  for(uint32_t i = 0; i < LOOKUP_WORDS; i++) {
+    sum -= slip39_word_for_string(strings[i]);
+  }
+  double hash = now() - start;
+
+  if(sum != 0) {
+    printf("word lookup failed\n");
+    exit(1);
+  }
+
+  report("word lookup, binary search", reference, LOOKUP_WORDS, "words", 0);
+  report("word lookup, perfect hash", hash, LOOKUP_WORDS, "words", reference);
+  free(strings);
+}
+
+#define NEAREST_LOOKUPS 20000
+
+static void bench_nearest_words() {
+  char (*typos)[12] = malloc(sizeof(*typos) * NEAREST_LOOKUPS);
+  uint32_t state = 2463534242u;
+  for(uint32_t i = 0; i < NEAREST_LOOKUPS; i++) {
+    strcpy(typos[i], slip39_string_for_word(xorshift(&state) & 1023));
+    typos[i][xorshift(&state) % strlen(typos[i])] = 'a' + xorshift(&state) % 26;
+  }
+  uint16_t words[1024];
+  uint32_t found = 0;
+
+  double start = now();
+  for(uint32_t i = 0; i < NEAREST_LOOKUPS; i++) {
+    for(int16_t w = 0; w < 1024; w++) {
+      found += slip39_string_distance(typos[i], slip39_string_for_word(w)) <= 1;
+    }
+  }
+  double scan = now() - start;
+
+  start = now();
+  for(uint32_t i = 0; i < NEAREST_LOOKUPS; i++) {
+    found -= slip39_nearest_words(typos[i], 1, words, NULL, 1024);
+  }
+  double tree = now() - start;
+
+  if(found != 0) {
+    printf("nearest word lookup failed\n");
+    exit(1);
+  }
+
+  report("nearest words within 1, scan", scan, NEAREST_LOOKUPS, "lookups", 0);
+  report("nearest words within 1, BK-tree", tree, NEAREST_LOOKUPS, "lookups", scan);
+  free(typos);
+}
+
+#define PARSE_SHARES 200000
+
+static void bench_share_parser() {
+  uint16_t* corpus = make_corpus(20, PARSE_SHARES);
+  size_t* offsets = malloc(sizeof(size_t) * PARSE_SHARES);
+  size_t size = slip39_format_shares(corpus, PARSE_SHARES, 20, NULL, 0, offsets);
+  char* text = malloc(size);
+  slip39_format_shares(corpus, PARSE_SHARES, 20, text, size, offsets);
+
+  uint16_t* words = malloc(sizeof(uint16_t) * 20 * PARSE_SHARES);
+  double start = now();
+  for(uint32_t i = 0; i < PARSE_SHARES; i++) {
+    slip39_words_for_strings(text + offsets[i], words + i * 20, 20);
+  }
+  double line_by_line = now() - start;
+
+  // the same shares as one file, a share per line
+  for(uint32_t i = 1; i < PARSE_SHARES; i++) {
+    text[offsets[i] - 1] = '\n';
+  }
+
+  uint16_t arena[4096];
+  uint32_t arena_offsets[129];
+  int32_t errors[128];
+  uint32_t parsed = 0;
+  uint32_t mismatches = 0;
+  slip39_share_parser parser;
+  start = now();
+  slip39_share_parser_init(&parser, arena, 4096, arena_offsets, errors, 128);
+  for(size_t at = 0; ; ) {
+    at += slip39_share_parser_feed(&parser, text + at, size - 1 - at);
+    if(at == size - 1) {
+      slip39_share_parser_finish(&parser);
+    }
+    for(uint32_t i = 0; i < parser.share_count; i++, parsed++) {
+      mismatches += errors[i] != 0 || memcmp(arena + arena_offsets[i], corpus + parsed * 20, 40) != 0;
+    }
+    slip39_share_parser_clear(&parser);
+    if(at == size - 1) {
+      break;
+    }
+  }
+  double streaming = now() - start;
+
+  if(memcmp(words, corpus, sizeof(uint16_t) * 20 * PARSE_SHARES) != 0 || parsed != PARSE_SHARES || mismatches != 0) {
+    printf("share parser failed\n");
+    exit(1);
+  }
+
+  report("parse shares, words_for_strings", line_by_line, size, "bytes", 0);
+  report("parse shares, streaming parser", streaming, size, "bytes", line_by_line);
+  free(words);
+  free(text);
+  free(offsets);
+  free(corpus);
+}
+
+static void bench_words_for_data(uint32_t size, uint32_t rounds) {
+  uint8_t* data = malloc(size);
+  uint32_t state = 2463534242u;
+  for(uint32_t i = 0; i < size; i++) {
+    data[i] = xorshift(&state);
+  }
+  uint32_t count = slip39_word_count_for_bytes(size);
+  uint16_t* words = malloc(sizeof(uint16_t) * count);
+  uint8_t* back = malloc(size);
+  char name[64];
+
+  double start = now();
+  for(uint32_t r = 0; r < rounds; r++) {
+    slip39_words_for_data_reference(data, size, words, count);
+    slip39_data_for_words_reference(words, count, back, size);
+  }
+  double reference = now() - start;
+
+  start = now();
+  for(uint32_t r = 0; r < rounds; r++) {
+    slip39_words_for_data(data, size, words, count);
+    slip39_data_for_words(words, count, back, size);
+  }
+  double kernels = now() - start;
+
+  if(memcmp(data, back, size) != 0) {
+    printf("words for data round trip failed\n");
+    exit(1);
+  }
+
+  snprintf(name, sizeof(name), "data to words and back, %d bytes, reference", size);
+  report(name, reference, (double)size * rounds, "bytes", 0);
+  snprintf(name, sizeof(name), "data to words and back, %d bytes, groups", size);
+  report(name, kernels, (double)size * rounds, "bytes", reference);
+  free(back);
+  free(words);
+  free(data);
+}
+
+// a corpus of 20 word shares kept packed, against the same shares as
+// 16 bit words: memory, checksums straight from the packed form, and
+// unpacking every share
+static void bench_packed() {
+  uint32_t words = 20;
+  uint32_t stride = slip39_packed_size_for_words(words);
+  uint16_t* corpus = make_corpus(words, CORPUS_SHARES);
+  uint8_t* packed = malloc(stride * CORPUS_SHARES);
+  uint16_t* unpacked = malloc(sizeof(uint16_t) * words * CORPUS_SHARES);
+  for(uint32_t i = 0; i < CORPUS_SHARES; i++) {
+    slip39_pack_words(corpus + i * words, words, packed + i * stride, stride);
+  }
+  printf("packed corpus, %d words: %d bytes a share rather than %d\n",
+    words, stride, (int)(sizeof(uint16_t) * words));
+
+  uint32_t valid = 0;
+  double start = now();
+  for(uint32_t i = 0; i < CORPUS_SHARES; i++) {
+    valid += rs1024_verify_checksum(corpus + i * words, words);
+  }
+  double words_verify = now() - start;
+
+  start = now();
+  for(uint32_t i = 0; i < CORPUS_SHARES; i++) {
+    uint16_t share[20];
+    slip39_unpack_words(packed + i * stride, words, share, words);
+    valid += rs1024_verify_checksum(share, words);
+  }
+  double unpack_verify = now() - start;
+
+  start = now();
+  for(uint32_t i = 0; i < CORPUS_SHARES; i++) {
+    valid += rs1024_verify_checksum_packed(packed + i * stride, words);
+  }
+  double packed_verify = now() - start;
+
+  start = now();
+  slip39_unpack_words(packed, words * CORPUS_SHARES, unpacked, words * CORPUS_SHARES);
+  double unpack_all = now() - start;
+
+  if(valid != 3 * CORPUS_SHARES || memcmp(corpus, unpacked, sizeof(uint16_t) * words * CORPUS_SHARES) != 0) {
+    printf("packed corpus failed\n");
+    exit(1);
+  }
+
+  double total_words = (double)words * CORPUS_SHARES;
+  report("rs1024 verify, 16 bit words", words_verify, total_words, "words", 0);
+  report("rs1024 verify, unpack each share", unpack_verify, total_words, "words", words_verify);
+  report("rs1024 verify, packed", packed_verify, total_words, "words", unpack_verify);
+  report("unpack whole corpus", unpack_all, total_words, "words", 0);
+  free(unpacked);
+  free(packed);
+  free(corpus);
+}
+
+// a dump of shares from many 2 of 3 splits, shuffled, recovered with one
+// thread and then with one per processor
+#define POOL_SPLITS 64
+
+static void pool_random(uint8_t *buf, size_t count, void* ctx) {
+  for(size_t i = 0; i < count; i++) {
+    buf[i] = xorshift(ctx);
+  }
+}
+
+static void bench_pool() {
+  uint32_t state = 2463534242u;
+  uint8_t secret[16] = {0};
+  uint16_t* shares = malloc(sizeof(uint16_t) * 20 * 3 * POOL_SPLITS);
+  group_descriptor group = { 2, 3, NULL };
+  uint32_t words = 0;
+  for(uint32_t i = 0; i < POOL_SPLITS; i++) {
+    slip39_generate(1, &group, 1, secret, 16, "", 0, &words, shares + i * 60, 60, &state, pool_random);
+  }
+
+  slip39_pool* pool;
+  slip39_pool_new(3 * POOL_SPLITS, &pool);
+  for(uint32_t i = 0; i < 3 * POOL_SPLITS; i++) {
+    uint32_t share = (i * 97) % (3 * POOL_SPLITS);
+    slip39_pool_add(pool, shares + share * 20, 20);
+  }
+  slip39_pool_result* results = malloc(sizeof(slip39_pool_result) * POOL_SPLITS);
+
+  double start = now();
+  slip39_pool_combine(pool, "", 1, results, POOL_SPLITS);
+  double serial = now() - start;
+
+  start = now();
+  uint32_t buckets = slip39_pool_combine(pool, "", 0, results, POOL_SPLITS);
+  double parallel = now() - start;
+
+  for(uint32_t i = 0; i < POOL_SPLITS; i++) {
+    if(buckets != POOL_SPLITS || results[i].status != 16) {
+      printf("pool combine failed\n");
+      exit(1);
+    }
+  }
+
+  report("pool combine, 1 thread", serial, POOL_SPLITS, "secrets", 0);
+  report("pool combine, all processors", parallel, POOL_SPLITS, "secrets", serial);
+  free(results);
+  slip39_pool_free(pool);
+  free(shares);
+}
+
+// shares of a 5 of 9 split arriving one at a time: trying
+// slip39_recover_ems over everything so far at each arrival, as a caller
+// without the combiner would, against adding each to a combiner. The
+// final decryption is the same either way and is left out.
+#define COMBINER_ROUNDS 20000
+
+static void bench_combiner() {
+  uint32_t state = 2463534242u;
+  uint8_t secret[16] = {0};
+  uint16_t shares[9 * 20];
+  group_descriptor group = { 5, 9, NULL };
+  uint32_t words = 0;
+  slip39_generate(1, &group, 1, secret, 16, "", 0, &words, shares, 9 * 20, &state, pool_random);
+  const uint16_t* arrived[9];
+  uint32_t recoveries = 0;
+
+  double start = now();
+  for(uint32_t r = 0; r < COMBINER_ROUNDS; r++) {
+    for(uint32_t i = 0; i < 5; i++) {
+      arrived[i] = shares + i * 20;
+      slip39_ems* ems;
+      recoveries += slip39_recover_ems(arrived, 20, i + 1, NULL, &ems) == 16;
+      slip39_ems_free(ems);
+    }
+  }
+  double rebuild = now() - start;
+
+  start = now();
+  for(uint32_t r = 0; r < COMBINER_ROUNDS; r++) {
+    slip39_combiner* combiner;
+    slip39_combiner_new(&combiner);
+    for(uint32_t i = 0; i < 5; i++) {
+      recoveries += slip39_combiner_add(combiner, shares + i * 20, 20, NULL) == 1;
+    }
+    slip39_combiner_free(combiner);
+  }
+  double incremental = now() - start;
+
+  if(recoveries != 2 * COMBINER_ROUNDS) {
+    printf("combiner failed\n");
+    exit(1);
+  }
+
+  report("shares one at a time, recover_ems", rebuild, COMBINER_ROUNDS * 5, "shares", 0);
+  report("shares one at a time, combiner", incremental, COMBINER_ROUNDS * 5, "shares", rebuild);
+}
+
+int main() {
+  bench_rs1024_verify(20);
+  bench_rs1024_verify(33);
+  bench_word_for_string();
+  bench_nearest_words();
+  bench_share_parser();
+  bench_words_for_data(32, 2000000);
+  bench_words_for_data(65536, 1000);
+  bench_packed();
+  bench_pool();
+  bench_combiner();
+}
@@ -1,7 +1,12 @@
 #include <stdio.h>
 #include <assert.h>
+#include <string.h>
 #include <strings.h>
+#include <stdlib.h>
+#include <dirent.h>
+#include <unistd.h>
 #include "../src/bc-slip39.h"
+#include <bc-crypto-base/bc-crypto-base.h>
 #include "test-utils.h"
 
 static void test_string_for_word() {
@@ -16,6 +21,126 @@ static void test_word_for_string() {
   assert(slip39_word_for_string("leader") == 512);
   assert(slip39_word_for_string("zero") == 1023);
   assert(slip39_word_for_string("FOOBAR") < 0);
+
+  // the perfect hash agrees with the binary search on every word, and on
+  // strings that share a bucket or a prefix with one
+  const char* misses[] = {"", "a", "acad", "academi", "academics", "academicx",
+    "zer", "zeros", "Zero", "acid ", "wristwatch", "yoga\x01"};
+  for(int16_t i = 0; i < 1024; i++) {
+    const char* word = slip39_string_for_word(i);
+    assert(slip39_word_for_string(word) == i);
+    assert(slip39_word_for_string_reference(word) == i);
+    char longer[16];
+    snprintf(longer, sizeof(longer), "%ss", word);
+    assert(slip39_word_for_string(longer) == slip39_word_for_string_reference(longer));
+    strcpy(longer, word);
+    longer[strlen(word) - 1] = 0;
+    assert(slip39_word_for_string(longer) == slip39_word_for_string_reference(longer));
+  }
+  for(int i = 0; i < sizeof(misses) / sizeof(misses[0]); i++) {
+    assert(slip39_word_for_string(misses[i]) == -1);
+  }
+}
+
+static void test_words_with_prefix() {
+  uint16_t words[1024];
+  assert(slip39_words_with_prefix("", words, 1024) == 1024);
+  assert(words[0] == 0 && words[1023] == 1023);
+
+  // every prefix of every word finds exactly the words a scan finds
+  for(int16_t w = 0; w < 1024; w++) {
+    const char* word = slip39_string_for_word(w);
+    char prefix[9];
+    for(size_t length = 1; length <= strlen(word); length++) {
+      memcpy(prefix, word, length);
+      prefix[length] = 0;
+      uint32_t count = slip39_words_with_prefix(prefix, words, 1024);
+      uint32_t expected = 0;
+      for(int16_t v = 0; v < 1024; v++) {
+        if(strncmp(slip39_string_for_word(v), prefix, length) == 0) {
+          assert(expected < count && words[expected] == v);
+          expected++;
+        }
+      }
+      assert(count == expected);
+    }
+  }
+
+  assert(slip39_words_with_prefix("gr", words, 3) == 14);
+  assert(strcmp(slip39_string_for_word(words[0]), "graduate") == 0);
+  assert(strcmp(slip39_string_for_word(words[2]), "grasp") == 0);
+  assert(slip39_words_with_prefix("x", words, 1024) == 0);
+  assert(slip39_words_with_prefix("grz", words, 1024) == 0);
+  assert(slip39_words_with_prefix("Gr", words, 1024) == 0);
+  assert(slip39_words_with_prefix("academics", words, 1024) == 0);
+
+  assert(slip39_word_for_abbreviation("acad") == 0);
+  assert(slip39_word_for_abbreviation("acade") == 0);
+  assert(slip39_word_for_abbreviation("academic") == 0);
+  assert(slip39_word_for_abbreviation("zero") == 1023);
+  assert(slip39_word_for_abbreviation("aca") == -1);
+  assert(slip39_word_for_abbreviation("acadx") == -1);
+  assert(slip39_word_for_abbreviation("academics") == -1);
+
+  const char* full = "shadow pistol academic always adequate wildlife fancy gross oasis cylinder mustang wrist rescue view short owner flip making coding armed";
+  const char* abbreviated = "shad pist acad alwa adeq wild fanc gros oasi cyli must wris resc view shor owne flip maki codi arme";
+  uint16_t expected[32];
+  uint32_t n = slip39_words_for_strings(full, expected, 32);
+  assert(slip39_words_for_strings(abbreviated, words, 32) == n);
+  assert(equal_uint16_buffers(expected, n, words, n));
+  assert(slip39_words_for_strings("shadow pistol acadx always", words, 32) == UINT32_MAX);
+}
+
+static void test_nearest_words() {
+  assert(slip39_string_distance("ca", "abc") == 2);
+  assert(slip39_string_distance("acdemic", "academic") == 1);
+  assert(slip39_string_distance("acadmeic", "academic") == 1);
+  assert(slip39_string_distance("", "zero") == 4);
+  assert(slip39_string_distance("abcdefghijklmnopq", "a") == UINT32_MAX);
+
+  // the tree finds exactly what comparing against every word finds
+  uint32_t state = 12345;
+  uint16_t words[1024];
+  uint8_t distances[1024];
+  for(int t = 0; t < 2000; t++) {
+    state = state * 1103515245 + 12345;
+    char typo[12];
+    strcpy(typo, slip39_string_for_word((state >> 8) & 1023));
+    size_t length = strlen(typo);
+    for(int e = 0; e < 1 + (t % 3); e++) {
+      state = state * 1103515245 + 12345;
+      size_t at = (state >> 8) % length;
+      switch((state >> 20) % 4) {
+        case 0: typo[at] = 'a' + (state >> 4) % 26; break;
+        case 1: memmove(typo + at, typo + at + 1, length - at); length--; break;
+        case 2: memmove(typo + at + 1, typo + at, length - at + 1); typo[at] = 'a' + (state >> 4) % 26; length++; break;
+        default: if(at + 1 < length) { char c = typo[at]; typo[at] = typo[at+1]; typo[at+1] = c; } break;
+      }
+    }
+    uint32_t max_distance = t % 3;
+    uint32_t found = slip39_nearest_words(typo, max_distance, words, distances, 1024);
+    uint32_t expected = 0;
+    for(int16_t w = 0; w < 1024; w++) {
+      expected += slip39_string_distance(typo, slip39_string_for_word(w)) <= max_distance;
+    }
+    assert(found == expected);
+    for(uint32_t i = 0; i < found; i++) {
+      assert(distances[i] == slip39_string_distance(typo, slip39_string_for_word(words[i])));
+      assert(i == 0 || distances[i-1] < distances[i] || (distances[i-1] == distances[i] && words[i-1] < words[i]));
+    }
+  }
+
+  assert(slip39_nearest_words("acdemic", 1, words, distances, 1) == 1);
+  assert(words[0] == 0 && distances[0] == 1);
+
+  slip39_word_candidates candidates[8];
+  assert(slip39_word_candidates_for_strings("Shadow pistl acad qqqqqqqq alvays", 1, candidates, 8) == 5);
+  assert(candidates[0].count == 1 && candidates[0].words[0] == slip39_word_for_string("shadow"));
+  assert(candidates[1].count >= 1 && candidates[1].words[0] == slip39_word_for_string("pistol"));
+  assert(candidates[1].distances[0] == 1);
+  assert(candidates[2].count == 1 && candidates[2].words[0] == 0 && candidates[2].distances[0] == 0);
+  assert(candidates[3].count == 0);
+  assert(candidates[4].words[0] == slip39_word_for_string("always"));
 }
 
 static void test_counts() {
@@ -44,6 +169,139 @@ static void test_words() {
   free(output_data);
 }
 
+// the group kernels agree with the bit at a time conversion on every
+// length a secret can have, and on lengths long enough for the vector path
+static void test_words_data_kernels() {
+  uint32_t state = 987654321;
+  uint8_t data[1024];
+  uint8_t data_fast[1040];
+  uint8_t data_reference[1040];
+  uint16_t words[1024];
+  uint16_t words_fast[1024];
+  uint16_t words_reference[1024];
+
+  size_t lengths[48];
+  int length_count = 0;
+  for(size_t size = 0; size <= 40; size++) {
+    lengths[length_count++] = size;
+  }
+  lengths[length_count++] = 100;
+  lengths[length_count++] = 129;
+  lengths[length_count++] = 500;
+  lengths[length_count++] = 1023;
+
+  for(int l = 0; l < length_count; l++) {
+    size_t size = lengths[l];
+    uint32_t count = slip39_word_count_for_bytes(size);
+    for(int t = 0; t < 200; t++) {
+      for(size_t i = 0; i < size; i++) {
+        state = state * 1103515245 + 12345;
+        // runs of zero bytes and of ones as well as noise
+        data[i] = t % 4 == 0 ? 0 : t % 4 == 1 ? 0xff : state >> 16;
+      }
+      if(t % 4 < 2 && size > 0) {
+        data[(state >> 8) % size] = state >> 16;
+      }
+      assert(slip39_words_for_data(data, size, words_fast, count) == count);
+      assert(slip39_words_for_data_reference(data, size, words_reference, count) == count);
+      assert(equal_uint16_buffers(words_fast, count, words_reference, count));
+
+      // words as they come, words with bad padding, words that are too
+      // wide and words small enough to look like a dropped zero byte
+      memcpy(words, words_fast, sizeof(uint16_t) * count);
+      if(count > 0) {
+        state = state * 1103515245 + 12345;
+        switch(t % 5) {
+          case 1: words[0] |= 1 << (9 - (state >> 16) % 8); break;
+          case 2: words[(state >> 8) % count] |= 1024; break;
+          case 3: words[(state >> 8) % count] &= 3; break;
+          default: break;
+        }
+      }
+      memset(data_fast, 0xee, sizeof(data_fast));
+      memset(data_reference, 0xee, sizeof(data_reference));
+      int32_t fast = slip39_data_for_words(words, count, data_fast, sizeof(data_fast));
+      int32_t reference = slip39_data_for_words_reference(words, count, data_reference, sizeof(data_reference));
+      assert(fast == reference);
+      assert(equal_uint8_buffers(data_fast, sizeof(data_fast), data_reference, sizeof(data_reference)));
+      if(t % 5 == 0 && count % 8 != 4 && slip39_byte_count_for_words(count) == size) {
+        assert(fast == size && equal_uint8_buffers(data_fast, size, data, size));
+      }
+
+      uint32_t needed = slip39_byte_count_for_words(count);
+      if(needed > 0) {
+        assert(slip39_data_for_words(words_fast, count, data_fast, needed - 1) ==
+          slip39_data_for_words_reference(words_fast, count, data_reference, needed - 1));
+      }
+    }
+  }
+}
+
+static void test_packed() {
+  // every length, so that the vector kernels and every tail are covered
+  uint16_t words[96], back[96];
+  uint8_t packed[121];
+  uint32_t state = 12345;
+  for(uint32_t count = 0; count <= 96; count++) {
+    for(uint32_t i = 0; i < count; i++) {
+      state = state * 1103515245 + 12345;
+      words[i] = (state >> 16) & 1023;
+    }
+    uint32_t size = slip39_packed_size_for_words(count);
+    memset(packed, 0xff, sizeof(packed));
+    assert(slip39_pack_words(words, count, packed, size) == (int32_t) size);
+    assert(size == 0 || count % 4 == 0 || (packed[size - 1] & ((1 << (size * 8 - count * 10)) - 1)) == 0);
+    assert(packed[size] == 0xff);
+    assert(slip39_unpack_words(packed, count, back, 96) == (int32_t) count);
+    assert(memcmp(words, back, sizeof(uint16_t) * count) == 0);
+    assert(rs1024_polymod_packed(packed, count) == rs1024_polymod(words, count));
+  }
+  assert(slip39_pack_words(words, 8, packed, 9) == ERROR_INSUFFICIENT_SPACE);
+  assert(slip39_unpack_words(packed, 8, back, 7) == ERROR_INSUFFICIENT_SPACE);
+  words[3] = 1024;
+  assert(slip39_pack_words(words, 8, packed, 10) == ERROR_INVALID_WORD);
+
+  // shares of each strength decode the same packed as unpacked; 24 bytes
+  // takes 20 value words, which drop a zero top byte
+  uint8_t secret[32];
+  for(uint32_t i = 0; i < 32; i++) {
+    secret[i] = 0x11 * (i + 1);
+  }
+  for(uint32_t length = 16; length <= 32; length += 8) {
+    group_descriptor groups[] = { { 2, 3, NULL } };
+    uint32_t n = 0;
+    uint16_t shares[1024];
+    assert(slip39_generate(1, groups, 1, secret, length, "", 0, &n, shares, 1024, NULL, fake_random) == 3);
+
+    uint8_t packed_shares[3][48];
+    const uint8_t* pointers[3];
+    for(uint32_t i = 0; i < 3; i++) {
+      const uint16_t* share = shares + i * n;
+      assert(slip39_pack_words(share, n, packed_shares[i], 48) == (int32_t) slip39_packed_size_for_words(n));
+      assert(rs1024_verify_checksum_packed(packed_shares[i], n));
+      pointers[i] = packed_shares[i];
+
+      slip39_shard shard;
+      assert(decode_packed_mnemonic(packed_shares[i], n, &shard) == (int) length);
+      uint8_t value[32];
+      assert(slip39_data_for_words(share + 4, n - 7, value, 32) == (int32_t) length);
+      assert(memcmp(shard.value, value, length) == 0);
+      assert(shard.identifier == (share[0] << 5 | share[1] >> 5));
+      assert(shard.member_index == i && shard.member_threshold == 2);
+      assert(shard.group_threshold == 1 && shard.group_count == 1);
+    }
+
+    uint8_t recovered[32];
+    assert(slip39_combine_packed(pointers, n, 2, "", NULL, recovered, 32) == (int) length);
+    assert(memcmp(recovered, secret, length) == 0);
+
+    packed_shares[1][7] ^= 0x10;
+    slip39_shard shard;
+    assert(decode_packed_mnemonic(packed_shares[1], n, &shard) == ERROR_INVALID_MNEMONIC_CHECKSUM);
+    assert(slip39_combine_packed(pointers, n, 2, "", NULL, recovered, 32) == ERROR_INVALID_MNEMONIC_CHECKSUM);
+  }
+}
+
 static void test_strings() {
   uint16_t words[] = {0, 0, 258, 14, 687, 1023, 1006};
   size_t words_len = 7;
@@ -54,6 +312,168 @@ static void test_strings() {
   size_t words_written = slip39_words_for_strings(string, output_words, words_len);
   assert(equal_uint16_buffers(words, words_len, output_words, words_written));
   free(string);
+
+  // the size needed is reported, and nothing written, unless it all fits
+  char buffer[64];
+  size_t needed = strlen(expected_string) + 1;
+  memset(buffer, 'x', sizeof(buffer));
+  assert(slip39_format_words(words, words_len, buffer, needed - 1) == needed);
+  assert(buffer[0] == 'x');
+  assert(slip39_format_words(words, words_len, buffer, needed) == needed);
+  assert(equal_strings(buffer, expected_string));
+  assert(slip39_format_words(words, 0, buffer, 1) == 1 && buffer[0] == 0);
+  assert(slip39_format_words(words, 0, NULL, 0) == 1);
+}
+
+static void test_format_shares() {
+  uint8_t secret[] = {0xbb, 0x54, 0xaa, 0xc4, 0xb8, 0x9d, 0xc8, 0x68, 0xba, 0x37, 0xd9, 0xcc, 0x21, 0xb2, 0xce, 0xce};
+  group_descriptor groups[] = { { 2, 3, NULL }, { 3, 5, NULL } };
+  uint32_t words_in_each_share = 0;
+  uint16_t shares[1024];
+  int count = slip39_generate(2, groups, 2, secret, 16, "", 0, &words_in_each_share, shares, 1024, NULL, fake_random);
+  assert(count == 8);
+
+  size_t offsets[8];
+  size_t needed = slip39_format_shares(shares, count, words_in_each_share, NULL, 0, offsets);
+  char* arena = malloc(needed);
+  assert(slip39_format_shares(shares, count, words_in_each_share, arena, needed, offsets) == needed);
+  for(int i = 0; i < count; i++) {
+    char* expected = slip39_strings_for_words(shares + i * words_in_each_share, words_in_each_share);
+    assert(equal_strings(arena + offsets[i], expected));
+    assert(i == count - 1 || offsets[i + 1] == offsets[i] + strlen(expected) + 1);
+    free(expected);
+  }
+  assert(offsets[0] == 0 && offsets[count - 1] + strlen(arena + offsets[count - 1]) + 1 == needed);
+  free(arena);
+}
+
+// parse text in chunks of the given size, emptying the arrays whenever
+// they fill, and collect every share into words, offsets and errors
+static uint32_t parse_in_chunks(const char* text, size_t chunk, uint32_t words_capacity,
+    uint16_t* all_words, uint32_t* all_offsets, int32_t* all_errors) {
+  uint16_t words[256];
+  uint32_t offsets[9];
+  int32_t errors[8];
+  slip39_share_parser parser;
+  slip39_share_parser_init(&parser, words, words_capacity, offsets, errors, 8);
+
+  uint32_t shares = 0;
+  all_offsets[0] = 0;
+  size_t length = strlen(text);
+  for(size_t at = 0; ; ) {
+    size_t n = length - at < chunk ? length - at : chunk;
+    size_t parsed = slip39_share_parser_feed(&parser, text + at, n);
+    at += parsed;
+    if(at == length) {
+      slip39_share_parser_finish(&parser);
+    }
+    for(uint32_t i = 0; i < parser.share_count; i++) {
+      memcpy(all_words + all_offsets[shares], words + offsets[i], sizeof(uint16_t) * (offsets[i+1] - offsets[i]));
+      all_errors[shares] = errors[i];
+      all_offsets[shares + 1] = all_offsets[shares] + offsets[i+1] - offsets[i];
+      shares++;
+    }
+    slip39_share_parser_clear(&parser);
+    if(at == length) {
+      break;
+    }
+  }
+  return shares;
+}
+
+static void test_share_parser() {
+  const char* text =
+    "shadow pistol academic always adequate wildlife fancy gross oasis cylinder mustang wrist rescue view short owner flip making coding armed\n"
+    "\n"
+    "  SHADOW Pistol acad alwa\r\n"
+    "shadow pistolx academic\n"
+    "zero zero zero zero zero zero zero zero zero zero zero zero zero zero zero zero zero zero zero zero "
+    "zero zero zero zero zero zero zero zero zero zero zero zero zero zero zero zero\n"
+    "\t\t\n"
+    "academicacademic zero\n"
+    "coding,armed;flip";
+
+  uint16_t expected_words[128];
+  uint32_t expected_offsets[8] = {0};
+  uint32_t n = slip39_words_for_strings("shadow pistol academic always adequate wildlife fancy gross oasis cylinder mustang wrist rescue view short owner flip making coding armed", expected_words, 128);
+  expected_offsets[1] = n;
+  n += slip39_words_for_strings("shadow pistol academic always", expected_words + n, 128 - n);
+  expected_offsets[2] = n;
+  n += slip39_words_for_strings("shadow academic", expected_words + n, 128 - n);
+  expected_offsets[3] = n;
+  for(int i = 0; i < SLIP39_MAX_SHARE_WORDS; i++) {
+    expected_words[n++] = 1023;
+  }
+  expected_offsets[4] = n;
+  expected_words[n++] = 1023;
+  expected_offsets[5] = n;
+  n += slip39_words_for_strings("coding armed flip", expected_words + n, 128 - n);
+  expected_offsets[6] = n;
+  int32_t expected_errors[] = {0, 0, ERROR_INVALID_WORD, ERROR_TOO_MANY_WORDS, ERROR_INVALID_WORD, 0};
+
+  size_t chunks[] = {1, 3, 7, 16, 17, 64, 4096};
+  uint32_t capacities[] = {256, SLIP39_MAX_SHARE_WORDS};
+  for(int c = 0; c < 7; c++) {
+    for(int k = 0; k < 2; k++) {
+      uint16_t words[256];
+      uint32_t offsets[16];
+      int32_t errors[16];
+      assert(parse_in_chunks(text, chunks[c], capacities[k], words, offsets, errors) == 6);
+      for(int i = 0; i < 6; i++) {
+        assert(errors[i] == expected_errors[i]);
+        assert(offsets[i+1] == expected_offsets[i+1]);
+      }
+      assert(equal_uint16_buffers(words, offsets[6], expected_words, expected_offsets[6]));
+    }
+  }
+}
+
+static void _check_round_function(const char* passphrase) {
+  uint8_t salt[] = {'s', 'h', 'a', 'm', 'i', 'r', 0x12, 0x34};
+  uint8_t r[] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+  size_t pass_len = strlen(passphrase) + 1;
+  uint8_t pass[pass_len];
+  uint8_t saltr[sizeof(salt) + sizeof(r)];
+  uint8_t expected[40];
+  uint8_t output[40];
+
+  pass[0] = 2;
+  memcpy(pass + 1, passphrase, pass_len - 1);
+  memcpy(saltr, salt, sizeof(salt));
+  memcpy(saltr + sizeof(salt), r, sizeof(r));
+
+  // lengths on both sides of a single digest
+  size_t lengths[] = {8, 16, 32, 40};
+  for(int i = 0; i < 4; i++) {
+    pbkdf2_hmac_sha256(pass, pass_len, saltr, sizeof(saltr), BASE_ITERATION_COUNT, expected, lengths[i]);
+    round_function(2, passphrase, 0, salt, sizeof(salt), r, sizeof(r), output, lengths[i]);
+    assert(equal_uint8_buffers(expected, lengths[i], output, lengths[i]));
+  }
+}
+
+static void test_round_function() {
+  _check_round_function("");
+  _check_round_function("TREZOR");
+  _check_round_function("a passphrase that is long enough that the HMAC key needs hashing first");
+}
+
+static void test_kdf_context() {
+  uint8_t secret[] = {0xbb, 0x54, 0xaa, 0xc4, 0xb8, 0x9d, 0xc8, 0x68, 0xba, 0x37, 0xd9, 0xcc, 0x21, 0xb2, 0xce, 0xce};
+  uint8_t expected[16];
+  uint8_t encrypted[16];
+  uint8_t decrypted[16];
+
+  slip39_kdf_context* context = slip39_kdf_context_new("TREZOR");
+  assert(context != NULL);
+
+  slip39_encrypt(secret, 16, "TREZOR", 0, 7945, expected);
+  slip39_encrypt_ctx(secret, 16, context, 0, 7945, encrypted);
+  assert(equal_uint8_buffers(expected, 16, encrypted, 16));
+
+  slip39_decrypt_ctx(encrypted, 16, context, 0, 7945, decrypted);
+  assert(equal_uint8_buffers(secret, 16, decrypted, 16));
+
+  slip39_kdf_context_free(context);
 }
 
 static void test_generate_and_combine() {
@@ -508,12 +928,1066 @@ static void test_combine() {
   );
 }
 
+static void test_crypt_many() {
+  const char* passphrases[] = {"", "TREZOR", "a passphrase that is long enough that the HMAC key needs hashing first"};
+  size_t count = 19; // more than one batch of the widest kernel, and a partial one
+  uint8_t inputs[count][32];
+  uint8_t expected[count][32];
+  uint8_t outputs[count][32];
+  uint8_t decrypted[count][32];
+  slip39_crypt_request requests[count];
+
+  for(int i = 0; i < count; i++) {
+    requests[i].input = inputs[i];
+    requests[i].input_length = (i % 3 == 0) ? 32 : 16;
+    requests[i].passphrase = passphrases[i % 3];
+    requests[i].iteration_exponent = (i % 4 == 0) ? 1 : 0;
+    requests[i].identifier = 1000 * i;
+    requests[i].output = outputs[i];
+    for(int j = 0; j < 32; j++) {
+      inputs[i][j] = i * 32 + j;
+    }
+    slip39_encrypt(inputs[i], requests[i].input_length, requests[i].passphrase,
+      requests[i].iteration_exponent, requests[i].identifier, expected[i]);
+  }
+
+  uint32_t widths[] = {1, 8, 16};
+  for(int w = 0; w < 3; w++) {
+    if(!slip39_sha256_select_lane_width(widths[w])) {
+      printf("skipping unsupported sha256 lane width: %d\n", widths[w]);
+      continue;
+    }
+
+    assert(slip39_encrypt_many(requests, count) == 0);
+    for(int i = 0; i < count; i++) {
+      assert(equal_uint8_buffers(expected[i], requests[i].input_length, outputs[i], requests[i].input_length));
+      requests[i].input = expected[i];
+      requests[i].output = decrypted[i];
+    }
+
+    assert(slip39_decrypt_many(requests, count) == 0);
+    for(int i = 0; i < count; i++) {
+      assert(equal_uint8_buffers(inputs[i], requests[i].input_length, decrypted[i], requests[i].input_length));
+      requests[i].input = inputs[i];
+      requests[i].output = outputs[i];
+    }
+  }
+  slip39_sha256_select_lane_width(0);
+
+  // one bad request turns the whole batch away before anything is written
+  memset(outputs, 0, sizeof(outputs));
+  requests[count - 1].input_length = 17;
+  assert(slip39_encrypt_many(requests, count) == ERROR_INVALID_SECRET_LENGTH);
+  requests[count - 1].input_length = 66;
+  assert(slip39_decrypt_many(requests, count) == ERROR_INVALID_SECRET_LENGTH);
+  requests[count - 1].input_length = 16;
+  requests[count - 1].iteration_exponent = MAX_ITERATION_EXPONENT + 1;
+  assert(slip39_encrypt_many(requests, count) == ERROR_INVALID_ITERATION_EXPONENT);
+  for(int i = 0; i < count; i++) {
+    for(int j = 0; j < 32; j++) {
+      assert(outputs[i][j] == 0);
+    }
+  }
+}
+
+// chains of unequal length share the vector lanes, and each has to stop
+// at its own count with both u and t as a chain run on its own leaves them
+static void test_iterate_many_counts() {
+  uint32_t inner[SHA256_STATE_WORDS], outer[SHA256_STATE_WORDS];
+  for(int j = 0; j < SHA256_STATE_WORDS; j++) {
+    inner[j] = 0x6a09e667 + j * 0x1234567;
+    outer[j] = 0xbb67ae85 ^ j * 0x7654321;
+  }
+  uint32_t counts[] = {10, 3, 3, 0, 7, 1, 10, 2, 5, 9, 4, 3, 8, 6, 1, 0, 11, 2};
+  uint32_t lane_count = sizeof(counts) / sizeof(counts[0]);
+  slip39_hmac_sha256_lane expected[lane_count], lanes[lane_count];
+  for(uint32_t l = 0; l < lane_count; l++) {
+    expected[l].inner = inner;
+    expected[l].outer = outer;
+    expected[l].count = counts[l];
+    for(int j = 0; j < SHA256_STATE_WORDS; j++) {
+      expected[l].u[j] = l * 131 + j;
+      expected[l].t[j] = l * 977 ^ j;
+    }
+    lanes[l] = expected[l];
+    slip39_hmac_sha256_iterate(inner, outer, expected[l].u, expected[l].t, counts[l]);
+  }
+  slip39_hmac_sha256_lane start[lane_count];
+  memcpy(start, lanes, sizeof(lanes));
+
+  uint32_t widths[] = {1, 8, 16};
+  for(int w = 0; w < 3; w++) {
+    if(!slip39_sha256_select_lane_width(widths[w])) {
+      continue;
+    }
+    memcpy(lanes, start, sizeof(lanes));
+    slip39_hmac_sha256_iterate_many(lanes, lane_count);
+    for(uint32_t l = 0; l < lane_count; l++) {
+      assert(memcmp(lanes[l].u, expected[l].u, sizeof(expected[l].u)) == 0);
+      assert(memcmp(lanes[l].t, expected[l].t, sizeof(expected[l].t)) == 0);
+    }
+  }
+  slip39_sha256_select_lane_width(0);
+}
+
+static uint8_t _verify_trezor_vector(const uint8_t* secret, uint32_t secret_length, const char* passphrase, void* context) {
+  uint8_t expected[] = {0xbb, 0x54, 0xaa, 0xc4, 0xb8, 0x9d, 0xc8, 0x68, 0xba, 0x37, 0xd9, 0xcc, 0x21, 0xb2, 0xce, 0xce};
+  return equal_uint8_buffers(expected, 16, (uint8_t*)secret, secret_length);
+}
+
+static uint8_t _verify_and_cancel(const uint8_t* secret, uint32_t secret_length, const char* passphrase, void* context) {
+  __atomic_store_n((uint8_t*)context, 1, __ATOMIC_RELEASE);
+  return 0;
+}
+
+static uint8_t _trezo_candidate(uint64_t index, char* passphrase, uint32_t passphrase_length, void* context) {
+  snprintf(passphrase, passphrase_length, "TREZO%c", (char)('A' + index));
+  return 1;
+}
+
+static void _count_progress(uint64_t tried, uint64_t total, double rate, void* context) {
+  assert(tried <= total);
+  (*(int*)context)++;
+}
+
+static int _search(const slip39_passphrase_source* source, slip39_verify_fn verify, void* verify_context,
+    const slip39_search_options* options, slip39_search_result* result) {
+  const char* share = "duckling enlarge academic academic agency result length solution fridge kidney coal piece deal husband erode duke ajar critical decision keyboard";
+  uint16_t words[100];
+  uint32_t word_count = slip39_words_for_strings(share, words, 100);
+  const uint16_t* mnemonics[] = { words };
+  return slip39_search_passphrase(mnemonics, word_count, 1, NULL, source, verify, verify_context, options, result);
+}
+
+static void test_search_passphrase() {
+  slip39_search_result result;
+  int progress_calls = 0;
+  slip39_search_options options = { 2, 4, _count_progress, &progress_calls, 0, NULL };
+
+  slip39_passphrase_source mask = { SLIP39_SOURCE_MASK };
+  mask.mask = "?uREZO?u";
+  assert(slip39_source_count(&mask) == 26 * 26);
+  assert(_search(&mask, _verify_trezor_vector, NULL, &options, &result) == 1);
+  assert(equal_strings(result.passphrase, "TREZOR"));
+  assert(result.secret_length == 16);
+  assert(_verify_trezor_vector(result.secret, result.secret_length, NULL, NULL));
+  assert(result.tried > 0 && result.tried <= 26 * 26);
+  assert(progress_calls > 0);
+
+  const char* words[] = { "trezor", "", "TREZOR", "Trezor" };
+  slip39_passphrase_source dictionary = { SLIP39_SOURCE_DICTIONARY, words, 4 };
+  assert(_search(&dictionary, _verify_trezor_vector, NULL, NULL, &result) == 1);
+  assert(equal_strings(result.passphrase, "TREZOR"));
+
+  slip39_passphrase_source callback = { SLIP39_SOURCE_CALLBACK };
+  callback.generate = _trezo_candidate;
+  callback.count = 26;
+  assert(_search(&callback, _verify_trezor_vector, NULL, &options, &result) == 1);
+  assert(equal_strings(result.passphrase, "TREZOR"));
+
+  // exhausting the source is not an error
+  slip39_passphrase_source wrong = { SLIP39_SOURCE_DICTIONARY, words, 2 };
+  assert(_search(&wrong, _verify_trezor_vector, NULL, &options, &result) == 0);
+  assert(result.tried == 2);
+
+  uint8_t cancel = 0;
+  slip39_search_options cancellable = { 1, 1, NULL, NULL, 0, &cancel };
+  slip39_passphrase_source digits = { SLIP39_SOURCE_MASK };
+  digits.mask = "?d?d";
+  assert(_search(&digits, _verify_and_cancel, &cancel, &cancellable, &result) == ERROR_CANCELLED);
+  assert(result.tried < 100);
+
+  slip39_passphrase_source bad = { SLIP39_SOURCE_MASK };
+  bad.mask = "abc?x";
+  assert(slip39_source_count(&bad) == ERROR_INVALID_MASK);
+  assert(_search(&bad, _verify_trezor_vector, NULL, NULL, &result) == ERROR_INVALID_MASK);
+  bad.mask = "??a?";
+  assert(slip39_source_count(&bad) == ERROR_INVALID_MASK);
+  bad.mask = "??a";
+  assert(slip39_source_count(&bad) == 1);
+
+  const char* lower[] = { "trezor", "rozert" };
+  const char* rules[] = { ":", "c $1", "r u", "d" };
+  slip39_passphrase_source ruled = { SLIP39_SOURCE_DICTIONARY, lower, 2 };
+  ruled.rules = rules;
+  ruled.rule_count = 4;
+  assert(slip39_source_count(&ruled) == 8);
+  assert(_search(&ruled, _verify_trezor_vector, NULL, &options, &result) == 1);
+  assert(equal_strings(result.passphrase, "TREZOR"));
+  rules[1] = "$";
+  assert(slip39_source_count(&ruled) == ERROR_INVALID_RULE);
+}
+
+static uint8_t _verify_and_stop_after(const uint8_t* secret, uint32_t secret_length, const char* passphrase, void* context) {
+  int* calls = (int*)context;
+  if(++calls[0] == calls[1]) {
+    __atomic_store_n((uint8_t*)&calls[2], 1, __ATOMIC_RELEASE);
+  }
+  return _verify_trezor_vector(secret, secret_length, passphrase, NULL);
+}
+
+static void _remove_directory(const char* directory) {
+  DIR* dir = opendir(directory);
+  struct dirent* entry;
+  char path[1024];
+  while((entry = readdir(dir)) != NULL) {
+    if(entry->d_name[0] != '.') {
+      snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+      unlink(path);
+    }
+  }
+  closedir(dir);
+  rmdir(directory);
+}
+
+static void test_search_job() {
+  const char* share = "duckling enlarge academic academic agency result length solution fridge kidney coal piece deal husband erode duke ajar critical decision keyboard";
+  uint16_t words[100];
+  uint32_t word_count = slip39_words_for_strings(share, words, 100);
+  const uint16_t* mnemonics[] = { words };
+  slip39_ems* ems = NULL;
+  assert(slip39_recover_ems(mnemonics, word_count, 1, NULL, &ems) == 16);
+
+  char directory[] = "/tmp/slip39-job-XXXXXX";
+  assert(mkdtemp(directory) != NULL);
+  char checkpoint[1024];
+  snprintf(checkpoint, sizeof(checkpoint), "%s/checkpoint-a", directory);
+
+  // TREZOR is candidate 19 * 26 + 17 = 511, in chunk 5
+  slip39_passphrase_source mask = { SLIP39_SOURCE_MASK };
+  mask.mask = "?uREZO?u";
+  slip39_job job = { directory, checkpoint, "a", 100, 0, 0, 25 };
+  assert(slip39_job_chunk_count(26 * 26, 100) == 7);
+
+  // stop part way through chunk 1, as if the process had been killed
+  int calls[3] = { 0, 130, 0 };
+  slip39_search_options options = { 1, 1, NULL, NULL, 0, (uint8_t*)&calls[2] };
+  slip39_search_result result;
+  assert(slip39_job_run(ems, &mask, &job,
+    _verify_and_stop_after, calls, &options, &result) == ERROR_CANCELLED);
+  int first_run = calls[0];
+  assert(first_run >= 130 && first_run < 150);
+
+  // a different chunking of the same search can't join in
+  slip39_job other = job;
+  other.chunk_size = 50;
+  other.checkpoint = "/tmp/slip39-job-unused";
+  assert(slip39_job_run(ems, &mask, &other,
+    _verify_trezor_vector, NULL, NULL, &result) == ERROR_JOB_MISMATCH);
+
+  // nor can a search of the same size over other candidates, or of
+  // another ems
+  slip39_passphrase_source other_mask = mask;
+  other_mask.mask = "?uREZA?u";
+  assert(slip39_job_run(ems, &other_mask, &other,
+    _verify_trezor_vector, NULL, NULL, &result) == ERROR_JOB_MISMATCH);
+  other.chunk_size = job.chunk_size;
+  assert(slip39_job_run(ems, &other_mask, &other,
+    _verify_trezor_vector, NULL, NULL, &result) == ERROR_JOB_MISMATCH);
+  uint8_t other_secret[16] = {0};
+  group_descriptor group = { 1, 1, NULL };
+  uint16_t other_words[33];
+  uint32_t other_count = 0;
+  assert(slip39_generate(1, &group, 1, other_secret, 16, "", 0, &other_count, other_words, 33, NULL, fake_random) == 1);
+  const uint16_t* other_mnemonics[] = { other_words };
+  slip39_ems* other_ems = NULL;
+  assert(slip39_recover_ems(other_mnemonics, other_count, 1, NULL, &other_ems) == 16);
+  assert(slip39_job_run(other_ems, &mask, &other,
+    _verify_trezor_vector, NULL, NULL, &result) == ERROR_JOB_MISMATCH);
+  slip39_ems_free(other_ems);
+
+  // a process needs a name, and one that reuses another's name still
+  // can't take over the chunk that one is part way through
+  other = job;
+  other.worker = NULL;
+  assert(slip39_job_run(ems, &mask, &other,
+    _verify_trezor_vector, NULL, NULL, &result) == ERROR_INVALID_WORKER);
+  other.worker = "";
+  assert(slip39_job_run(ems, &mask, &other,
+    _verify_trezor_vector, NULL, NULL, &result) == ERROR_INVALID_WORKER);
+  char namesake[1024];
+  snprintf(namesake, sizeof(namesake), "%s/checkpoint-namesake", directory);
+  other = job;
+  other.checkpoint = namesake;
+  other.last_chunk = 2;
+  assert(slip39_job_run(ems, &mask, &other,
+    _verify_trezor_vector, NULL, NULL, &result) == 0);
+  assert(result.tried == 0);
+
+  // resuming picks up from the last checkpoint, at 125, and takes back a
+  // claim the process made but was killed before recording
+  char claim[1024];
+  snprintf(claim, sizeof(claim), "%s/chunk-3.claim", directory);
+  FILE* file = fopen(claim, "w");
+  assert(file != NULL);
+  fputs("a\n", file);
+  fclose(file);
+  calls[0] = 0;
+  calls[1] = -1;
+  calls[2] = 0;
+  assert(slip39_job_run(ems, &mask, &job,
+    _verify_and_stop_after, calls, &options, &result) == 1);
+  assert(equal_strings(result.passphrase, "TREZOR"));
+  assert(calls[0] >= 512 - 125 && calls[0] < 512 - 125 + 16);
+  assert(result.tried >= calls[0]);
+
+  // once it has been found there is nothing left to claim
+  snprintf(checkpoint, sizeof(checkpoint), "%s/checkpoint-b", directory);
+  job.worker = "b";
+  assert(slip39_job_run(ems, &mask, &job,
+    _verify_trezor_vector, NULL, NULL, &result) == 0);
+  assert(result.tried == 0);
+
+  _remove_directory(directory);
+  slip39_ems_free(ems);
+}
+
+static void test_calibrate_exponent() {
+  // a measurement is all that depends on the machine
+  double ns = slip39_measure_iteration_ns();
+  assert(ns > 0);
+  assert(slip39_predict_latency_ms(0, 16, 0) > 0);
+  assert(slip39_calibrate_exponent(UINT32_MAX, 16, 0) >= 0);
+
+  // at 100ns an iteration, exponent 0 takes 4 rounds of 2500 iterations,
+  // a millisecond, and each step of the exponent doubles it
+  assert(slip39_predict_latency_ms(0, 16, 100) == 1);
+  assert(slip39_predict_latency_ms(0, 32, 100) == 1);
+  double previous = 0;
+  for(uint8_t e = 0; e <= MAX_ITERATION_EXPONENT; e++) {
+    double ms = slip39_predict_latency_ms(e, 16, 100);
+    assert(ms > previous);
+    previous = ms;
+  }
+
+  // the largest exponent within the target, whatever the measurement
+  for(uint32_t target = 1; target < 5000; target = target * 3 + 1) {
+    int exponent = slip39_calibrate_exponent(target, 16, ns);
+    if(exponent == ERROR_TARGET_TOO_LOW) {
+      assert(slip39_predict_latency_ms(0, 16, ns) > target);
+      continue;
+    }
+    assert(exponent >= 0 && exponent <= MAX_ITERATION_EXPONENT);
+    assert(slip39_predict_latency_ms(exponent, 16, ns) <= target);
+    assert(exponent == MAX_ITERATION_EXPONENT || slip39_predict_latency_ms(exponent + 1, 16, ns) > target);
+  }
+  assert(slip39_calibrate_exponent(8, 16, 100) == 3);
+  assert(slip39_calibrate_exponent(7, 16, 100) == 2);
+
+  assert(slip39_calibrate_exponent(0, 16, 100) == ERROR_TARGET_TOO_LOW);
+  assert(slip39_calibrate_exponent(100, 17, 100) == ERROR_INVALID_SECRET_LENGTH);
+  assert(slip39_calibrate_exponent(100, 34, 100) == ERROR_INVALID_SECRET_LENGTH);
+  assert(slip39_calibrate_exponent(100, 8, 100) == ERROR_SECRET_TOO_SHORT);
+  assert(slip39_predict_latency_ms(0, 66, 100) == ERROR_INVALID_SECRET_LENGTH);
+  assert(slip39_predict_latency_ms(0, 8, 100) == ERROR_SECRET_TOO_SHORT);
+  assert(slip39_predict_latency_ms(MAX_ITERATION_EXPONENT + 1, 16, 100) == ERROR_INVALID_ITERATION_EXPONENT);
+}
+
+typedef struct {
+  int calls;
+  uint8_t last_round;
+  uint64_t last_done;
+  uint64_t total;
+  int cancel_after;
+  uint8_t cancel;
+} _kdf_watch;
+
+static void _watch_kdf(uint8_t round, uint64_t done, uint64_t total, void* context) {
+  _kdf_watch* watch = (_kdf_watch*)context;
+  assert(round < ROUND_COUNT && done <= total);
+  assert(round > watch->last_round || done > watch->last_done || watch->calls == 0);
+  watch->calls++;
+  watch->last_round = round;
+  watch->last_done = done;
+  watch->total = total;
+  if(watch->calls == watch->cancel_after) {
+    watch->cancel = 1;
+  }
+}
+
+static void test_kdf_monitor() {
+  uint8_t secret[] = {0xbb, 0x54, 0xaa, 0xc4, 0xb8, 0x9d, 0xc8, 0x68, 0xba, 0x37, 0xd9, 0xcc, 0x21, 0xb2, 0xce, 0xce};
+  uint8_t expected[16];
+  uint8_t output[16];
+  _kdf_watch watch = {0};
+  slip39_kdf_monitor monitor = { 500, _watch_kdf, &watch, &watch.cancel };
+
+  slip39_encrypt(secret, 16, "TREZOR", 1, 7945, expected);
+  assert(slip39_encrypt_monitored(secret, 16, "TREZOR", 1, 7945, output, &monitor) == 0);
+  assert(equal_uint8_buffers(expected, 16, output, 16));
+  assert(watch.calls == ROUND_COUNT * 10);
+  assert(watch.last_round == ROUND_COUNT - 1 && watch.last_done == 5000 && watch.total == 5000);
+
+  uint8_t decrypted[16];
+  monitor.granularity = 0;
+  memset(&watch, 0, sizeof(watch));
+  assert(slip39_decrypt_monitored(expected, 16, "TREZOR", 1, 7945, decrypted, &monitor) == 0);
+  assert(equal_uint8_buffers(secret, 16, decrypted, 16));
+  assert(watch.calls == ROUND_COUNT);
+
+  // cancelling wipes the output, even at exponents too large to finish
+  uint8_t zero[16] = {0};
+  monitor.granularity = 1000;
+  memset(&watch, 0, sizeof(watch));
+  watch.cancel_after = 3;
+  assert(slip39_encrypt_monitored(secret, 16, "TREZOR", 25, 7945, output, &monitor) == ERROR_CANCELLED);
+  assert(equal_uint8_buffers(zero, 16, output, 16));
+  assert(watch.calls == 3 && watch.total == (uint64_t)BASE_ITERATION_COUNT << 25);
+
+  slip39_shard shard = {0};
+  shard.value_length = 16;
+  shard.iteration_exponent = 0;
+  memcpy(shard.value, secret, 16);
+  memset(&watch, 0, sizeof(watch));
+  watch.cancel_after = 5;
+  assert(encrypt_shard_monitored(&shard, "password", &monitor) == ERROR_CANCELLED);
+  assert(equal_uint8_buffers(zero, 16, shard.value, 16));
+
+  // generate and combine pass the monitor all the way down
+  group_descriptor groups[] = { { 2, 3, NULL } };
+  uint32_t words_in_each_share = 0;
+  uint16_t shares[1024];
+  memset(&watch, 0, sizeof(watch));
+  watch.cancel_after = 2;
+  assert(slip39_generate_monitored(1, groups, 1, secret, 16, "TREZOR", 0,
+    &words_in_each_share, shares, 1024, NULL, fake_random, &monitor) == ERROR_CANCELLED);
+  for(int i = 0; i < 1024; i++) {
+    assert(shares[i] == 0);
+  }
+
+  memset(&watch, 0, sizeof(watch));
+  assert(slip39_generate_monitored(1, groups, 1, secret, 16, "TREZOR", 0,
+    &words_in_each_share, shares, 1024, NULL, fake_random, &monitor) == 3);
+  assert(watch.calls > 0);
+
+  const uint16_t* selected[] = { shares, shares + 2 * words_in_each_share };
+  uint8_t combined[32];
+  memset(&watch, 0, sizeof(watch));
+  assert(slip39_combine_monitored(selected, words_in_each_share, 2, "TREZOR", NULL, combined, 32, &monitor) == 16);
+  assert(equal_uint8_buffers(secret, 16, combined, 16));
+  assert(watch.calls > 0);
+
+  memset(&watch, 0, sizeof(watch));
+  watch.cancel_after = 1;
+  assert(slip39_combine_monitored(selected, words_in_each_share, 2, "TREZOR", NULL, combined, 32, &monitor) == ERROR_CANCELLED);
+  assert(equal_uint8_buffers(zero, 16, combined, 16));
+}
+
+static void test_recover_ems() {
+  const char* shares[] = {
+    "shadow pistol academic always adequate wildlife fancy gross oasis cylinder mustang wrist rescue view short owner flip making coding armed",
+    "shadow pistol academic acid actress prayer class unknown daughter sweater depict flip twice unkind craft early superior advocate guest smoking"
+  };
+  uint16_t words[2][100];
+  uint32_t word_count = 0;
+  for(int i = 0; i < 2; i++) {
+    word_count = slip39_words_for_strings(shares[i], words[i], 100);
+  }
+  const uint16_t* mnemonics[] = { words[0], words[1] };
+
+  slip39_ems* ems = NULL;
+  assert(slip39_recover_ems(mnemonics, word_count, 2, NULL, &ems) == 16);
+  assert(ems != NULL);
+  assert(slip39_ems_length(ems) == 16);
+
+  uint8_t expected[32];
+  uint8_t secret[32];
+  assert(slip39_combine(mnemonics, word_count, 2, "TREZOR", NULL, expected, 32) == 16);
+  assert(slip39_ems_decrypt(ems, "TREZOR", secret, 32) == 16);
+  assert(equal_uint8_buffers(expected, 16, secret, 16));
+
+  // a different passphrase gives a different secret, not an error
+  assert(slip39_combine(mnemonics, word_count, 2, "", NULL, expected, 32) == 16);
+  assert(slip39_ems_decrypt(ems, "", secret, 32) == 16);
+  assert(equal_uint8_buffers(expected, 16, secret, 16));
+
+  assert(slip39_ems_decrypt(ems, "TREZOR", secret, 15) == ERROR_INSUFFICIENT_SPACE);
+
+  // the handle holds what slip39_decrypt needs
+  assert(slip39_ems_identifier(ems) == (words[0][0] << 5 | words[0][1] >> 5));
+  assert(slip39_ems_iteration_exponent(ems) == (words[0][1] & 31));
+  slip39_decrypt(slip39_ems_value(ems), 16, "TREZOR", slip39_ems_iteration_exponent(ems),
+    slip39_ems_identifier(ems), secret);
+  assert(slip39_combine(mnemonics, word_count, 2, "TREZOR", NULL, expected, 32) == 16);
+  assert(equal_uint8_buffers(expected, 16, secret, 16));
+  slip39_ems_free(ems);
+
+  // only one of the two shares needed
+  assert(slip39_recover_ems(mnemonics, word_count, 1, NULL, &ems) == ERROR_NOT_ENOUGH_MEMBER_SHARDS);
+  assert(ems == NULL);
+}
+
+static void test_generate_from_ems() {
+  uint8_t secret[] = {0xbb, 0x54, 0xaa, 0xc4, 0xb8, 0x9d, 0xc8, 0x68, 0xba, 0x37, 0xd9, 0xcc, 0x21, 0xb2, 0xce, 0xce};
+  group_descriptor original[] = { { 1, 1, NULL } };
+  uint32_t words_in_each_share = 0;
+  uint16_t shares[1024];
+  assert(slip39_generate(1, original, 1, secret, 16, "TREZOR", 1, &words_in_each_share, shares, 1024, NULL, fake_random) == 1);
+
+  const uint16_t* mnemonics[] = { shares };
+  slip39_ems* ems = NULL;
+  assert(slip39_recover_ems(mnemonics, words_in_each_share, 1, NULL, &ems) == 16);
+
+  // reissue as 2 of 3 groups, the first of them 2 of 3 members
+  group_descriptor groups[] = { { 2, 3, NULL }, { 1, 1, NULL }, { 1, 1, NULL } };
+  uint16_t reissued[1024];
+  uint32_t reissued_words = 0;
+  assert(slip39_generate_from_ems(2, groups, 3, ems, &reissued_words, reissued, 1024, NULL, fake_random) == 5);
+  assert(reissued_words == words_in_each_share);
+  assert(slip39_generate_from_ems(2, groups, 3, ems, &reissued_words, reissued, 10, NULL, fake_random) == ERROR_INSUFFICIENT_SPACE);
+  assert(slip39_generate_from_ems(2, groups, 3, ems, &reissued_words, reissued, 1024, NULL, fake_random) == 5);
+
+  const uint16_t* selected[] = {
+    reissued,
+    reissued + 2 * reissued_words,
+    reissued + 4 * reissued_words
+  };
+  uint8_t combined[32];
+  assert(slip39_combine(selected, reissued_words, 3, "TREZOR", NULL, combined, 32) == 16);
+  assert(equal_uint8_buffers(secret, 16, combined, 16));
+
+  // the new set is still tied to the original identifier and exponent
+  slip39_ems* again = NULL;
+  assert(slip39_recover_ems(selected, reissued_words, 3, NULL, &again) == 16);
+  assert(slip39_ems_identifier(again) == slip39_ems_identifier(ems));
+  assert(slip39_ems_iteration_exponent(again) == 1);
+
+  slip39_ems_free(again);
+  slip39_ems_free(ems);
+}
+
+static void test_rs1024_polymod() {
+  uint16_t words[40];
+  uint32_t state = 12345;
+  for(int n = 0; n < 40; n++) {
+    for(int trial = 0; trial < 50; trial++) {
+      for(int i = 0; i < n; i++) {
+        state = state * 1103515245 + 12345;
+        words[i] = (state >> 8) & 1023;
+      }
+      assert(rs1024_polymod(words, n) == rs1024_polymod_reference(words, n));
+    }
+  }
+}
+
+static void test_rs1024_many() {
+  // enough for a few full vector batches, a partial one, and more than
+  // one internal batch
+  uint32_t count = 150;
+  uint32_t words = 33;
+  uint16_t shares[count][words];
+  uint16_t expected[count][words];
+  uint16_t* pointers[count];
+  uint8_t ok[count];
+  uint32_t state = 777;
+
+  for(int i = 0; i < count; i++) {
+    for(int j = 0; j < words; j++) {
+      state = state * 1103515245 + 12345;
+      shares[i][j] = (state >> 8) & 1023;
+    }
+    memcpy(expected[i], shares[i], sizeof(shares[i]));
+    rs1024_create_checksum(expected[i], words);
+    pointers[i] = shares[i];
+  }
+
+  rs1024_create_checksum_many(pointers, count, words);
+  for(int i = 0; i < count; i++) {
+    assert(equal_uint16_buffers(expected[i], words, shares[i], words));
+  }
+
+  // break every third one
+  for(int i = 0; i < count; i += 3) {
+    shares[i][i % words] ^= 1 + i;
+  }
+  rs1024_verify_checksum_many((const uint16_t* const*)pointers, count, words, ok);
+  for(int i = 0; i < count; i++) {
+    assert(ok[i] == (i % 3 != 0));
+    assert(ok[i] == rs1024_verify_checksum(shares[i], words));
+  }
+}
+
+static void test_rs1024_state() {
+  const char* share = "duckling enlarge academic academic agency result length solution fridge kidney coal piece deal husband erode duke ajar critical decision keyboard";
+  uint16_t words[100];
+  uint32_t word_count = slip39_words_for_strings(share, words, 100);
+  rs1024_state state;
+  uint16_t checksum[3];
+
+  rs1024_state_init(&state);
+  for(int i = 0; i < word_count; i++) {
+    assert(rs1024_state_peek(&state) == rs1024_polymod(words, i));
+    if(i == word_count - 3) {
+      rs1024_state_expected_checksum(&state, checksum);
+      assert(equal_uint16_buffers(checksum, 3, words + word_count - 3, 3));
+    }
+    assert(!rs1024_state_finalize(&state));
+    rs1024_state_feed_word(&state, words[i]);
+  }
+  assert(state.count == word_count);
+  assert(rs1024_state_finalize(&state));
+
+  // a mistyped word anywhere shows up at the end
+  rs1024_state_init(&state);
+  for(int i = 0; i < word_count; i++) {
+    rs1024_state_feed_word(&state, i == 5 ? words[i] ^ 1 : words[i]);
+  }
+  assert(!rs1024_state_finalize(&state));
+}
+
+static void test_rs1024_fill_erasures() {
+  const char* share = "shadow pistol academic always adequate wildlife fancy gross oasis cylinder mustang wrist rescue view short owner flip making coding armed";
+  uint16_t original[100];
+  uint16_t words[100];
+  uint32_t n = slip39_words_for_strings(share, original, 100);
+
+  uint32_t positions[][3] = {
+    {0, 0, 0}, {7, 0, 0}, {19, 0, 0},
+    {0, 1, 0}, {3, 12, 0}, {18, 19, 0},
+    {0, 1, 2}, {4, 10, 17}, {17, 18, 19}, {19, 0, 9}
+  };
+  uint32_t counts[] = {1, 1, 1, 2, 2, 2, 3, 3, 3, 3};
+
+  for(int t = 0; t < 10; t++) {
+    memcpy(words, original, sizeof(uint16_t) * n);
+    for(int i = 0; i < counts[t]; i++) {
+      words[positions[t][i]] = 1023 - words[positions[t][i]];
+    }
+    assert(rs1024_fill_erasures(words, n, positions[t], counts[t]) == 1);
+    assert(equal_uint16_buffers(original, n, words, n));
+  }
+
+  // with fewer than three missing, a wrong word elsewhere is noticed
+  memcpy(words, original, sizeof(uint16_t) * n);
+  words[5] ^= 7;
+  uint32_t two[] = {8, 9};
+  assert(rs1024_fill_erasures(words, n, two, 2) == 0);
+
+  uint32_t four[] = {1, 2, 3, 4};
+  assert(rs1024_fill_erasures(words, n, four, 4) == ERROR_AMBIGUOUS_ERASURES);
+  uint32_t repeated[] = {1, 1};
+  assert(rs1024_fill_erasures(words, n, repeated, 2) == ERROR_INVALID_ERASURE);
+  uint32_t outside[] = {n};
+  assert(rs1024_fill_erasures(words, n, outside, 1) == ERROR_INVALID_ERASURE);
+}
+
+static void test_rs1024_locate_errors() {
+  const char* share = "shadow pistol academic always adequate wildlife fancy gross oasis cylinder mustang wrist rescue view short owner flip making coding armed";
+  uint16_t original[100];
+  uint16_t words[100];
+  uint32_t n = slip39_words_for_strings(share, original, 100);
+  rs1024_correction corrections[64];
+
+  assert(rs1024_locate_errors(original, n, corrections, 64) == 0);
+
+  // every single substitution is found, and the real one ranks first when
+  // it is a near miss in spelling ("group" for "gross")
+  for(uint32_t p = 0; p < n; p++) {
+    memcpy(words, original, sizeof(uint16_t) * n);
+    words[p] ^= 1 + (p * 37) % 1023;
+    uint32_t found = rs1024_locate_errors(words, n, corrections, 64);
+    assert(found > 0 && found <= 64);
+    uint32_t i;
+    for(i = 0; i < found; i++) {
+      if(corrections[i].kind == RS1024_SUBSTITUTION && corrections[i].position == p) break;
+    }
+    assert(i < found && corrections[i].word == original[p]);
+  }
+
+  memcpy(words, original, sizeof(uint16_t) * n);
+  words[7] = slip39_word_for_string("group");
+  uint32_t found = rs1024_locate_errors(words, n, corrections, 64);
+  slip39_rank_corrections(words, corrections, found);
+  assert(corrections[0].kind == RS1024_SUBSTITUTION);
+  assert(corrections[0].position == 7 && corrections[0].word == original[7]);
+  for(uint32_t i = 1; i < found; i++) {
+    assert(corrections[i-1].distance <= corrections[i].distance);
+  }
+
+  // swapping neighbours is found as a transposition
+  for(uint32_t p = 0; p + 1 < n; p++) {
+    if(original[p] == original[p+1]) continue;
+    memcpy(words, original, sizeof(uint16_t) * n);
+    words[p] = original[p+1];
+    words[p+1] = original[p];
+    found = rs1024_locate_errors(words, n, corrections, 64);
+    uint32_t i;
+    for(i = 0; i < found; i++) {
+      if(corrections[i].kind == RS1024_TRANSPOSITION && corrections[i].position == p) break;
+    }
+    assert(i < found);
+  }
+
+  assert(slip39_word_distance(slip39_word_for_string("gross"), slip39_word_for_string("gross")) == 0);
+  assert(slip39_word_distance(slip39_word_for_string("gross"), slip39_word_for_string("grocery")) == 4);
+  assert(slip39_word_distance(slip39_word_for_string("cover"), slip39_word_for_string("cylinder")) == 5);
+  assert(slip39_word_distance(slip39_word_for_string("husband"), slip39_word_for_string("hunting")) == 4);
+  assert(slip39_word_distance(0, 1024) == UINT32_MAX);
+}
+
+static void test_container() {
+  uint8_t secret[] = {0xbb, 0x54, 0xaa, 0xc4, 0xb8, 0x9d, 0xc8, 0x68, 0xba, 0x37, 0xd9, 0xcc, 0x21, 0xb2, 0xce, 0xce};
+  group_descriptor groups[] = { { 2, 3, NULL }, { 3, 5, NULL } };
+  uint32_t words_in_each_share = 0;
+  uint16_t shares[1024];
+  int count = slip39_generate(2, groups, 2, secret, 16, "", 0, &words_in_each_share, shares, 1024, NULL, fake_random);
+  assert(count == 8);
+
+  char directory[] = "/tmp/slip39-container-XXXXXX";
+  assert(mkdtemp(directory) != NULL);
+  char path[1024], text[1024], copy[1024];
+  snprintf(path, sizeof(path), "%s/shares", directory);
+  snprintf(text, sizeof(text), "%s/shares.txt", directory);
+  snprintf(copy, sizeof(copy), "%s/copy", directory);
+
+  // written backwards so that the index has some sorting to do
+  const uint16_t* written[8];
+  uint32_t lengths[8];
+  for(int i = 0; i < count; i++) {
+    written[i] = shares + (count - 1 - i) * words_in_each_share;
+    lengths[i] = words_in_each_share;
+  }
+  assert(slip39_container_write(path, written, lengths, count) == count);
+  // the header, records of a length and 25 packed bytes, and the index
+  FILE* file = fopen(path, "rb");
+  fseek(file, 0, SEEK_END);
+  assert(ftell(file) == 32 + 8 * (2 + 25) + 8 * 8);
+  fclose(file);
+
+  slip39_container* container;
+  assert(slip39_container_open(path, &container) == 0);
+  assert(slip39_container_count(container) == 8);
+  uint16_t words[33];
+  uint8_t packed[42];
+  for(int i = 0; i < count; i++) {
+    uint32_t length;
+    const uint8_t* share = slip39_container_share(container, i, &length);
+    assert(length == words_in_each_share);
+    assert(slip39_pack_words(written[i], length, packed, sizeof(packed)) == (int32_t) slip39_packed_size_for_words(length));
+    assert(memcmp(share, packed, slip39_packed_size_for_words(length)) == 0);
+    assert(slip39_container_words(container, i, words, 33) == (int32_t) length);
+    assert(memcmp(words, written[i], sizeof(uint16_t) * length) == 0);
+  }
+  uint32_t length;
+  assert(slip39_container_share(container, 8, &length) == NULL);
+  assert(slip39_container_words(container, 8, words, 33) == ERROR_INVALID_CONTAINER);
+  assert(slip39_container_words(container, 0, words, 10) == ERROR_INSUFFICIENT_SPACE);
+
+  // two shares of the first group and three of the second, found in the
+  // index and combined where they lie in the file
+  uint16_t identifier = shares[0] << 5 | shares[1] >> 5;
+  uint32_t records[8];
+  assert(slip39_container_find(container, identifier, -1, records, 8) == 8);
+  assert(slip39_container_find(container, identifier, 0, records, 8) == 3);
+  assert(slip39_container_find(container, identifier, 1, records + 2, 6) == 5);
+  assert(slip39_container_find(container, identifier ^ 1, -1, records, 8) == 0);
+  const uint8_t* views[5];
+  for(int i = 0; i < 5; i++) {
+    views[i] = slip39_container_share(container, records[i], &length);
+  }
+  uint8_t recovered[32];
+  assert(slip39_combine_packed(views, words_in_each_share, 5, "", NULL, recovered, 32) == 16);
+  assert(memcmp(recovered, secret, 16) == 0);
+  slip39_container_close(container);
+
+  // through text and back
+  assert(slip39_container_to_text(path, text) == 8);
+  assert(slip39_container_from_text(text, copy) == 8);
+  assert(slip39_container_open(copy, &container) == 0);
+  for(int i = 0; i < count; i++) {
+    assert(slip39_container_words(container, i, words, 33) == (int32_t) words_in_each_share);
+    assert(memcmp(words, written[i], sizeof(uint16_t) * words_in_each_share) == 0);
+  }
+  slip39_container_close(container);
+
+  // damage
+  file = fopen(copy, "r+b");
+  fseek(file, 24, SEEK_SET);
+  fputc(0xff, file);
+  fclose(file);
+  assert(slip39_container_open(copy, &container) == ERROR_INVALID_CONTAINER && container == NULL);
+  assert(truncate(copy, 16) == 0);
+  assert(slip39_container_open(copy, &container) == ERROR_INVALID_CONTAINER);
+  assert(slip39_container_open(directory, &container) == ERROR_CONTAINER_IO ||
+         slip39_container_open(directory, &container) == ERROR_INVALID_CONTAINER);
+  file = fopen(text, "w");
+  fputs("shadow pistol academic\n", file);
+  fclose(file);
+  assert(slip39_container_from_text(text, copy) == ERROR_NOT_ENOUGH_MNEMONIC_WORDS);
+  uint16_t wide[20] = { 1024 };
+  const uint16_t* bad = wide;
+  uint32_t bad_length = 20;
+  assert(slip39_container_write(copy, &bad, &bad_length, 1) == ERROR_INVALID_WORD);
+  uint16_t longer[34] = { 0 };
+  bad = longer;
+  bad_length = 34;
+  assert(slip39_container_write(copy, &bad, &bad_length, 1) == ERROR_TOO_MANY_WORDS);
+
+  unlink(path);
+  unlink(text);
+  unlink(copy);
+  rmdir(directory);
+}
+
+// random bytes that start from a seed, so that each split gets its own
+// identifier
+static void seeded_random(uint8_t *buf, size_t count, void* ctx) {
+  uint8_t b = *(uint8_t*)ctx;
+  for(size_t i = 0; i < count; i++) {
+    buf[i] = b;
+    b = b * 5 + 17;
+  }
+}
+
+static void test_pool() {
+  uint8_t secret_a[16], secret_d[16], other_d[16];
+  for(int i = 0; i < 16; i++) {
+    secret_a[i] = i;
+    secret_d[i] = 0x80 + i;
+    other_d[i] = 0x40 + i;
+  }
+  uint16_t a[8][33], b[3][33], c[4][33], d[3][33], d2[3][33];
+  uint32_t n = 0;
+  uint8_t seed;
+  group_descriptor two_groups[] = { { 2, 3, NULL }, { 3, 5, NULL } };
+  group_descriptor one_group[] = { { 2, 3, NULL } };
+  group_descriptor first_of_two[] = { { 1, 1, NULL }, { 2, 3, NULL } };
+
+  // a: everything; b: one share of a 2 of 3; c: only the second of two
+  // groups that are both needed; d: recoverable, but shares from another
+  // split with the same identifier got mixed in
+  seed = 1;
+  assert(slip39_generate(2, two_groups, 2, secret_a, 16, "", 0, &n, a[0], 8 * 33, &seed, seeded_random) == 8);
+  assert(n == 20);
+  for(int i = 7; i > 0; i--) memmove(a[i], a[0] + i * n, sizeof(uint16_t) * n);
+  seed = 2;
+  assert(slip39_generate(1, one_group, 1, secret_a, 16, "", 0, &n, b[0], 3 * 33, &seed, seeded_random) == 3);
+  for(int i = 2; i > 0; i--) memmove(b[i], b[0] + i * n, sizeof(uint16_t) * n);
+  seed = 3;
+  assert(slip39_generate(2, first_of_two, 2, secret_a, 16, "", 0, &n, c[0], 4 * 33, &seed, seeded_random) == 4);
+  for(int i = 3; i > 0; i--) memmove(c[i], c[0] + i * n, sizeof(uint16_t) * n);
+  seed = 4;
+  assert(slip39_generate(1, one_group, 1, secret_d, 16, "", 0, &n, d[0], 3 * 33, &seed, seeded_random) == 3);
+  for(int i = 2; i > 0; i--) memmove(d[i], d[0] + i * n, sizeof(uint16_t) * n);
+  seed = 4;
+  assert(slip39_generate(1, one_group, 1, other_d, 16, "", 0, &n, d2[0], 3 * 33, &seed, seeded_random) == 3);
+
+  slip39_pool* pool;
+  assert(slip39_pool_new(0, &pool) == 0);
+  assert(slip39_pool_add(pool, a[3], n) == 0);
+  assert(slip39_pool_add(pool, b[0], n) == 1);
+  assert(slip39_pool_add(pool, c[1], n) == 2);
+  assert(slip39_pool_add(pool, d[2], n) == 3);
+  for(int i = 0; i < 8; i++) assert(slip39_pool_add(pool, a[i], n) == 0);
+  for(int i = 1; i < 4; i++) assert(slip39_pool_add(pool, c[i], n) == 2);
+  assert(slip39_pool_add(pool, d[0], n) == 3);
+  assert(slip39_pool_add(pool, d2[0], n) == 3);
+  assert(slip39_pool_bucket_count(pool) == 4);
+
+  uint16_t broken[33];
+  memcpy(broken, a[0], sizeof(broken));
+  broken[5] ^= 1;
+  assert(slip39_pool_add(pool, broken, n) == ERROR_INVALID_MNEMONIC_CHECKSUM);
+  assert(slip39_pool_add(pool, a[0], 10) == ERROR_NOT_ENOUGH_MNEMONIC_WORDS);
+
+  slip39_pool_result results[4], serial[4];
+  assert(slip39_pool_combine(pool, "", 0, results, 4) == 4);
+  assert(results[0].identifier == (a[0][0] << 5 | a[0][1] >> 5));
+  assert(results[0].iteration_exponent == 0 && results[0].group_count == 2);
+  assert(results[0].shares == 9);
+  assert(results[0].status == 16 && memcmp(results[0].secret, secret_a, 16) == 0);
+  assert(results[1].status == ERROR_NOT_ENOUGH_MEMBER_SHARDS);
+  assert(results[2].status == ERROR_NOT_ENOUGH_GROUPS);
+  assert(results[3].status == ERROR_DUPLICATE_MEMBER_INDEX && results[3].shares == 3);
+  assert(results[0].identifier != results[1].identifier);
+
+  assert(slip39_pool_combine(pool, "", 1, serial, 4) == 4);
+  assert(memcmp(results, serial, sizeof(results)) == 0);
+  assert(slip39_pool_combine(pool, "", 0, serial, 1) == 4);
+  assert(serial[0].status == 16);
+  slip39_pool_free(pool);
+
+  // the same from packed shares, without the stray share of d
+  assert(slip39_pool_new(16, &pool) == 0);
+  uint8_t packed[33 * 10 / 8 + 1];
+  for(int i = 0; i < 3; i++) {
+    assert(slip39_pack_words(d[i], n, packed, sizeof(packed)) == (int32_t) slip39_packed_size_for_words(n));
+    assert(slip39_pool_add_packed(pool, packed, n) == 0);
+  }
+  assert(slip39_pack_words(b[2], n, packed, sizeof(packed)) == (int32_t) slip39_packed_size_for_words(n));
+  assert(slip39_pool_add_packed(pool, packed, n) == 1);
+  assert(slip39_pool_combine(pool, "", 0, results, 4) == 2);
+  assert(results[0].status == 16 && memcmp(results[0].secret, secret_d, 16) == 0);
+  assert(results[1].status == ERROR_NOT_ENOUGH_MEMBER_SHARDS);
+  slip39_pool_free(pool);
+
+  // enough splits to make the index grow
+  assert(slip39_pool_new(0, &pool) == 0);
+  for(int i = 0; i < 100; i++) {
+    seed = 10 + i;
+    uint16_t shares[33];
+    assert(slip39_generate(1, (group_descriptor[]) { { 1, 1, NULL } }, 1, secret_a, 16, "", 0, &n, shares, 33, &seed, seeded_random) == 1);
+    assert(slip39_pool_add(pool, shares, n) >= 0);
+  }
+  uint32_t buckets = slip39_pool_bucket_count(pool);
+  assert(buckets == 100);
+  slip39_pool_result* many = malloc(sizeof(slip39_pool_result) * buckets);
+  assert(slip39_pool_combine(pool, "", 0, many, buckets) == buckets);
+  for(uint32_t i = 0; i < buckets; i++) {
+    assert(many[i].status == 16 && memcmp(many[i].secret, secret_a, 16) == 0);
+  }
+  free(many);
+  slip39_pool_free(pool);
+}
+
+static void test_combiner() {
+  uint8_t secret[16], other[16];
+  for(int i = 0; i < 16; i++) {
+    secret[i] = 0x20 + i;
+    other[i] = 0x60 + i;
+  }
+  group_descriptor groups[] = { { 2, 3, NULL }, { 3, 5, NULL }, { 1, 1, NULL } };
+  uint16_t shares[9 * 33], conflicting[9 * 33], stranger[9 * 33];
+  uint32_t n = 0;
+  uint8_t seed = 7;
+  assert(slip39_generate(2, groups, 3, secret, 16, "TREZOR", 0, &n, shares, 9 * 33, &seed, seeded_random) == 9);
+  seed = 7;
+  assert(slip39_generate(2, groups, 3, other, 16, "TREZOR", 0, &n, conflicting, 9 * 33, &seed, seeded_random) == 9);
+  seed = 8;
+  assert(slip39_generate(2, groups, 3, secret, 16, "TREZOR", 0, &n, stranger, 9 * 33, &seed, seeded_random) == 9);
+  // shares 0-2 are the first group, 3-7 the second, 8 the third
+
+  slip39_combiner* combiner;
+  assert(slip39_combiner_new(&combiner) == 0);
+  slip39_combiner_status status;
+  slip39_combiner_report(combiner, &status);
+  assert(status.group_threshold == 0 && status.groups_needed == 0);
+  uint8_t recovered[32];
+  assert(slip39_combiner_secret(combiner, "TREZOR", recovered, 32) == ERROR_NOT_ENOUGH_GROUPS);
+
+  assert(slip39_combiner_add(combiner, shares + 4 * n, n, NULL) == 0);
+  slip39_combiner_report(combiner, &status);
+  assert(status.identifier == (shares[0] << 5 | shares[1] >> 5));
+  assert(status.group_threshold == 2 && status.group_count == 3);
+  assert(status.groups_complete == 0 && status.groups_needed == 2);
+  assert(status.groups[1].member_threshold == 3 && status.groups[1].member_count == 1);
+  assert(status.groups[1].members_needed == 2 && status.groups[1].members == 1 << 1);
+  assert(status.groups[0].member_threshold == 0 && status.groups[0].members_needed == 0);
+
+  // the same share again changes nothing, others are turned away
+  assert(slip39_combiner_add(combiner, shares + 4 * n, n, NULL) == 0);
+  assert(slip39_combiner_add(combiner, conflicting + 4 * n, n, NULL) == ERROR_DUPLICATE_MEMBER_INDEX);
+  assert(slip39_combiner_add(combiner, stranger, n, NULL) == ERROR_INVALID_SHARD_SET);
+  uint16_t broken[33];
+  memcpy(broken, shares, sizeof(uint16_t) * n);
+  broken[6] ^= 1;
+  assert(slip39_combiner_add(combiner, broken, n, NULL) == ERROR_INVALID_MNEMONIC_CHECKSUM);
+  slip39_combiner_report(combiner, &status);
+  assert(status.groups[1].member_count == 1 && status.groups[0].member_count == 0);
+
+  // the third group has a threshold of one, so it is complete at once
+  assert(slip39_combiner_add(combiner, shares + 8 * n, n, NULL) == 0);
+  slip39_combiner_report(combiner, &status);
+  assert(status.groups_complete == 1 && status.groups_needed == 1);
+  assert(status.groups[2].complete == 1 && status.groups[2].members_needed == 0);
+
+  assert(slip39_combiner_add(combiner, shares + 6 * n, n, NULL) == 0);
+  assert(slip39_combiner_add(combiner, shares + 1 * n, n, NULL) == 0);
+  slip39_combiner_report(combiner, &status);
+  assert(status.groups[1].members_needed == 1 && status.groups[0].members_needed == 1);
+  assert(slip39_combiner_add(combiner, shares + 3 * n, n, NULL) == 1);
+  slip39_combiner_report(combiner, &status);
+  assert(status.groups_complete == 2 && status.groups_needed == 0);
+  assert(status.groups[1].complete == 1 && status.groups[0].complete == 0);
+
+  assert(slip39_combiner_secret(combiner, "TREZOR", recovered, 15) == ERROR_INSUFFICIENT_SPACE);
+  assert(slip39_combiner_secret(combiner, "TREZOR", recovered, 32) == 16);
+  assert(memcmp(recovered, secret, 16) == 0);
+
+  // more shares can still come, and still have to agree
+  assert(slip39_combiner_add(combiner, shares + 0 * n, n, NULL) == 1);
+  assert(slip39_combiner_add(combiner, conflicting + 1 * n, n, NULL) == ERROR_DUPLICATE_MEMBER_INDEX);
+  assert(slip39_combiner_secret(combiner, "TREZOR", recovered, 32) == 16);
+  assert(memcmp(recovered, secret, 16) == 0);
+  slip39_combiner_free(combiner);
+
+  // a share read with the wrong password only shows up once its group is
+  // complete, and the share that completes it is kept rather than blamed
+  assert(slip39_combiner_new(&combiner) == 0);
+  assert(slip39_combiner_add(combiner, shares + 0 * n, n, "wrong") == 0);
+  assert(slip39_combiner_add(combiner, shares + 1 * n, n, NULL) == ERROR_INCONSISTENT_GROUP);
+  slip39_combiner_report(combiner, &status);
+  assert(status.groups[0].error == ERROR_INCONSISTENT_GROUP);
+  assert(status.groups[0].member_count == 2 && status.groups[0].complete == 0);
+  assert(slip39_combiner_add(combiner, shares + 2 * n, n, NULL) == 0);
+  assert(slip39_combiner_remove(combiner, 0, 5) == ERROR_INVALID_SHARD_SET);
+  assert(slip39_combiner_remove(combiner, 0, 0) == 0);
+  slip39_combiner_report(combiner, &status);
+  assert(status.groups[0].error == 0 && status.groups[0].complete == 1);
+  assert(status.groups[0].members == (1 << 1 | 1 << 2));
+
+  // a bad share in a group of one is caught by the master secret instead
+  assert(slip39_combiner_add(combiner, shares + 8 * n, n, "wrong") == ERROR_INCONSISTENT_GROUP);
+  slip39_combiner_report(combiner, &status);
+  assert(status.error == ERROR_INCONSISTENT_GROUP && status.groups_needed == 0);
+  assert(slip39_combiner_secret(combiner, "TREZOR", recovered, 32) == ERROR_NOT_ENOUGH_GROUPS);
+  assert(slip39_combiner_remove(combiner, 2, 0) == 0);
+  slip39_combiner_report(combiner, &status);
+  assert(status.error == 0 && status.groups_complete == 1);
+  assert(slip39_combiner_add(combiner, shares + 8 * n, n, NULL) == 1);
+  assert(slip39_combiner_secret(combiner, "TREZOR", recovered, 32) == 16);
+  assert(memcmp(recovered, secret, 16) == 0);
+  slip39_combiner_free(combiner);
+}
+
+// the Fiestel network has to come out bit-identical whichever
+// compression backend is doing the work
+static void test_sha256_backends() {
+  for(uint32_t i = 0; i < slip39_sha256_backend_count(); i++) {
+    const slip39_sha256_backend* backend = slip39_sha256_backend_at(i);
+    if(!slip39_sha256_backend_select(backend)) {
+      printf("skipping unsupported sha256 backend: %s\n", backend->name);
+      continue;
+    }
+    assert(slip39_sha256_backend_current() == backend);
+    test_round_function();
+    test_kdf_context();
+    test_combine();
+  }
+  slip39_sha256_backend_select(NULL);
+}
+
 int main() {
   test_string_for_word();
   test_word_for_string();
+  test_words_with_prefix();
+  test_nearest_words();
   test_counts();
   test_words();
+  test_words_data_kernels();
+  test_packed();
   test_strings();
+  test_format_shares();
+  test_share_parser();
+  test_container();
+  test_pool();
+  test_combiner();
+  test_rs1024_polymod();
+  test_rs1024_many();
+  test_rs1024_state();
+  test_rs1024_fill_erasures();
+  test_rs1024_locate_errors();
+  test_round_function();
+  test_kdf_context();
+  test_crypt_many();
+  test_iterate_many_counts();
   test_generate_and_combine();
   test_combine();
+  test_search_passphrase();
+  test_search_job();
+  test_calibrate_exponent();
+  test_kdf_monitor();
+  test_recover_ems();
+  test_generate_from_ems();
+  test_sha256_backends();
 }
@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+#
+#  gen-word-hash.py
+#
+#  Copyright © 2020 by Blockchain Commons, LLC
+#  Licensed under the "BSD-2-Clause Plus Patent License"
+#
+#  Generates src/wordlist-english-hash.h, the minimal perfect hash used by
+#  slip39_word_for_string, the word lengths used by slip39_format_words,
+#  the prefix ranges used by slip39_words_with_prefix and the BK-tree used
+#  by slip39_nearest_words, from the words in src/wordlist-english.h.
+#
+#  Every word is keyed on its first four letters packed little-endian into
+#  a 32 bit integer. The key picks a bucket and a starting slot by two
+#  multiplicative hashes, and each bucket has a displacement that is xored
+#  with the starting slot so that the 1024 words land in 1024 different
+#  slots (hash and displace).
+#
+#  usage: tools/gen-word-hash.py > src/wordlist-english-hash.h
+#
+
+import os
+import re
+import sys
+
+BUCKET_BITS = 9
+SLOT_BITS = 10
+MASK32 = 0xFFFFFFFF
+
+here = os.path.dirname(os.path.abspath(__file__))
+source = open(os.path.join(here, '..', 'src', 'wordlist-english.h')).read()
+words = re.findall(r'"([a-z]+)"', source)
+assert len(words) == 1 << SLOT_BITS
+assert max(len(w) for w in words) <= 8
+
+
+def key(word):
+    prefix = word[:4].encode().ljust(4, b'\0')
+    return int.from_bytes(prefix, 'little')
+
+
+def bucket(k, m1):
+    return ((k * m1) & MASK32) >> (32 - BUCKET_BITS)
+
+
+def start(k, m2):
+    return ((k * m2) & MASK32) >> (32 - SLOT_BITS)
+
+
+def build(m1, m2):
+    buckets = [[] for _ in range(1 << BUCKET_BITS)]
+    for index, word in enumerate(words):
+        k = key(word)
+        buckets[bucket(k, m1)].append((start(k, m2), index))
+
+    slots = [None] * (1 << SLOT_BITS)
+    displacement = [0] * (1 << BUCKET_BITS)
+    for b in sorted(range(len(buckets)), key=lambda b: -len(buckets[b])):
+        entries = buckets[b]
+        if not entries:
+            continue
+        for d in range(1 << SLOT_BITS):
+            targets = [s ^ d for s, _ in entries]
+            if len(set(targets)) == len(targets) and all(slots[t] is None for t in targets):
+                break
+        else:
+            return None
+        displacement[b] = d
+        for t, (_, index) in zip(targets, entries):
+            slots[t] = index
+    return displacement, slots
+
+
+def search():
+    state = 0x9E3779B9
+    for _ in range(10000):
+        # xorshift, odd multipliers only
+        state ^= (state << 13) & MASK32
+        state ^= state >> 17
+        state ^= (state << 5) & MASK32
+        m1 = state | 1
+        state ^= (state << 13) & MASK32
+        state ^= state >> 17
+        state ^= (state << 5) & MASK32
+        m2 = state | 1
+        result = build(m1, m2)
+        if result:
+            return m1, m2, result
+    sys.exit('no perfect hash found')
+
+
+def prefix_starts():
+    # index of the first word at or after each two letter prefix, in order
+    starts = []
+    for i in range(26 * 26 + 1):
+        prefix = chr(ord('a') + i // 26) + chr(ord('a') + i % 26) if i < 26 * 26 else '{'
+        starts.append(sum(1 for w in words if w[:2] < prefix))
+    return starts
+
+
+def distance(a, b):
+    # Damerau-Levenshtein distance, the same algorithm as
+    # slip39_string_distance so that the tree agrees with the lookup
+    infinity = len(a) + len(b)
+    last = {}
+    d = [[0] * (len(b) + 2) for _ in range(len(a) + 2)]
+    d[0][0] = infinity
+    for i in range(len(a) + 1):
+        d[i + 1][0] = infinity
+        d[i + 1][1] = i
+    for j in range(len(b) + 1):
+        d[0][j + 1] = infinity
+        d[1][j + 1] = j
+    for i in range(1, len(a) + 1):
+        match = 0
+        for j in range(1, len(b) + 1):
+            k = last.get(b[j - 1], 0)
+            l = match
+            cost = 0 if a[i - 1] == b[j - 1] else 1
+            if cost == 0:
+                match = j
+            d[i + 1][j + 1] = min(d[i][j] + cost, d[i + 1][j] + 1, d[i][j + 1] + 1,
+                                  d[k][l] + (i - k - 1) + 1 + (j - l - 1))
+        last[a[i - 1]] = i
+    return d[len(a) + 1][len(b) + 1]
+
+
+def bktree():
+    # build the tree by inserting the words in order, then lay it out
+    # breadth first so that the children of every node are consecutive
+    children = [dict() for _ in words]
+    for index in range(1, len(words)):
+        node = 0
+        while True:
+            d = distance(words[index], words[node])
+            if d not in children[node]:
+                children[node][d] = index
+                break
+            node = children[node][d]
+
+    order = [0]
+    first_child = []
+    for node in order:
+        first_child.append(len(order))
+        order.extend(children[node][d] for d in sorted(children[node]))
+    first_child.append(len(order))
+
+    parent_distance = [0] * len(words)
+    for node in range(len(words)):
+        for d, child in children[node].items():
+            parent_distance[child] = d
+    return order, [parent_distance[w] for w in order], first_child
+
+
+def rows(values, per_line, fmt, width=0):
+    for i in range(0, len(values), per_line):
+        line = ' '.join((fmt(v) + ',').ljust(width) for v in values[i:i + per_line])
+        yield '    ' + line.rstrip()
+
+
+m1, m2, (displacement, slots) = search()
+
+out = []
+out.append('''//
+//  wordlist-english-hash.h
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+//  Generated by tools/gen-word-hash.py, do not edit.
+//
+
+#ifndef WORDLIST_ENGLISH_HASH_H
+#define WORDLIST_ENGLISH_HASH_H
+
+#include <stdint.h>
+''')
+out.append('#define WORDLIST_HASH_BUCKET_MULTIPLIER 0x%08Xu' % m1)
+out.append('#define WORDLIST_HASH_SLOT_MULTIPLIER 0x%08Xu' % m2)
+out.append('#define WORDLIST_HASH_BUCKET_BITS %d' % BUCKET_BITS)
+out.append('#define WORDLIST_HASH_SLOT_BITS %d' % SLOT_BITS)
+out.append('')
+out.append('// xored with the starting slot of every word in the bucket')
+out.append('static const uint16_t wordlist_hash_displacement[%d] = {' % len(displacement))
+out.extend(rows(displacement, 12, lambda v: '%4d' % v))
+out.append('};')
+out.append('')
+out.append('// the word index stored in each slot')
+out.append('static const uint16_t wordlist_hash_slots[%d] = {' % len(slots))
+out.extend(rows(slots, 12, lambda v: '%4d' % v))
+out.append('};')
+out.append('')
+out.append('// every word zero padded to 8 bytes, by word index')
+out.append('static const char wordlist_packed[%d][8] = {' % len(words))
+out.extend(rows(words, 8, lambda w: '"%s"' % w, 11))
+out.append('};')
+out.append('')
+out.append('// the length of every word, by word index')
+out.append('static const uint8_t wordlist_length[%d] = {' % len(words))
+out.extend(rows([len(w) for w in words], 16, lambda v: '%d' % v))
+out.append('};')
+out.append('')
+out.append('// the words starting with the two letters xy are those from')
+out.append('// wordlist_prefix_start[(x-\'a\')*26 + (y-\'a\')] up to the next entry')
+starts = prefix_starts()
+out.append('static const uint16_t wordlist_prefix_start[%d] = {' % len(starts))
+out.extend(rows(starts, 13, lambda v: '%4d' % v))
+out.append('};')
+out.append('')
+out.append('// a BK-tree over the words by Damerau-Levenshtein distance, laid out')
+out.append('// breadth first: node i holds word wordlist_bktree_word[i], is at')
+out.append('// wordlist_bktree_distance[i] from its parent, and its children are the')
+out.append('// nodes from wordlist_bktree_first_child[i] up to the next entry')
+tree_words, tree_distances, tree_children = bktree()
+out.append('static const uint16_t wordlist_bktree_word[%d] = {' % len(tree_words))
+out.extend(rows(tree_words, 12, lambda v: '%4d' % v))
+out.append('};')
+out.append('')
+out.append('static const uint8_t wordlist_bktree_distance[%d] = {' % len(tree_distances))
+out.extend(rows(tree_distances, 16, lambda v: '%d' % v))
+out.append('};')
+out.append('')
+out.append('static const uint16_t wordlist_bktree_first_child[%d] = {' % len(tree_children))
+out.extend(rows(tree_children, 12, lambda v: '%4d' % v))
+out.append('};')
+out.append('')
+out.append('#endif /* WORDLIST_ENGLISH_HASH_H */')
+print('\n'.join(out))